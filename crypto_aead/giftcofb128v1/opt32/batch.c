@@ -0,0 +1,244 @@
+/*******************************************************************************
+* Batched GIFT-COFB over independent messages of any keys and lengths.
+*
+* A batch is processed in three steps, with no allocation: all the working
+* memory is taken from an arena supplied by the caller.
+*   1. the jobs are grouped by key: each key is compared in constant time to
+*      the distinct keys found so far as long as there are at most
+*      SCAN_KEYS of them. Beyond that, as this search would cost up to
+*      n^2 / 2 comparisons for n jobs, copies of the keys are sorted by a
+*      sorting network, i.e. a sequence of O(n log^2 n) compare-exchanges
+*      that only depends on n, each one computed in constant time, equal
+*      neighbours are merged and the copies are sorted back by job. Either
+*      way, only whether two jobs share the same key may leak through
+*      timing;
+*   2. the distinct keys are expanded 16 at a time by 'precompute_rkeys_x16',
+*      hence once per batch whatever the number of their messages;
+*   3. the jobs are fed to the multi-buffer manager of 'encrypt.c', longest
+*      first, so that the lanes of 'giftb128_x4' are refilled as soon as
+*      a message is done and the last GIFTb-128 calls, when lanes run out
+*      of jobs, are those of the shortest messages.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "giftcofb.h"
+#include "secret.h"
+
+#define ARENA_ALIGN     64
+#define SCAN_KEYS       32          // distinct keys searched pairwise
+
+typedef struct {
+    u32 blocks;                 // number of GIFTb-128 calls
+    u32 job;
+} order_t;
+
+typedef struct {
+    u32 key[4];                 // copy of the key of the job
+    u32 job;
+    u32 slot;                   // index of the key in the distinct keys
+} entry_t;
+
+typedef struct {
+    u32 (*rkeys)[80];           // round keys of the distinct keys
+    u8 (*keys)[16];             // distinct keys
+    entry_t* entries;           // one per job, in the order of the jobs
+    order_t* order;
+} arena_t;
+
+// decreasing number of blocks, then increasing job index
+static int order_cmp(const void* a, const void* b) {
+    const order_t* x = a;
+    const order_t* y = b;
+    if (x->blocks != y->blocks)
+        return (x->blocks < y->blocks) - (x->blocks > y->blocks);
+    return (x->job > y->job) - (x->job < y->job);
+}
+
+// 1 if x < y, 0 otherwise, in constant time
+static u32 less(u32 x, u32 y) {
+    return (u32)(((u64)x - y) >> 63);
+}
+
+// 1 if the key of 'x' comes before the one of 'y' in an arbitrary total
+// order, 0 otherwise, in constant time
+static u32 key_less(const entry_t* x, const entry_t* y) {
+    u32 lt = 0, eq = 1;
+    for (int i = 0; i < 4; i++) {
+        lt |= eq & less(x->key[i], y->key[i]);
+        eq &= less(x->key[i] ^ y->key[i], 1);
+    }
+    return lt;
+}
+
+// swaps the entries if 'y' comes before 'x', by key or by job index
+static void minmax(entry_t* x, entry_t* y, int by_key) {
+    u32 mask = -(by_key ? key_less(y, x) : less(y->job, x->job));
+    u32* a = (u32*)x;
+    u32* b = (u32*)y;
+    for (u32 i = 0; i < sizeof(entry_t) / sizeof(u32); i++) {
+        u32 t = (a[i] ^ b[i]) & mask;
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+}
+
+/****************************************************************************
+* Sorts the 'n' entries by key or by job index with the merge-exchange
+* network of djbsort (https://sorting.cr.yp.to), whose compare-exchanges
+* only depend on 'n' (at most 'n log^2 n' of them).
+****************************************************************************/
+static void entry_sort(entry_t* x, u32 n, int by_key) {
+    u32 top = 1;
+    entry_t a;
+    if (n < 2)
+        return;
+    while (top < n - top)
+        top += top;
+    for (u32 p = top; p > 0; p >>= 1) {
+        u32 i;
+        for (i = 0; i < n - p; i++)
+            if (!(i & p))
+                minmax(&x[i], &x[i + p], by_key);
+        i = 0;
+        for (u32 q = top; q > p; q >>= 1) {
+            for (; i < n - q; i++) {
+                if (!(i & p)) {
+                    a = x[i + p];
+                    for (u32 r = q; r > p; r >>= 1)
+                        minmax(&a, &x[i + r], by_key);
+                    x[i + p] = a;
+                }
+            }
+        }
+    }
+    wipe(&a, sizeof(a));
+}
+
+// splits the arena, returning -1 if it is too small for 'n' jobs
+static int arena_split(arena_t* a, void* arena, u64 arena_len, u32 n) {
+    u8* p = (u8*)(((size_t)arena + ARENA_ALIGN - 1) &
+                ~(size_t)(ARENA_ALIGN - 1));
+    if (arena_len < giftcofb_batch_arena_size(n))
+        return -1;
+    a->rkeys = (u32 (*)[80])p;
+    p += (u64)n*sizeof(u32[80]);
+    a->keys = (u8 (*)[16])p;
+    p += (u64)n*16;
+    a->entries = (entry_t*)p;
+    p += (u64)n*sizeof(entry_t);
+    a->order = (order_t*)p;
+    return 0;
+}
+
+// groups the jobs by pairwise search, returning the number of distinct keys
+// or SCAN_KEYS + 1 if there are more
+static u32 scan_keys(arena_t* a, const giftcofb_job* jobs, u32 n) {
+    u32 nkeys = 0;
+    for (u32 j = 0; j < n; j++) {
+        u32 hit = 0, found = 0;
+        for (u32 k = 0; k < nkeys; k++) {
+            u32 eq = key_equal(a->keys[k], jobs[j].key);
+            found ^= (found ^ k) & -eq;
+            hit |= eq;
+        }
+        if (!hit) {
+            if (nkeys == SCAN_KEYS) {
+                wipe(a->keys, SCAN_KEYS*16);
+                return SCAN_KEYS + 1;
+            }
+            found = nkeys++;
+            memcpy(a->keys[found], jobs[j].key, 16);
+        }
+        a->entries[j].slot = found;
+    }
+    return nkeys;
+}
+
+// groups the jobs by sorting their keys, returning the number of distinct keys
+static u32 sort_keys(arena_t* a, const giftcofb_job* jobs, u32 n) {
+    entry_t* e = a->entries;
+    u32 nkeys = 0;
+    for (u32 j = 0; j < n; j++) {
+        memcpy(e[j].key, jobs[j].key, 16);
+        e[j].job = j;
+    }
+    entry_sort(e, n, 1);
+    for (u32 j = 0; j < n; j++) {
+        nkeys += (j == 0) || !key_equal((const u8*)e[j - 1].key,
+            (const u8*)e[j].key);
+        e[j].slot = nkeys - 1;
+        memcpy(a->keys[nkeys - 1], e[j].key, 16);
+    }
+    entry_sort(e, n, 0);
+    return nkeys;
+}
+
+// groups the jobs by key and returns the number of distinct keys
+static u32 group_keys(arena_t* a, const giftcofb_job* jobs, u32 n) {
+    u32 nkeys = scan_keys(a, jobs, n);
+    return (nkeys <= SCAN_KEYS) ? nkeys : sort_keys(a, jobs, n);
+}
+
+static void expand_keys(arena_t* a, u32 nkeys) {
+    u32 rkeys[16][80];
+    u8 keys[16][16];
+    for (u32 k = 0; k < nkeys; k += 16) {
+        u32 len = (nkeys - k < 16) ? nkeys - k : 16;
+        for (u32 j = 0; j < 16; j++)
+            memcpy(keys[j], a->keys[k + (j < len ? j : 0)], 16);
+        if (len == 16) {
+            precompute_rkeys_x16(a->rkeys + k, (const u8 (*)[16])keys);
+            continue;
+        }
+        precompute_rkeys_x16(rkeys, (const u8 (*)[16])keys);
+        memcpy(a->rkeys + k, rkeys, len*sizeof(u32[80]));
+    }
+    wipe(rkeys, sizeof(rkeys));
+    wipe(keys, sizeof(keys));
+}
+
+/****************************************************************************
+* Returns the size in bytes of the arena required by a batch of 'n' jobs.
+****************************************************************************/
+u64 giftcofb_batch_arena_size(u32 n) {
+    return ARENA_ALIGN - 1 + (u64)n*(sizeof(u32[80]) + 16 + sizeof(entry_t) +
+                sizeof(order_t));
+}
+
+/****************************************************************************
+* Encrypts/decrypts the 'n' jobs 'jobs', writing the result of each one to
+* its 'out' buffer and its tag verdict to its 'verdict' field, the working
+* memory being taken from the 'arena_len' bytes at 'arena' (at least
+* 'giftcofb_batch_arena_size(n)' bytes, erased before returning). Returns the
+* number of jobs with an invalid tag, or -1 if the arena is too small, in
+* which case no job is processed.
+****************************************************************************/
+int giftcofb_batch_submit(giftcofb_job* jobs, u32 n, void* arena,
+                u64 arena_len) {
+    giftcofb_mb mb;
+    arena_t a;
+    u32 nkeys;
+    int failed = 0;
+    if (arena_split(&a, arena, arena_len, n))
+        return -1;
+    nkeys = group_keys(&a, jobs, n);
+    expand_keys(&a, nkeys);
+    for (u32 j = 0; j < n; j++) {
+        a.order[j].blocks = 2 + (jobs[j].ad_len + 15) / 16 +
+            (jobs[j].in_len + 15) / 16;
+        a.order[j].job = j;
+    }
+    qsort(a.order, n, sizeof(order_t), order_cmp);
+    giftcofb_mb_init(&mb);
+    for (u32 i = 0; i < n; i++)
+        giftcofb_mb_submit(&mb, &jobs[a.order[i].job],
+            a.rkeys[a.entries[a.order[i].job].slot]);
+    while (giftcofb_mb_flush(&mb))
+        ;
+    for (u32 j = 0; j < n; j++)
+        failed += jobs[j].verdict != 0;
+    wipe(a.rkeys, (size_t)nkeys*sizeof(u32[80]));
+    wipe(a.keys, (size_t)nkeys*16);
+    wipe(a.entries, (size_t)n*sizeof(entry_t));
+    return failed;
+}
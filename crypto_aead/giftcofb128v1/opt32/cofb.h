@@ -49,14 +49,20 @@
     XOR_BLOCK(d, d, y);             \
 })
 
+// only the 'n' first bytes of 'm' and 'c' are accessed
 #define RHO(y, m, x, c, n) ({       \
-    XOR_BLOCK(c, y, m);				\
-    RHO1(x, y, m, n);				\
+    padding(x,m,n);                 \
+    XOR_BLOCK(tmpb, y, x);          \
+    memcpy(c, tmpb, n);             \
+    G(y);                           \
+    XOR_BLOCK(x, x, y);             \
 })
 
 #define RHO_PRIME(y, c, x, m, n) ({ \
-    XOR_BLOCK(m, y, c);             \
-    RHO1(x, y, m, n);               \
+    padding(x,c,n);                 \
+    XOR_BLOCK(tmpb, y, x);          \
+    memcpy(m, tmpb, n);             \
+    RHO1(x, y, (u8*)tmpb, n);       \
 })
 
 #endif // COFB_H_
\ No newline at end of file
@@ -14,6 +14,8 @@
 #include "api.h"
 #include "cofb.h"
 #include "giftb128.h"
+#include "giftcofb.h"
+#include "secret.h"
 
 #define TAGBYTES        CRYPTO_ABYTES
 #define BLOCKBYTES      CRYPTO_ABYTES
@@ -21,43 +23,46 @@
 #define COFB_DECRYPT    0
 
 /****************************************************************************
-* 32-bit padding implementation.
+* 32-bit padding implementation. Only the 'no_of_bytes' first bytes of 's',
+* which can be of any alignment, are read.
 ****************************************************************************/
-static inline void padding(u32* d, const u32* s, const u32 no_of_bytes){
-    u32 i;
-    if (no_of_bytes == 0) {
-        d[0] = 0x00000080; // little-endian
-        d[1] = 0x00000000;
-        d[2] = 0x00000000;
-        d[3] = 0x00000000;
-    }
-    else if (no_of_bytes < BLOCKBYTES) {
-        for (i = 0; i < no_of_bytes/4+1; i++)
-            d[i] = s[i];
-        d[i-1] &= ~(0xffffffffL << (no_of_bytes % 4)*8);
-        d[i-1] |= 0x00000080L << (no_of_bytes % 4)*8;
-        for (; i < 4; i++)
-            d[i] = 0x00000000;
+static inline void padding(u32* d, const u8* s, const u32 no_of_bytes){
+    if (no_of_bytes < BLOCKBYTES) {
+        memset(d, 0x00, BLOCKBYTES);
+        memcpy(d, s, no_of_bytes);
+        ((u8*)d)[no_of_bytes] = 0x80; // little-endian
     }
     else {
-        d[0] = s[0];
-        d[1] = s[1];
-        d[2] = s[2];
-        d[3] = s[3];
+        memcpy(d, s, BLOCKBYTES);
     }
 }
 
+/****************************************************************************
+* GIFTb-128 with the round keys 'rkey' if not NULL, with the round keys
+* derived on the fly from 'key' otherwise.
+****************************************************************************/
+static inline __attribute__((always_inline))
+void cipher(u8* out, const u8* in, const u32* rkey, const u8* key) {
+    if (rkey)
+        giftb128(out, in, rkey);
+    else
+        giftb128_otf(out, in, key);
+}
+
 /****************************************************************************
 * Constant-time implementation of the GIFT-COFB authenticated cipher based on
 * fixsliced GIFTb-128. Encryption/decryption is handled by the same function,
-* depending on the 'encrypting' parameter (1/0).
+* depending on the 'encrypting' parameter (1/0). The block cipher is called
+* through 'cipher', the body being inlined in each of its callers so that the
+* choice between 'rkey' and 'key' is resolved at compile time.
 ****************************************************************************/
-int giftcofb_crypt(u8* out, const u8* key, const u8* nonce, const u8* ad,
-                u32 ad_len, const u8* in, u32 in_len, const int encrypting) {
+static inline __attribute__((always_inline))
+int cofb_crypt(u8* out, const u32* rkey, const u8* key, const u8* nonce,
+                const u8* ad, u32 ad_len, const u8* in, u32 in_len,
+                const int encrypting) {
 
     u32 tmp0, tmp1, emptyA, emptyM;
-    u32 offset[2], input[4], rkey[80];
-    u8 Y[16];
+    u32 offset[2], input[4], tmpb[4], Y[4];
 
     if (!encrypting) {
         if (in_len < TAGBYTES)
@@ -75,16 +80,15 @@ int giftcofb_crypt(u8* out, const u8* key, const u8* nonce, const u8* ad,
     else
         emptyM = 0;
 
-    precompute_rkeys(rkey, key);
-    giftb128(Y, nonce, rkey);
-    offset[0] = ((u32*)Y)[0];
-    offset[1] = ((u32*)Y)[1];
+    cipher((u8*)Y, nonce, rkey, key);
+    offset[0] = Y[0];
+    offset[1] = Y[1];
 
     while (ad_len > BLOCKBYTES) {
-        RHO1(input, (u32*)Y, (u32*)ad, BLOCKBYTES);
+        RHO1(input, Y, ad, BLOCKBYTES);
         DOUBLE_HALF_BLOCK(offset);
         XOR_TOP_BAR_BLOCK(input, offset);
-        giftb128(Y, (u8*)input, rkey);
+        cipher((u8*)Y, (u8*)input, rkey, key);
         ad += BLOCKBYTES;
         ad_len -= BLOCKBYTES;
     }
@@ -97,18 +101,18 @@ int giftcofb_crypt(u8* out, const u8* key, const u8* nonce, const u8* ad,
         TRIPLE_HALF_BLOCK(offset);
     }
 
-    RHO1(input, (u32*)Y, (u32*)ad, ad_len);
+    RHO1(input, Y, ad, ad_len);
     XOR_TOP_BAR_BLOCK(input, offset);
-    giftb128(Y, (u8*)input, rkey);
+    cipher((u8*)Y, (u8*)input, rkey, key);
 
     while (in_len > BLOCKBYTES) {
         DOUBLE_HALF_BLOCK(offset);
         if (encrypting)
-            RHO((u32*)Y, (u32*)in, input, (u32*)out, BLOCKBYTES);
+            RHO(Y, in, input, out, BLOCKBYTES);
         else
-            RHO_PRIME((u32*)Y, (u32*)in, input, (u32*)out, BLOCKBYTES);
+            RHO_PRIME(Y, in, input, out, BLOCKBYTES);
         XOR_TOP_BAR_BLOCK(input, offset);
-        giftb128(Y, (u8*)input, rkey);
+        cipher((u8*)Y, (u8*)input, rkey, key);
         in += BLOCKBYTES;
         out += BLOCKBYTES;
         in_len -= BLOCKBYTES;
@@ -119,15 +123,15 @@ int giftcofb_crypt(u8* out, const u8* key, const u8* nonce, const u8* ad,
         if(in_len % BLOCKBYTES != 0)
             TRIPLE_HALF_BLOCK(offset);
         if (encrypting) {
-            RHO((u32*)Y, (u32*)in, input, (u32*)out, in_len);
+            RHO(Y, in, input, out, in_len);
             out += in_len;
         }
         else {
-            RHO_PRIME((u32*)Y, (u32*)in, input, (u32*)out, in_len);
+            RHO_PRIME(Y, in, input, out, in_len);
             in += in_len;
         }
         XOR_TOP_BAR_BLOCK(input, offset);
-        giftb128(Y, (u8*)input, rkey);
+        cipher((u8*)Y, (u8*)input, rkey, key);
     }
 
     if (encrypting) {
@@ -137,12 +141,538 @@ int giftcofb_crypt(u8* out, const u8* key, const u8* nonce, const u8* ad,
     // decrypting
     tmp0 = 0;
     for(tmp1 = 0; tmp1 < TAGBYTES; tmp1++)
-        tmp0 |= in[tmp1] ^ Y[tmp1];
+        tmp0 |= in[tmp1] ^ ((u8*)Y)[tmp1];
     return tmp0;
 }
 
 /****************************************************************************
-* API required by the NIST for the LWC competition.
+* GIFT-COFB with the round keys 'rkey' computed by 'precompute_rkeys'.
+****************************************************************************/
+int giftcofb_crypt_rkey(u8* out, const u32* rkey, const u8* nonce,
+                const u8* ad, u32 ad_len, const u8* in, u32 in_len,
+                const int encrypting) {
+    return cofb_crypt(out, rkey, NULL, nonce, ad, ad_len, in, in_len,
+                encrypting);
+}
+
+/****************************************************************************
+* GIFT-COFB with the round keys of each GIFTb-128 call derived on the fly
+* from the 16-byte 'key' (see 'giftb128_otf'): only 80 bytes of round keys
+* are live during a call, instead of 320 bytes for 'giftcofb_crypt' which
+* expands the key once per message. Each block costs about one key schedule
+* more, so that 'giftcofb_crypt' remains faster unless the stack is scarce.
+****************************************************************************/
+int giftcofb_crypt_otf(u8* out, const u8* key, const u8* nonce,
+                const u8* ad, u32 ad_len, const u8* in, u32 in_len,
+                const int encrypting) {
+    return cofb_crypt(out, NULL, key, nonce, ad, ad_len, in, in_len,
+                encrypting);
+}
+
+/****************************************************************************
+* Same as 'giftcofb_crypt_rkey', the key being expanded at each call.
+****************************************************************************/
+int giftcofb_crypt(u8* out, const u8* key, const u8* nonce, const u8* ad,
+                u32 ad_len, const u8* in, u32 in_len, const int encrypting) {
+    u32 rkey[80];
+    precompute_rkeys(rkey, key);
+    return giftcofb_crypt_rkey(out, rkey, nonce, ad, ad_len, in, in_len,
+                encrypting);
+}
+
+/****************************************************************************
+* Same as 'giftcofb_crypt_rkey' for 4 independent messages at once, processed
+* in lockstep so that each GIFTb-128 call of the chain encrypts one block per
+* message through 'giftb128_x4' (4 SIMD lanes). The messages have their own
+* round keys, nonce, associated data, input and output, but share the same
+* lengths so that they all follow the same control flow. 'rkey' holds the
+* round keys of the 4 messages interleaved word by word (the i-th word of the
+* j-th message in rkey[4*i + j]).
+* When decrypting, the i-th bit of the returned value is set if the tag of
+* the i-th message is invalid.
+****************************************************************************/
+int giftcofb_crypt_x4_rkey(u8* const out[4], const u32* rkey,
+                const u8* const nonce[4], const u8* const ad[4], u32 ad_len,
+                const u8* const in[4], u32 in_len, const int encrypting) {
+
+    u32 tmp0, tmp1, emptyA, emptyM, ret = 0;
+    u32 offset[4][2], input[4][4], tmpb[4], Y[4][4];
+    const u8* a[4];
+    const u8* m[4];
+    u8* c[4];
+
+    if (!encrypting) {
+        if (in_len < TAGBYTES)
+            return -1;
+        in_len -= TAGBYTES;
+    }
+
+    emptyA = (ad_len == 0);
+    emptyM = (in_len == 0);
+
+    for (int j = 0; j < 4; j++) {
+        memcpy(input[j], nonce[j], BLOCKBYTES);
+        a[j] = ad[j];
+        m[j] = in[j];
+        c[j] = out[j];
+    }
+    giftb128_x4((u8*)Y, (u8*)input, rkey);
+    for (int j = 0; j < 4; j++) {
+        offset[j][0] = Y[j][0];
+        offset[j][1] = Y[j][1];
+    }
+
+    while (ad_len > BLOCKBYTES) {
+        for (int j = 0; j < 4; j++) {
+            RHO1(input[j], Y[j], a[j], BLOCKBYTES);
+            DOUBLE_HALF_BLOCK(offset[j]);
+            XOR_TOP_BAR_BLOCK(input[j], offset[j]);
+            a[j] += BLOCKBYTES;
+        }
+        giftb128_x4((u8*)Y, (u8*)input, rkey);
+        ad_len -= BLOCKBYTES;
+    }
+
+    for (int j = 0; j < 4; j++) {
+        TRIPLE_HALF_BLOCK(offset[j]);
+        if ((ad_len % BLOCKBYTES != 0) || (emptyA))
+            TRIPLE_HALF_BLOCK(offset[j]);
+        if (emptyM) {
+            TRIPLE_HALF_BLOCK(offset[j]);
+            TRIPLE_HALF_BLOCK(offset[j]);
+        }
+        RHO1(input[j], Y[j], a[j], ad_len);
+        XOR_TOP_BAR_BLOCK(input[j], offset[j]);
+    }
+    giftb128_x4((u8*)Y, (u8*)input, rkey);
+
+    while (in_len > BLOCKBYTES) {
+        for (int j = 0; j < 4; j++) {
+            DOUBLE_HALF_BLOCK(offset[j]);
+            if (encrypting)
+                RHO(Y[j], m[j], input[j], c[j], BLOCKBYTES);
+            else
+                RHO_PRIME(Y[j], m[j], input[j], c[j], BLOCKBYTES);
+            XOR_TOP_BAR_BLOCK(input[j], offset[j]);
+            m[j] += BLOCKBYTES;
+            c[j] += BLOCKBYTES;
+        }
+        giftb128_x4((u8*)Y, (u8*)input, rkey);
+        in_len -= BLOCKBYTES;
+    }
+
+    if (!emptyM) {
+        for (int j = 0; j < 4; j++) {
+            TRIPLE_HALF_BLOCK(offset[j]);
+            if (in_len % BLOCKBYTES != 0)
+                TRIPLE_HALF_BLOCK(offset[j]);
+            if (encrypting) {
+                RHO(Y[j], m[j], input[j], c[j], in_len);
+                c[j] += in_len;
+            }
+            else {
+                RHO_PRIME(Y[j], m[j], input[j], c[j], in_len);
+                m[j] += in_len;
+            }
+            XOR_TOP_BAR_BLOCK(input[j], offset[j]);
+        }
+        giftb128_x4((u8*)Y, (u8*)input, rkey);
+    }
+
+    for (int j = 0; j < 4; j++) {
+        if (encrypting) {
+            memcpy(c[j], Y[j], TAGBYTES);
+            continue;
+        }
+        tmp0 = 0;
+        for(tmp1 = 0; tmp1 < TAGBYTES; tmp1++)
+            tmp0 |= m[j][tmp1] ^ ((u8*)Y[j])[tmp1];
+        ret |= (u32)(tmp0 != 0) << j;
+    }
+    return ret;
+}
+
+/****************************************************************************
+* Same as 'giftcofb_crypt' for 4 independent messages of the same lengths,
+* the 4 keys being expanded at once.
+****************************************************************************/
+int giftcofb_crypt_x4(u8* const out[4], const u8* const key[4],
+                const u8* const nonce[4], const u8* const ad[4], u32 ad_len,
+                const u8* const in[4], u32 in_len, const int encrypting) {
+    u32 rkeys[4][80], rkey[4*80];
+    u8 keys[4][16];
+    for (int j = 0; j < 4; j++)
+        memcpy(keys[j], key[j], 16);
+    precompute_rkeys_x4(rkeys, keys);
+    // round keys of the 4 messages interleaved word by word
+    for (int i = 0; i < 80; i++)
+        for (int j = 0; j < 4; j++)
+            rkey[4*i + j] = rkeys[j][i];
+    return giftcofb_crypt_x4_rkey(out, rkey, nonce, ad, ad_len, in, in_len,
+                encrypting);
+}
+
+/****************************************************************************
+* Multi-buffer GIFT-COFB. Each lane runs the chain of 'cofb_crypt' as a state
+* machine: after each GIFTb-128 call, 'lane_next' consumes the output 'Y' of
+* the lane and computes its next input block, so that lanes at different
+* positions of messages of different lengths share the same 'giftb128_x4'
+* call. A lane whose message is done is freed at once and refilled by the
+* next submitted job, which only requires to copy its round keys to the
+* column of the lane in the interleaved round keys.
+****************************************************************************/
+#define LANE_NONCE      0
+#define LANE_AD         1
+#define LANE_MSG        2
+#define LANE_TAG        3
+
+/****************************************************************************
+* Computes the next input block of the lane 'j' from its GIFTb-128 output and
+* returns 1, or writes its tag (resp. tag verdict) if the message is done
+* and returns 0.
+****************************************************************************/
+static int lane_next(giftcofb_mb* mb, u32 j) {
+    giftcofb_lane* l = &mb->lane[j];
+    u32* Y = mb->Y[j];
+    u32* input = mb->input[j];
+    u32 tmp0, tmp1, tmpb[4];
+
+    if (l->phase == LANE_NONCE) {
+        l->offset[0] = Y[0];
+        l->offset[1] = Y[1];
+        l->phase = LANE_AD;
+    }
+    if (l->phase == LANE_AD) {
+        if (l->ad_len > BLOCKBYTES) {
+            RHO1(input, Y, l->ad, BLOCKBYTES);
+            DOUBLE_HALF_BLOCK(l->offset);
+            XOR_TOP_BAR_BLOCK(input, l->offset);
+            l->ad += BLOCKBYTES;
+            l->ad_len -= BLOCKBYTES;
+            return 1;
+        }
+        TRIPLE_HALF_BLOCK(l->offset);
+        if ((l->ad_len % BLOCKBYTES != 0) || (l->emptyA))
+            TRIPLE_HALF_BLOCK(l->offset);
+        if (l->emptyM) {
+            TRIPLE_HALF_BLOCK(l->offset);
+            TRIPLE_HALF_BLOCK(l->offset);
+        }
+        RHO1(input, Y, l->ad, l->ad_len);
+        XOR_TOP_BAR_BLOCK(input, l->offset);
+        l->phase = l->emptyM ? LANE_TAG : LANE_MSG;
+        return 1;
+    }
+    if (l->phase == LANE_MSG) {
+        if (l->in_len > BLOCKBYTES) {
+            DOUBLE_HALF_BLOCK(l->offset);
+            if (l->job->encrypting)
+                RHO(Y, l->in, input, l->out, BLOCKBYTES);
+            else
+                RHO_PRIME(Y, l->in, input, l->out, BLOCKBYTES);
+            XOR_TOP_BAR_BLOCK(input, l->offset);
+            l->in += BLOCKBYTES;
+            l->out += BLOCKBYTES;
+            l->in_len -= BLOCKBYTES;
+            return 1;
+        }
+        TRIPLE_HALF_BLOCK(l->offset);
+        if (l->in_len % BLOCKBYTES != 0)
+            TRIPLE_HALF_BLOCK(l->offset);
+        if (l->job->encrypting) {
+            RHO(Y, l->in, input, l->out, l->in_len);
+            l->out += l->in_len;
+        }
+        else {
+            RHO_PRIME(Y, l->in, input, l->out, l->in_len);
+            l->in += l->in_len;
+        }
+        XOR_TOP_BAR_BLOCK(input, l->offset);
+        l->phase = LANE_TAG;
+        return 1;
+    }
+    // LANE_TAG: 'Y' is the tag
+    if (l->job->encrypting) {
+        memcpy(l->out, Y, TAGBYTES);
+        l->job->verdict = 0;
+        return 0;
+    }
+    tmp0 = 0;
+    for(tmp1 = 0; tmp1 < TAGBYTES; tmp1++)
+        tmp0 |= l->in[tmp1] ^ ((u8*)Y)[tmp1];
+    l->job->verdict = (tmp0 != 0);
+    return 0;
+}
+
+static void mb_push(giftcofb_mb* mb, giftcofb_job* job) {
+    mb->done[(mb->done_head + mb->ndone++) % (2*GIFTCOFB_LANES)] = job;
+}
+
+static giftcofb_job* mb_pop(giftcofb_mb* mb) {
+    giftcofb_job* job;
+    if (mb->ndone == 0)
+        return NULL;
+    job = mb->done[mb->done_head];
+    mb->done_head = (mb->done_head + 1) % (2*GIFTCOFB_LANES);
+    mb->ndone--;
+    return job;
+}
+
+/****************************************************************************
+* Runs one GIFTb-128 call on all the busy lanes (on a single block through
+* 'giftb128' if only one lane is busy) and retires the finished jobs.
+****************************************************************************/
+static void mb_step(giftcofb_mb* mb) {
+    u32 last = 0;
+    if (mb->active == 1) {
+        while (!mb->lane[last].job)
+            last++;
+        giftb128((u8*)mb->Y[last], (u8*)mb->input[last], mb->lane[last].rkey);
+    }
+    else {
+        giftb128_x4((u8*)mb->Y, (u8*)mb->input, mb->rkey);
+    }
+    for (u32 j = 0; j < GIFTCOFB_LANES; j++) {
+        if (!mb->lane[j].job || lane_next(mb, j))
+            continue;
+        mb_push(mb, mb->lane[j].job);
+        mb->lane[j].job = NULL;
+        mb->active--;
+    }
+    // no key material is kept once all the lanes are free
+    if (mb->active == 0) {
+        wipe(mb->rkey, sizeof(mb->rkey));
+        wipe(mb->Y, sizeof(mb->Y));
+        wipe(mb->input, sizeof(mb->input));
+    }
+}
+
+/****************************************************************************
+* Initializes an empty multi-buffer manager.
+****************************************************************************/
+void giftcofb_mb_init(giftcofb_mb* mb) {
+    memset(mb, 0, sizeof(giftcofb_mb));
+}
+
+/****************************************************************************
+* Loads 'job', whose key has been expanded to 'rkey' by 'precompute_rkeys',
+* into a free lane, and processes the busy lanes until one is free again if
+* all of them are busy. Returns a completed job or NULL if none is available
+* yet. A job that is too short to hold a tag is completed at once.
+****************************************************************************/
+giftcofb_job* giftcofb_mb_submit(giftcofb_mb* mb, giftcofb_job* job,
+                const u32* rkey) {
+    giftcofb_lane* l;
+    u32 j = 0;
+    if (!job->encrypting && job->in_len < TAGBYTES) {
+        job->verdict = -1;
+        mb_push(mb, job);
+        return mb_pop(mb);
+    }
+    while (mb->lane[j].job)
+        j++;
+    l = &mb->lane[j];
+    l->job = job;
+    l->rkey = rkey;
+    l->ad = job->ad;
+    l->in = job->in;
+    l->out = job->out;
+    l->ad_len = job->ad_len;
+    l->in_len = job->in_len - (job->encrypting ? 0 : TAGBYTES);
+    l->phase = LANE_NONCE;
+    l->emptyA = (l->ad_len == 0);
+    l->emptyM = (l->in_len == 0);
+    memcpy(mb->input[j], job->nonce, BLOCKBYTES);
+    for (int i = 0; i < 80; i++)
+        mb->rkey[GIFTCOFB_LANES*i + j] = rkey[i];
+    mb->active++;
+    while (mb->active == GIFTCOFB_LANES)
+        mb_step(mb);
+    return mb_pop(mb);
+}
+
+/****************************************************************************
+* Returns a completed job, processing the busy lanes until one is done if
+* needed, or NULL once all the submitted jobs have been returned.
+****************************************************************************/
+giftcofb_job* giftcofb_mb_flush(giftcofb_mb* mb) {
+    while (mb->ndone == 0 && mb->active > 0)
+        mb_step(mb);
+    return mb_pop(mb);
+}
+
+/****************************************************************************
+* Incremental GIFT-COFB: the state of 'cofb_crypt' is kept in the context
+* between calls. The last block of the associated data (resp. message) is
+* held back in 'buf' until more data shows that it is not the last one, or
+* until the message (resp. the end of the message) shows that it is, since
+* the offset update of a block depends on whether it is the last one. The
+* last associated data block is also the place where an empty message is
+* accounted for, hence it is only processed by the first nonempty message
+* chunk or by 'giftcofb_stream_final'.
+****************************************************************************/
+#define STREAM_AD       0
+#define STREAM_MSG      1
+
+/****************************************************************************
+* Expands 'key' and encrypts 'nonce' for the encryption/decryption
+* ('encrypting' = 1/0) of a single message.
+****************************************************************************/
+void giftcofb_stream_init(giftcofb_stream* s, const u8* key, const u8* nonce,
+                const int encrypting) {
+    memset(s, 0, sizeof(giftcofb_stream));
+    precompute_rkeys(s->rkey, key);
+    giftb128((u8*)s->Y, nonce, s->rkey);
+    s->offset[0] = s->Y[0];
+    s->offset[1] = s->Y[1];
+    s->phase = STREAM_AD;
+    s->emptyA = 1;
+    s->encrypting = encrypting;
+}
+
+// processes a full associated data block which is not the last one
+static void stream_ad_block(giftcofb_stream* s, const u8* ad) {
+    u32 tmp0, tmp1, input[4];
+    RHO1(input, s->Y, ad, BLOCKBYTES);
+    DOUBLE_HALF_BLOCK(s->offset);
+    XOR_TOP_BAR_BLOCK(input, s->offset);
+    giftb128((u8*)s->Y, (u8*)input, s->rkey);
+}
+
+// processes the last associated data block, held in 'buf'
+static void stream_ad_final(giftcofb_stream* s, u32 emptyM) {
+    u32 tmp0, tmp1, input[4];
+    TRIPLE_HALF_BLOCK(s->offset);
+    if ((s->buf_len % BLOCKBYTES != 0) || (s->emptyA))
+        TRIPLE_HALF_BLOCK(s->offset);
+    if (emptyM) {
+        TRIPLE_HALF_BLOCK(s->offset);
+        TRIPLE_HALF_BLOCK(s->offset);
+    }
+    RHO1(input, s->Y, s->buf, s->buf_len);
+    XOR_TOP_BAR_BLOCK(input, s->offset);
+    giftb128((u8*)s->Y, (u8*)input, s->rkey);
+    s->buf_len = 0;
+    s->phase = STREAM_MSG;
+}
+
+// processes a full message block which is not the last one
+static void stream_msg_block(giftcofb_stream* s, u8* out, const u8* in) {
+    u32 tmp0, tmp1, input[4], tmpb[4];
+    DOUBLE_HALF_BLOCK(s->offset);
+    if (s->encrypting)
+        RHO(s->Y, in, input, out, BLOCKBYTES);
+    else
+        RHO_PRIME(s->Y, in, input, out, BLOCKBYTES);
+    XOR_TOP_BAR_BLOCK(input, s->offset);
+    giftb128((u8*)s->Y, (u8*)input, s->rkey);
+}
+
+/****************************************************************************
+* Absorbs the 'len' next bytes of associated data. Must not be called once
+* message bytes have been passed to 'giftcofb_stream_update'.
+****************************************************************************/
+void giftcofb_stream_update_ad(giftcofb_stream* s, const u8* ad, u64 len) {
+    u32 n;
+    if (len == 0 || s->phase != STREAM_AD)
+        return;
+    s->emptyA = 0;
+    while (len > 0) {
+        if (s->buf_len == BLOCKBYTES) {
+            stream_ad_block(s, s->buf);
+            s->buf_len = 0;
+        }
+        // full blocks followed by more data are processed in place
+        for (; s->buf_len == 0 && len > BLOCKBYTES; len -= BLOCKBYTES) {
+            stream_ad_block(s, ad);
+            ad += BLOCKBYTES;
+        }
+        n = (len < BLOCKBYTES - s->buf_len) ? (u32)len :
+            BLOCKBYTES - s->buf_len;
+        memcpy(s->buf + s->buf_len, ad, n);
+        s->buf_len += n;
+        ad += n;
+        len -= n;
+    }
+}
+
+/****************************************************************************
+* Encrypts/decrypts the 'len' next bytes of the message (without the tag
+* when decrypting) from 'in' to 'out', which must not overlap. Returns the
+* number of bytes written to 'out', i.e. those of all the blocks received so
+* far but the last one.
+****************************************************************************/
+u64 giftcofb_stream_update(giftcofb_stream* s, u8* out, const u8* in,
+                u64 len) {
+    u64 written = 0;
+    u32 n;
+    if (len == 0)
+        return 0;
+    if (s->phase == STREAM_AD)
+        stream_ad_final(s, 0);
+    while (len > 0) {
+        if (s->buf_len == BLOCKBYTES) {
+            stream_msg_block(s, out, s->buf);
+            s->buf_len = 0;
+            out += BLOCKBYTES;
+            written += BLOCKBYTES;
+        }
+        for (; s->buf_len == 0 && len > BLOCKBYTES; len -= BLOCKBYTES) {
+            stream_msg_block(s, out, in);
+            in += BLOCKBYTES;
+            out += BLOCKBYTES;
+            written += BLOCKBYTES;
+        }
+        n = (len < BLOCKBYTES - s->buf_len) ? (u32)len :
+            BLOCKBYTES - s->buf_len;
+        memcpy(s->buf + s->buf_len, in, n);
+        s->buf_len += n;
+        in += n;
+        len -= n;
+    }
+    return written;
+}
+
+/****************************************************************************
+* Processes the last block, writing its bytes to 'out' and their number to
+* 'out_len'. When encrypting, writes the tag to 'tag' and returns 0. When
+* decrypting, returns a nonzero value if 'tag' is invalid. The context is
+* erased and must be initialized again before being reused.
+****************************************************************************/
+int giftcofb_stream_final(giftcofb_stream* s, u8* out, u64* out_len,
+                u8* tag) {
+    u32 tmp0, tmp1, input[4], tmpb[4];
+    *out_len = 0;
+    if (s->phase == STREAM_AD) {
+        stream_ad_final(s, 1);
+    }
+    else {
+        TRIPLE_HALF_BLOCK(s->offset);
+        if (s->buf_len % BLOCKBYTES != 0)
+            TRIPLE_HALF_BLOCK(s->offset);
+        if (s->encrypting)
+            RHO(s->Y, s->buf, input, out, s->buf_len);
+        else
+            RHO_PRIME(s->Y, s->buf, input, out, s->buf_len);
+        XOR_TOP_BAR_BLOCK(input, s->offset);
+        giftb128((u8*)s->Y, (u8*)input, s->rkey);
+        *out_len = s->buf_len;
+    }
+    tmp0 = 0;
+    if (s->encrypting)
+        memcpy(tag, s->Y, TAGBYTES);
+    else
+        for(tmp1 = 0; tmp1 < TAGBYTES; tmp1++)
+            tmp0 |= tag[tmp1] ^ ((u8*)s->Y)[tmp1];
+    wipe(s, sizeof(giftcofb_stream));
+    wipe(input, sizeof(input));
+    return tmp0;
+}
+
+/****************************************************************************
+* API required by the NIST for the LWC competition. The round keys are taken
+* from the thread-local cache of 'rkey_cache.c' if it is enabled (see
+* 'giftcofb.h').
 ****************************************************************************/
 int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
                     const unsigned char* m, unsigned long long mlen,
@@ -151,7 +681,12 @@ int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
                     const unsigned char* k) {
     (void)nsec;
     *clen = mlen + TAGBYTES;
+#if GIFTCOFB_CACHE_ENTRIES > 0
+    return giftcofb_crypt_rkey(c, giftcofb_cache_rkey(k), npub, ad, adlen,
+                m, mlen, COFB_ENCRYPT);
+#else
     return giftcofb_crypt(c, k, npub, ad, adlen, m, mlen, COFB_ENCRYPT);
+#endif
 }
 
 /****************************************************************************
@@ -164,5 +699,10 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long *mlen,
                     const unsigned char *k) {
     (void)nsec;
     *mlen = clen - TAGBYTES;
+#if GIFTCOFB_CACHE_ENTRIES > 0
+    return giftcofb_crypt_rkey(m, giftcofb_cache_rkey(k), npub, ad, adlen,
+                c, clen, COFB_DECRYPT);
+#else
     return giftcofb_crypt(m, k, npub, ad, adlen, c, clen, COFB_DECRYPT);
+#endif
 }
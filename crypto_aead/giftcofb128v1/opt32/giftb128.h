@@ -6,6 +6,11 @@ typedef unsigned int u32;
 
 extern void precompute_rkeys(u32* rkeys, const u8* key);
 extern void giftb128(u8* out, const u8* in, const u32* rkeys);
+extern void giftb128_otf(u8* out, const u8* in, const u8* key);
+extern void giftb128_x4(u8* out, const u8* in, const u32* rkeys);
+extern void precompute_rkeys_x4(u32 rkeys[4][80], const u8 keys[4][16]);
+extern void precompute_rkeys_x8(u32 rkeys[8][80], const u8 keys[8][16]);
+extern void precompute_rkeys_x16(u32 rkeys[16][80], const u8 keys[16][16]);
 
 #define ROR(x,y)											\
 	(((x) >> (y)) | ((x) << (32 - (y))))
@@ -85,4 +90,86 @@ extern void giftb128(u8* out, const u8* in, const u32* rkeys);
 	state[0] ^= state[3];									\
 })
 
+/****************************************************************************
+* S-box without any NOT: each state word may be held complemented, which is
+* recorded in the flag 'f' attached to it. A complemented operand turns an
+* AND/OR into an AND-NOT (a single 'andn' with BMI1), OR or AND, so that the
+* NOT of the S-box only flips a flag. Once the rounds are unrolled, all the
+* flags are compile-time constants and the selections below vanish.
+****************************************************************************/
+// held value of x & y, complemented iff fx & fy
+#define AND_NEG(x, fx, y, fy)								\
+	((fx) ? ((fy) ? ((x) | (y)) : (~(x) & (y))) :			\
+			((fy) ? (~(y) & (x)) : ((x) & (y))))
+
+// held value of x | y, complemented iff fx | fy
+#define OR_NEG(x, fx, y, fy)								\
+	((fx) ? ((fy) ? ((x) & (y)) : (~(y) & (x))) :			\
+			((fy) ? (~(x) & (y)) : ((x) | (y))))
+
+#define SBOX_NEG(s0, s1, s2, s3, f0, f1, f2, f3)			\
+	s1 ^= AND_NEG(s0, f0, s2, f2);		f1 ^= (f0) & (f2);	\
+	s0 ^= AND_NEG(s1, f1, s3, f3);		f0 ^= (f1) & (f3);	\
+	s2 ^= OR_NEG(s0, f0, s1, f1);		f2 ^= (f0) | (f1);	\
+	s3 ^= s2;							f3 ^= (f2);			\
+	s1 ^= s3;							f1 ^= (f3);			\
+										f3 ^= 1;			\
+	s2 ^= AND_NEG(s0, f0, s1, f1);		f2 ^= (f0) & (f1);
+
+#define SWAP_STATE_0_3(state, neg) ({						\
+	tmp = state[0];											\
+	state[0] = state[3];									\
+	state[3] = tmp;											\
+	tmp = neg[0];											\
+	neg[0] = neg[3];										\
+	neg[3] = tmp;											\
+})
+
+// same as 'QUINTUPLE_ROUND' with the S-box above
+#define QUINTUPLE_ROUND_NEG(state, neg, rkey, rconst) ({	\
+	SBOX_NEG(state[0], state[1], state[2], state[3],		\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[3] = NIBBLE_ROR_1(state[3]);						\
+	state[1] = NIBBLE_ROR_2(state[1]);						\
+	state[2] = NIBBLE_ROR_3(state[2]);						\
+	state[1] ^= (rkey)[0];									\
+	state[2] ^= (rkey)[1];									\
+	state[0] ^= (rconst)[0];								\
+	SBOX_NEG(state[3], state[1], state[2], state[0],		\
+		neg[3], neg[1], neg[2], neg[0]);					\
+	state[0] = HALF_ROR_4(state[0]);						\
+	state[1] = HALF_ROR_8(state[1]);						\
+	state[2] = HALF_ROR_12(state[2]);						\
+	state[1] ^= (rkey)[2];									\
+	state[2] ^= (rkey)[3];									\
+	state[3] ^= (rconst)[1];								\
+	SBOX_NEG(state[0], state[1], state[2], state[3],		\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[3] = ROR(state[3], 16);							\
+	state[2] = ROR(state[2], 16);							\
+	SWAPMOVE(state[1], state[1], 0x55555555, 1);			\
+	SWAPMOVE(state[2], state[2], 0x00005555, 1);			\
+	SWAPMOVE(state[3], state[3], 0x55550000, 1);			\
+	state[1] ^= (rkey)[4];									\
+	state[2] ^= (rkey)[5];									\
+	state[0] ^= (rconst)[2];								\
+	SBOX_NEG(state[3], state[1], state[2], state[0],		\
+		neg[3], neg[1], neg[2], neg[0]);					\
+	state[0] = BYTE_ROR_6(state[0]);						\
+	state[1] = BYTE_ROR_4(state[1]);						\
+	state[2] = BYTE_ROR_2(state[2]);						\
+	state[1] ^= (rkey)[6];									\
+	state[2] ^= (rkey)[7];									\
+	state[3] ^= (rconst)[3];								\
+	SBOX_NEG(state[0], state[1], state[2], state[3],		\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[3] = ROR(state[3], 24);							\
+	state[1] = ROR(state[1], 16);							\
+	state[2] = ROR(state[2], 8);							\
+	state[1] ^= (rkey)[8];									\
+	state[2] ^= (rkey)[9];									\
+	state[0] ^= (rconst)[4];								\
+	SWAP_STATE_0_3(state, neg);								\
+})
+
 #endif  // GIFT128_H_
\ No newline at end of file
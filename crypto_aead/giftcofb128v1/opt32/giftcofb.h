@@ -0,0 +1,184 @@
+#ifndef GIFTCOFB_H_
+#define GIFTCOFB_H_
+
+#include "giftb128.h"
+
+/****************************************************************************
+* GIFT-COFB encryption/decryption ('encrypting' = 1/0) of a single message
+* (see 'encrypt.c'). When decrypting, 'in_len' includes the tag and a nonzero
+* value is returned if the tag is invalid.
+****************************************************************************/
+int giftcofb_crypt(u8* out, const u8* key, const u8* nonce, const u8* ad,
+                u32 ad_len, const u8* in, u32 in_len, const int encrypting);
+
+/****************************************************************************
+* Same with the round keys already computed by 'precompute_rkeys', so that
+* they can be reused for any number of messages under the same key.
+****************************************************************************/
+int giftcofb_crypt_rkey(u8* out, const u32* rkey, const u8* nonce,
+                const u8* ad, u32 ad_len, const u8* in, u32 in_len,
+                const int encrypting);
+
+/****************************************************************************
+* Same as 'giftcofb_crypt' with the round keys derived on the fly during
+* each GIFTb-128 call (see 'encrypt.c'), which only requires 80 bytes of
+* round keys on the stack at the cost of slower long messages.
+****************************************************************************/
+int giftcofb_crypt_otf(u8* out, const u8* key, const u8* nonce,
+                const u8* ad, u32 ad_len, const u8* in, u32 in_len,
+                const int encrypting);
+
+/****************************************************************************
+* Same as 'giftcofb_crypt' for 4 independent messages of the same lengths,
+* processed in lockstep on 4 SIMD lanes. When decrypting, the i-th bit of the
+* returned value is set if the tag of the i-th message is invalid.
+****************************************************************************/
+int giftcofb_crypt_x4(u8* const out[4], const u8* const key[4],
+                const u8* const nonce[4], const u8* const ad[4], u32 ad_len,
+                const u8* const in[4], u32 in_len, const int encrypting);
+
+/****************************************************************************
+* Same with the round keys of the 4 messages computed by 'precompute_rkeys'
+* and interleaved word by word (the i-th word of the j-th message in
+* rkey[4*i + j]).
+****************************************************************************/
+int giftcofb_crypt_x4_rkey(u8* const out[4], const u32* rkey,
+                const u8* const nonce[4], const u8* const ad[4], u32 ad_len,
+                const u8* const in[4], u32 in_len, const int encrypting);
+
+/****************************************************************************
+* Thread-local cache of the round keys of the GIFTCOFB_CACHE_ENTRIES most
+* recently used keys, through which the NIST API avoids running the key
+* schedule for every message (see 'rkey_cache.c'). It is disabled by
+* default, as it keeps the round keys of past keys in thread-local storage
+* until the thread exits or calls 'giftcofb_cache_clear', which a stateless
+* API is not expected to do: build with -DGIFTCOFB_CACHE_ENTRIES=N (e.g. 8)
+* to enable it, in which case the functions below are provided. The
+* counters are per thread.
+****************************************************************************/
+#ifndef GIFTCOFB_CACHE_ENTRIES
+#define GIFTCOFB_CACHE_ENTRIES  0
+#endif
+
+typedef unsigned long long u64;
+
+typedef struct {
+    u64 hits;
+    u64 misses;
+    u64 evictions;
+} giftcofb_cache_stats;
+
+const u32* giftcofb_cache_rkey(const u8* key);
+void giftcofb_cache_get_stats(giftcofb_cache_stats* out);
+void giftcofb_cache_clear(void);
+
+/****************************************************************************
+* Read-only store of precomputed round keys, identified by 64-bit ids and
+* mapped in memory so that a process starts without running the key schedule
+* and all the processes using the same store share its pages (see
+* 'rkey_store.c' for the file format).
+****************************************************************************/
+typedef struct {
+    const void* map;
+    u64 size;
+    u64 count;
+    const u64* ids;
+    const u32* rkeys;
+} giftcofb_store;
+
+int giftcofb_store_build(const char* path, const u64* ids,
+                const u8 (*keys)[16], u64 n);
+int giftcofb_store_open(giftcofb_store* s, const char* path);
+const u32* giftcofb_store_rkey(const giftcofb_store* s, u64 id);
+void giftcofb_store_close(giftcofb_store* s);
+
+/****************************************************************************
+* Batch of independent messages, each with its own key, direction and
+* lengths (see 'batch.c'). 'in_len' and 'verdict' are as the arguments and
+* return value of 'giftcofb_crypt'; 'out' may be equal to 'in'.
+****************************************************************************/
+typedef struct {
+    const u8* key;
+    const u8* nonce;
+    const u8* ad;
+    const u8* in;
+    u8* out;
+    u32 ad_len;
+    u32 in_len;
+    int encrypting;
+    int verdict;
+} giftcofb_job;
+
+u64 giftcofb_batch_arena_size(u32 n);
+int giftcofb_batch_submit(giftcofb_job* jobs, u32 n, void* arena,
+                u64 arena_len);
+
+/****************************************************************************
+* Multi-buffer GIFT-COFB (see 'encrypt.c'): the messages of the submitted
+* jobs are processed GIFTCOFB_LANES at a time on the lanes of 'giftb128_x4',
+* a lane being refilled with the next job as soon as its message is done.
+* 'giftcofb_mb_submit' returns a completed job or NULL, and
+* 'giftcofb_mb_flush' returns the remaining ones one by one, then NULL. The
+* jobs and their round keys must remain valid until they are returned.
+****************************************************************************/
+#define GIFTCOFB_LANES  4
+
+typedef struct {
+    giftcofb_job* job;          // NULL if the lane is free
+    const u32* rkey;
+    const u8* ad;
+    const u8* in;
+    u8* out;
+    u32 ad_len;
+    u32 in_len;
+    u32 offset[2];
+    u32 phase;
+    u32 emptyA;
+    u32 emptyM;
+} giftcofb_lane;
+
+typedef struct {
+    u32 Y[GIFTCOFB_LANES][4];
+    u32 input[GIFTCOFB_LANES][4];
+    u32 rkey[GIFTCOFB_LANES*80];    // interleaved as for 'giftb128_x4'
+    giftcofb_lane lane[GIFTCOFB_LANES];
+    giftcofb_job* done[2*GIFTCOFB_LANES];
+    u32 done_head;
+    u32 ndone;
+    u32 active;
+} giftcofb_mb;
+
+void giftcofb_mb_init(giftcofb_mb* mb);
+giftcofb_job* giftcofb_mb_submit(giftcofb_mb* mb, giftcofb_job* job,
+                const u32* rkey);
+giftcofb_job* giftcofb_mb_flush(giftcofb_mb* mb);
+
+/****************************************************************************
+* Incremental GIFT-COFB (see 'encrypt.c'): the associated data and then the
+* message are passed in chunks of any sizes, with 64-bit lengths. As the
+* last block of each is processed differently, up to 16 bytes are held back
+* until the next call. 'giftcofb_stream_update' writes at most 'len + 15'
+* bytes and 'giftcofb_stream_final' at most 16 bytes, plus the tag when
+* encrypting. When decrypting, the tag is checked by 'giftcofb_stream_final'
+* only, hence the plaintext must not be used before it returns 0.
+****************************************************************************/
+typedef struct {
+    u32 rkey[80];
+    u32 offset[2];
+    u32 Y[4];
+    u8 buf[16];                 // held-back block
+    u32 buf_len;
+    u32 phase;
+    u32 emptyA;
+    int encrypting;
+} giftcofb_stream;
+
+void giftcofb_stream_init(giftcofb_stream* s, const u8* key, const u8* nonce,
+                const int encrypting);
+void giftcofb_stream_update_ad(giftcofb_stream* s, const u8* ad, u64 len);
+u64 giftcofb_stream_update(giftcofb_stream* s, u8* out, const u8* in,
+                u64 len);
+int giftcofb_stream_final(giftcofb_stream* s, u8* out, u64* out_len,
+                u8* tag);
+
+#endif // GIFTCOFB_H_
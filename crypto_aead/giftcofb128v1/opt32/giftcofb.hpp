@@ -0,0 +1,116 @@
+#ifndef GIFTCOFB_HPP_
+#define GIFTCOFB_HPP_
+
+/****************************************************************************
+* Header-only C++20 interface to GIFT-COFB (see 'giftcofb.h').
+*
+* 'gift::GiftCofb' holds the round keys of GIFTb-128, expanded once and
+* erased when it is destroyed or moved from. The member functions take
+* 'std::span's, never allocate nor throw, and directly forward to
+* 'giftcofb_crypt_rkey', hence to the GIFTb-128 backend selected at run time.
+* As required by the NIST API, inputs and outputs must not overlap.
+* The C sources of this directory have to be linked as usual.
+****************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+extern "C" {
+#include "api.h"
+#include "giftcofb.h"
+}
+
+namespace gift {
+
+class GiftCofb {
+public:
+    static constexpr std::size_t key_size = CRYPTO_KEYBYTES;
+    static constexpr std::size_t nonce_size = CRYPTO_NPUBBYTES;
+    static constexpr std::size_t tag_size = CRYPTO_ABYTES;
+
+    using Key = std::span<const std::uint8_t, key_size>;
+    using Nonce = std::span<const std::uint8_t, nonce_size>;
+    using In = std::span<const std::uint8_t>;
+    using Out = std::span<std::uint8_t>;
+
+    explicit GiftCofb(Key key) noexcept {
+        precompute_rkeys(rkey_, key.data());
+    }
+
+    // the round keys are not copied implicitly, only moved
+    GiftCofb(const GiftCofb&) = delete;
+    GiftCofb& operator=(const GiftCofb&) = delete;
+
+    GiftCofb(GiftCofb&& other) noexcept {
+        std::memcpy(rkey_, other.rkey_, sizeof(rkey_));
+        other.wipe();
+    }
+
+    GiftCofb& operator=(GiftCofb&& other) noexcept {
+        if (this != &other) {
+            std::memcpy(rkey_, other.rkey_, sizeof(rkey_));
+            other.wipe();
+        }
+        return *this;
+    }
+
+    ~GiftCofb() {
+        wipe();
+    }
+
+    void rekey(Key key) noexcept {
+        precompute_rkeys(rkey_, key.data());
+    }
+
+    /************************************************************************
+    * Writes the ciphertext followed by the tag to 'out', which must hold at
+    * least 'in.size() + tag_size' bytes. Returns false, without writing
+    * anything, if 'out' is too short or a length exceeds 32 bits.
+    ************************************************************************/
+    [[nodiscard]] bool encrypt(Out out, Nonce nonce, In ad,
+                In in) const noexcept {
+        if (!fits(ad.size()) || !fits(in.size() + tag_size) ||
+                out.size() < in.size() + tag_size)
+            return false;
+        giftcofb_crypt_rkey(out.data(), rkey_, nonce.data(), ad.data(),
+                (u32)ad.size(), in.data(), (u32)in.size(), 1);
+        return true;
+    }
+
+    /************************************************************************
+    * Decrypts 'in', made of the ciphertext followed by the tag, to 'out',
+    * which must hold at least 'in.size() - tag_size' bytes. Returns false if
+    * the tag is invalid, in which case the plaintext is erased, or if the
+    * lengths are invalid, in which case nothing is written.
+    ************************************************************************/
+    [[nodiscard]] bool decrypt(Out out, Nonce nonce, In ad,
+                In in) const noexcept {
+        if (!fits(ad.size()) || !fits(in.size()) || in.size() < tag_size ||
+                out.size() < in.size() - tag_size)
+            return false;
+        if (giftcofb_crypt_rkey(out.data(), rkey_, nonce.data(), ad.data(),
+                (u32)ad.size(), in.data(), (u32)in.size(), 0) != 0) {
+            std::memset(out.data(), 0, in.size() - tag_size);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static bool fits(std::size_t len) noexcept {
+        return len <= 0xffffffff;
+    }
+
+    void wipe() noexcept {
+        volatile u32* rkey = rkey_;
+        for (std::size_t i = 0; i < sizeof(rkey_)/sizeof(u32); i++)
+            rkey[i] = 0;
+    }
+
+    u32 rkey_[80];
+};
+
+}  // namespace gift
+
+#endif  // GIFTCOFB_HPP_
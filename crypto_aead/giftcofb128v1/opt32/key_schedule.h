@@ -67,4 +67,102 @@
 	((((x) >> 6)  & 0x03ff0000)	| (((x) & 0x003f0000) << 10) |	\
 	(((x) >> 4)  & 0x00000fff)	| (((x) & 0x0000000f) << 12))
 
+/****************************************************************************
+* Computes the 20 first fixsliced rkeys (i.e. those of the first 2 quintuples
+* of rounds) from the first 4 words 'rkey[0..3]' in the classical
+* representation.
+****************************************************************************/
+#define KEY_SCHEDULE_INIT(rkey) ({								\
+	/* classical keyschedule */									\
+	for(int i = 0; i < 16; i+=2) {								\
+		rkey[i+4] = rkey[i+1];									\
+		rkey[i+5] = KEY_UPDATE(rkey[i]);						\
+	}															\
+	/* transposition to fixsliced representations */			\
+	for(int i = 0; i < 20; i+=10) {								\
+		rkey[i] = REARRANGE_RKEY_0(rkey[i]);					\
+		rkey[i + 1] = REARRANGE_RKEY_0(rkey[i + 1]);			\
+		rkey[i + 2] = REARRANGE_RKEY_1(rkey[i + 2]);			\
+		rkey[i + 3] = REARRANGE_RKEY_1(rkey[i + 3]);			\
+		rkey[i + 4] = REARRANGE_RKEY_2(rkey[i + 4]);			\
+		rkey[i + 5] = REARRANGE_RKEY_2(rkey[i + 5]);			\
+		rkey[i + 6] = REARRANGE_RKEY_3(rkey[i + 6]);			\
+		rkey[i + 7] = REARRANGE_RKEY_3(rkey[i + 7]);			\
+	}															\
+})
+
+/****************************************************************************
+* Computes the 80 fixsliced rkeys from the first 4 words 'rkey[0..3]' in the
+* classical representation. 'rkey' can be an array of u32 as well as of GCC
+* vectors of u32 so that several keys are processed at once.
+****************************************************************************/
+#define KEY_SCHEDULE(rkey) ({									\
+	KEY_SCHEDULE_INIT(rkey);									\
+	/* keyschedule according to fixsliced representations */	\
+	for(int i = 20; i < 80; i+=10) {							\
+		rkey[i] = rkey[i-19];									\
+		rkey[i+1] = KEY_TRIPLE_UPDATE_0(rkey[i-20]);			\
+		rkey[i+2] = KEY_DOUBLE_UPDATE_1(rkey[i-17]);			\
+		rkey[i+3] = KEY_TRIPLE_UPDATE_1(rkey[i-18]);			\
+		rkey[i+4] = KEY_DOUBLE_UPDATE_2(rkey[i-15]);			\
+		rkey[i+5] = KEY_TRIPLE_UPDATE_2(rkey[i-16]);			\
+		rkey[i+6] = KEY_DOUBLE_UPDATE_3(rkey[i-13]);			\
+		rkey[i+7] = KEY_TRIPLE_UPDATE_3(rkey[i-14]);			\
+		rkey[i+8] = KEY_DOUBLE_UPDATE_4(rkey[i-11]);			\
+		rkey[i+9] = KEY_TRIPLE_UPDATE_4(rkey[i-12]);			\
+		SWAPMOVE(rkey[i], rkey[i], 0x00003333, 16);				\
+		SWAPMOVE(rkey[i], rkey[i], 0x55554444, 1);				\
+		SWAPMOVE(rkey[i+1], rkey[i+1], 0x55551100, 1);			\
+	}															\
+})
+
+/****************************************************************************
+* On-the-fly key schedule: the 10 rkeys of a quintuple only depend on those
+* of the quintuple before the previous one, hence replaces in place the rkeys
+* 'rk[0..9]' of a quintuple by those of the quintuple after the next one.
+****************************************************************************/
+#define KEY_QUINTUPLE_UPDATE(rk) ({								\
+	tmp = rk[0];												\
+	rk[0] = rk[1];												\
+	rk[1] = KEY_TRIPLE_UPDATE_0(tmp);							\
+	tmp = rk[2];												\
+	rk[2] = KEY_DOUBLE_UPDATE_1(rk[3]);							\
+	rk[3] = KEY_TRIPLE_UPDATE_1(tmp);							\
+	tmp = rk[4];												\
+	rk[4] = KEY_DOUBLE_UPDATE_2(rk[5]);							\
+	rk[5] = KEY_TRIPLE_UPDATE_2(tmp);							\
+	tmp = rk[6];												\
+	rk[6] = KEY_DOUBLE_UPDATE_3(rk[7]);							\
+	rk[7] = KEY_TRIPLE_UPDATE_3(tmp);							\
+	tmp = rk[8];												\
+	rk[8] = KEY_DOUBLE_UPDATE_4(rk[9]);							\
+	rk[9] = KEY_TRIPLE_UPDATE_4(tmp);							\
+	SWAPMOVE(rk[0], rk[0], 0x00003333, 16);						\
+	SWAPMOVE(rk[0], rk[0], 0x55554444, 1);						\
+	SWAPMOVE(rk[1], rk[1], 0x55551100, 1);						\
+})
+
+/****************************************************************************
+* Defines the function 'name' which precomputes the rkeys of N keys at once,
+* the i-th key being processed in the i-th 32-bit lane of GCC vectors so that
+* the compiler maps the key schedule onto the SIMD instructions enabled by
+* 'attr' (e.g. a 'target' attribute, or nothing for the baseline ISA).
+****************************************************************************/
+#define PRECOMPUTE_RKEYS_XN(name, N, attr)						\
+typedef u32 name##_vec __attribute__((vector_size(4*(N))));		\
+attr void name(u32 rkeys[N][80], const u8 keys[N][16]) {	\
+	name##_vec tmp, rkey[80];									\
+	/* classical initialization */								\
+	for(int l = 0; l < (N); l++) {								\
+		rkey[0][l] = LOAD32_BE(keys[l] + 12);				\
+		rkey[1][l] = LOAD32_BE(keys[l] + 4);				\
+		rkey[2][l] = LOAD32_BE(keys[l] + 8);				\
+		rkey[3][l] = LOAD32_BE(keys[l]);					\
+	}															\
+	KEY_SCHEDULE(rkey);											\
+	for(int i = 0; i < 80; i++)									\
+		for(int l = 0; l < (N); l++)							\
+			rkeys[l][i] = rkey[i][l];							\
+}
+
 #endif  // KEYSCHEDULE_H_
\ No newline at end of file
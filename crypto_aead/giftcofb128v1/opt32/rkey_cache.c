@@ -0,0 +1,75 @@
+/*******************************************************************************
+* Thread-local cache of GIFTb-128 round keys behind the stateless NIST API.
+*
+* 'crypto_aead_encrypt' and 'crypto_aead_decrypt' only receive the key, so
+* that its schedule would be computed again for every message. Each thread
+* keeps instead the round keys of its GIFTCOFB_CACHE_ENTRIES most recently
+* used keys: a key is looked up by comparing it in constant time to all the
+* cached ones, and a miss replaces the least recently used entry, whose round
+* keys are erased first. The cache is only compiled with a nonzero
+* GIFTCOFB_CACHE_ENTRIES (see 'giftcofb.h').
+*******************************************************************************/
+#include <string.h>
+#include "giftcofb.h"
+#include "secret.h"
+
+#if GIFTCOFB_CACHE_ENTRIES > 0
+
+typedef struct {
+    u32 rkey[80];
+    u8 key[16];
+    u64 last_use;               // 0 for an empty entry
+} entry_t;
+
+static __thread entry_t cache[GIFTCOFB_CACHE_ENTRIES];
+static __thread u64 use_count;
+static __thread giftcofb_cache_stats stats;
+
+/****************************************************************************
+* Returns the round keys of 'key', as computed by 'precompute_rkeys', from
+* the cache of the calling thread, computing them on a miss. The result is
+* only valid until the next call of 'giftcofb_cache_rkey' or
+* 'giftcofb_cache_clear' on the same thread.
+****************************************************************************/
+const u32* giftcofb_cache_rkey(const u8* key) {
+    u32 hit = 0, found = 0, victim = 0;
+    // all the entries are compared, without branching on their content
+    for (u32 i = 0; i < GIFTCOFB_CACHE_ENTRIES; i++) {
+        u32 eq = key_equal(cache[i].key, key) & (cache[i].last_use != 0);
+        found ^= (found ^ i) & -eq;
+        hit |= eq;
+    }
+    if (hit) {
+        stats.hits++;
+        cache[found].last_use = ++use_count;
+        return cache[found].rkey;
+    }
+    stats.misses++;
+    for (u32 i = 1; i < GIFTCOFB_CACHE_ENTRIES; i++)
+        if (cache[i].last_use < cache[victim].last_use)
+            victim = i;
+    if (cache[victim].last_use != 0)
+        stats.evictions++;
+    wipe(&cache[victim], sizeof(entry_t));
+    memcpy(cache[victim].key, key, 16);
+    precompute_rkeys(cache[victim].rkey, key);
+    cache[victim].last_use = ++use_count;
+    return cache[victim].rkey;
+}
+
+/****************************************************************************
+* Copies the counters of the calling thread to 'out'.
+****************************************************************************/
+void giftcofb_cache_get_stats(giftcofb_cache_stats* out) {
+    *out = stats;
+}
+
+/****************************************************************************
+* Erases all the keys and round keys cached by the calling thread, e.g.
+* before it exits or when keys are revoked. The counters are kept.
+****************************************************************************/
+void giftcofb_cache_clear(void) {
+    wipe(cache, sizeof(cache));
+}
+
+#endif
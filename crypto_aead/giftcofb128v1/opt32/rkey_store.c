@@ -0,0 +1,232 @@
+/*******************************************************************************
+* On-disk store of precomputed GIFTb-128 round keys.
+*
+* A store holds the round keys of many keys, each one identified by a 64-bit
+* id, in the representation used by 'giftb128' so that they can be used in
+* place once the file is mapped in memory: opening a store neither computes
+* nor copies any round keys, and all the processes mapping the same file
+* share its pages through the page cache.
+*
+* Layout (version 1), all integers in the byte order of the host that built
+* the store, which is checked when it is opened:
+*   - bytes 0-63: header (see 'header_t')
+*   - from 'index_offset' (page aligned): the 'count' ids, sorted in
+*     ascending order, as 64-bit integers
+*   - from 'rkey_offset' (page aligned): the 'count' schedules of 80 32-bit
+*     words (320 bytes, i.e. 5 cache lines), the i-th one being that of the
+*     i-th id
+* The round keys are as sensitive as the keys: the files are created with
+* permissions 0600.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "giftcofb.h"
+#include "secret.h"
+
+#define STORE_MAGIC         "GIFTRKS"
+#define STORE_VERSION       1
+#define STORE_BYTE_ORDER    0x01020304
+#define STORE_ALIGN         4096
+#define RKEY_BYTES          (80*sizeof(u32))
+#define BATCH               16          // keys expanded at once
+
+typedef struct {
+    char magic[8];
+    u32 version;
+    u32 byte_order;
+    u64 count;
+    u64 index_offset;
+    u64 rkey_offset;
+    u64 file_size;
+    u8 reserved[16];
+} header_t;
+
+typedef struct {
+    u64 id;
+    u64 pos;                    // position of the key in the input
+} entry_t;
+
+static int entry_cmp(const void* a, const void* b) {
+    u64 x = ((const entry_t*)a)->id, y = ((const entry_t*)b)->id;
+    return (x > y) - (x < y);
+}
+
+static u64 align_up(u64 x) {
+    return (x + STORE_ALIGN - 1) & ~(u64)(STORE_ALIGN - 1);
+}
+
+// writes 'len' zeros to 'f'
+static int write_zeros(FILE* f, u64 len) {
+    static const u8 zeros[STORE_ALIGN];
+    for (u64 n; len > 0; len -= n) {
+        n = (len < STORE_ALIGN) ? len : STORE_ALIGN;
+        if (fwrite(zeros, 1, n, f) != n)
+            return -1;
+    }
+    return 0;
+}
+
+static int write_store(FILE* f, const entry_t* sorted, const u8 (*keys)[16],
+                u64 n) {
+    u32 rkeys[BATCH][80];
+    u8 batch[BATCH][16];
+    header_t hdr;
+    int ret = 0;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    hdr.version = STORE_VERSION;
+    hdr.byte_order = STORE_BYTE_ORDER;
+    hdr.count = n;
+    hdr.index_offset = STORE_ALIGN;
+    hdr.rkey_offset = align_up(hdr.index_offset + n*sizeof(u64));
+    hdr.file_size = hdr.rkey_offset + n*RKEY_BYTES;
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+            write_zeros(f, hdr.index_offset - sizeof(hdr)))
+        return -1;
+    for (u64 i = 0; i < n; i++)
+        if (fwrite(&sorted[i].id, sizeof(u64), 1, f) != 1)
+            return -1;
+    if (write_zeros(f, hdr.rkey_offset - hdr.index_offset - n*sizeof(u64)))
+        return -1;
+    for (u64 i = 0; i < n && ret == 0; i += BATCH) {
+        u32 len = (n - i < BATCH) ? (u32)(n - i) : BATCH;
+        for (u32 j = 0; j < BATCH; j++)
+            memcpy(batch[j], keys[sorted[i + (j < len ? j : 0)].pos], 16);
+        precompute_rkeys_x16(rkeys, (const u8 (*)[16])batch);
+        if (fwrite(rkeys, RKEY_BYTES, len, f) != len)
+            ret = -1;
+    }
+    wipe(rkeys, sizeof(rkeys));
+    wipe(batch, sizeof(batch));
+    return ret;
+}
+
+/****************************************************************************
+* Writes to 'path' a store of the round keys of the 'n' keys 'keys', the
+* i-th one being identified by 'ids[i]'. The store is written to 'path.tmp'
+* and then renamed, so that processes opening 'path' in the meantime get
+* either the previous store or the new one. Returns -1 if two keys have the
+* same id or if the file cannot be written.
+****************************************************************************/
+int giftcofb_store_build(const char* path, const u64* ids,
+                const u8 (*keys)[16], u64 n) {
+    entry_t* sorted;
+    char* tmp_path;
+    FILE* f = NULL;
+    int fd, ret = -1;
+    sorted = malloc((n ? n : 1)*sizeof(entry_t));
+    tmp_path = malloc(strlen(path) + 5);
+    if (!sorted || !tmp_path)
+        goto out;
+    for (u64 i = 0; i < n; i++) {
+        sorted[i].id = ids[i];
+        sorted[i].pos = i;
+    }
+    qsort(sorted, n, sizeof(entry_t), entry_cmp);
+    for (u64 i = 1; i < n; i++)
+        if (sorted[i].id == sorted[i - 1].id)
+            goto out;
+    strcpy(tmp_path, path);
+    strcat(tmp_path, ".tmp");
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+        goto out;
+    f = fdopen(fd, "wb");
+    if (!f) {
+        close(fd);
+        goto unlink;
+    }
+    ret = write_store(f, sorted, keys, n);
+    if (fflush(f) || fsync(fileno(f)))
+        ret = -1;
+    if (fclose(f))
+        ret = -1;
+    if (ret == 0 && rename(tmp_path, path))
+        ret = -1;
+unlink:
+    if (ret != 0)
+        unlink(tmp_path);
+out:
+    free(sorted);
+    free(tmp_path);
+    return ret;
+}
+
+/****************************************************************************
+* Maps the store 'path' read-only into memory after checking its header.
+* Returns -1 if the file cannot be mapped, is not a store of this version or
+* was built on a host of another byte order.
+****************************************************************************/
+int giftcofb_store_open(giftcofb_store* s, const char* path) {
+    const header_t* hdr;
+    struct stat st;
+    void* map;
+    int fd;
+    memset(s, 0, sizeof(*s));
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st) || (u64)st.st_size < STORE_ALIGN) {
+        close(fd);
+        return -1;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return -1;
+    hdr = map;
+    if (memcmp(hdr->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) ||
+            hdr->version != STORE_VERSION ||
+            hdr->byte_order != STORE_BYTE_ORDER ||
+            hdr->file_size != (u64)st.st_size ||
+            hdr->count > hdr->file_size / RKEY_BYTES ||
+            hdr->index_offset % STORE_ALIGN ||
+            hdr->rkey_offset % STORE_ALIGN ||
+            hdr->index_offset < sizeof(header_t) ||
+            hdr->rkey_offset < hdr->index_offset + hdr->count*sizeof(u64) ||
+            hdr->file_size - hdr->rkey_offset != hdr->count*RKEY_BYTES) {
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+    s->map = map;
+    s->size = hdr->file_size;
+    s->count = hdr->count;
+    s->ids = (const u64*)((const u8*)map + hdr->index_offset);
+    s->rkeys = (const u32*)((const u8*)map + hdr->rkey_offset);
+    return 0;
+}
+
+/****************************************************************************
+* Returns the round keys of the key identified by 'id', to be passed to
+* 'giftcofb_crypt_rkey', or NULL if the store has no such key. The ids are
+* searched by bisection, hence the running time depends on 'id'.
+****************************************************************************/
+const u32* giftcofb_store_rkey(const giftcofb_store* s, u64 id) {
+    u64 lo = 0, hi = s->count;
+    while (lo < hi) {
+        u64 mid = lo + (hi - lo) / 2;
+        if (s->ids[mid] < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == s->count || s->ids[lo] != id)
+        return NULL;
+    return s->rkeys + lo*80;
+}
+
+/****************************************************************************
+* Unmaps the store. The round keys it returned must not be used anymore.
+****************************************************************************/
+void giftcofb_store_close(giftcofb_store* s) {
+    if (s->map)
+        munmap((void*)s->map, (size_t)s->size);
+    memset(s, 0, sizeof(*s));
+}
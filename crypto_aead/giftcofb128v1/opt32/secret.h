@@ -0,0 +1,26 @@
+#ifndef SECRET_H_
+#define SECRET_H_
+
+#include <stddef.h>
+#include <string.h>
+#include "giftb128.h"
+
+/****************************************************************************
+* Helpers shared by the sources handling keys and round keys.
+****************************************************************************/
+
+// overwrites with zeros memory the compiler cannot assume to be dead
+static inline void wipe(void* p, size_t len) {
+    memset(p, 0, len);
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+}
+
+// 1 if the 16-byte keys are equal, 0 otherwise, in constant time
+static inline u32 key_equal(const u8* a, const u8* b) {
+    u32 diff = 0;
+    for (int i = 0; i < 16; i++)
+        diff |= a[i] ^ b[i];
+    return 1 & ((diff - 1) >> 8);
+}
+
+#endif // SECRET_H_
@@ -0,0 +1,126 @@
+/*******************************************************************************
+* Tests of the C++20 wrapper 'giftcofb.hpp': the known answer test of the
+* reference implementation, round trips that reject any modified ciphertext or
+* tag, and move semantics.
+*
+* Build and run with 'make run_test_cpp && ./run_test_cpp'. The GIFTb-128
+* backend can be chosen through the 'GIFT_BACKEND' environment variable.
+*******************************************************************************/
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include "giftcofb.hpp"
+
+using gift::GiftCofb;
+
+// key, nonce, message and associated data 00 01 02... (as in the AVR
+// sketches): empty message and associated data, then 32-byte message with
+// 16 bytes of associated data
+static const u8 kat_empty[16] = {
+    0x36, 0x89, 0x65, 0x83, 0x6d, 0x36, 0x61, 0x4d,
+    0xe2, 0xfc, 0x24, 0xd0, 0xf8, 0x01, 0xb9, 0xaf
+};
+
+static const u8 kat_ctext[48] = {
+    0x3b, 0xff, 0x71, 0x5a, 0x56, 0xcb, 0xa4, 0x9d,
+    0x1f, 0x7a, 0xc0, 0x69, 0x1a, 0x96, 0x6f, 0xdc,
+    0x89, 0xb9, 0x47, 0xbc, 0x66, 0x2f, 0xa2, 0x75,
+    0x28, 0xd1, 0xac, 0x30, 0x53, 0x43, 0x03, 0x33,
+    0x2f, 0x79, 0xd0, 0x9d, 0x51, 0x86, 0x93, 0xf6,
+    0xf8, 0x13, 0xb9, 0x35, 0xd6, 0x0e, 0xf6, 0x41
+};
+
+static u8 key[GiftCofb::key_size], msg[32];
+
+/*****************************************************************************
+* Checks the known answer tests in both directions.
+*****************************************************************************/
+static int check_kat(const GiftCofb& cofb) {
+    std::span<const u8> none;
+    std::span<const u8, GiftCofb::nonce_size> nonce(key);
+    u8 out[sizeof(kat_ctext)];
+    if (!cofb.encrypt(out, nonce, none, none) ||
+            std::memcmp(out, kat_empty, sizeof(kat_empty)) != 0)
+        return -1;
+    if (!cofb.decrypt(std::span<u8>(), nonce, none, kat_empty))
+        return -1;
+    if (!cofb.encrypt(out, nonce, std::span(msg).first(16), msg) ||
+            std::memcmp(out, kat_ctext, sizeof(kat_ctext)) != 0)
+        return -1;
+    std::memset(out, 0, sizeof(out));
+    if (!cofb.decrypt(out, nonce, std::span(msg).first(16), kat_ctext) ||
+            std::memcmp(out, msg, sizeof(msg)) != 0)
+        return -1;
+    return 0;
+}
+
+/*****************************************************************************
+* Checks that flipping any bit of the ciphertext or of the tag makes the
+* decryption fail and erase the plaintext, and that outputs that are too
+* short are rejected without anything being written.
+*****************************************************************************/
+static int check_tamper(const GiftCofb& cofb) {
+    std::span<const u8, GiftCofb::nonce_size> nonce(key);
+    std::span<const u8> ad = std::span(msg).first(16);
+    u8 ctext[sizeof(kat_ctext)], out[sizeof(msg)];
+    for (u32 i = 0; i < 8*sizeof(ctext); i++) {
+        std::memcpy(ctext, kat_ctext, sizeof(ctext));
+        ctext[i / 8] ^= (u8)(1 << (i % 8));
+        std::memset(out, 0xff, sizeof(out));
+        if (cofb.decrypt(out, nonce, ad, ctext))
+            return -1;
+        for (u32 j = 0; j < sizeof(out); j++)
+            if (out[j] != 0)
+                return -1;
+    }
+    std::memset(out, 0xff, sizeof(out));
+    if (cofb.encrypt(std::span(ctext).first(sizeof(ctext) - 1), nonce, ad,
+            msg) ||
+            cofb.decrypt(std::span(out).first(sizeof(out) - 1), nonce, ad,
+            kat_ctext) ||
+            cofb.decrypt(out, nonce, ad, std::span(kat_ctext).first(15)))
+        return -1;
+    for (u32 j = 0; j < sizeof(out); j++)
+        if (out[j] != 0xff)
+            return -1;
+    return 0;
+}
+
+/*****************************************************************************
+* Checks that moved-to objects hold the round keys of the moved-from ones.
+*****************************************************************************/
+static int check_move(void) {
+    u8 other_key[GiftCofb::key_size] = {0};
+    GiftCofb a(key);
+    GiftCofb b(std::move(a));
+    if (check_kat(b) != 0)
+        return -1;
+    GiftCofb c(other_key);
+    c = std::move(b);
+    if (check_kat(c) != 0)
+        return -1;
+    // a moved-from object can be rekeyed
+    a.rekey(key);
+    return check_kat(a);
+}
+
+int main() {
+    for (int i = 0; i < 32; i++)
+        msg[i] = (u8)i;
+    std::memcpy(key, msg, sizeof(key));
+    GiftCofb cofb(key);
+    if (check_kat(cofb) != 0) {
+        std::printf("Known answer test failed! :(\n");
+        return -1;
+    }
+    if (check_tamper(cofb) != 0) {
+        std::printf("Modified ciphertexts or tags not rejected! :(\n");
+        return -1;
+    }
+    if (check_move() != 0) {
+        std::printf("Move semantics failed! :(\n");
+        return -1;
+    }
+    std::printf("All C++ tests have passed successfully! :)\n");
+    return 0;
+}
@@ -0,0 +1,510 @@
+/*******************************************************************************
+* Tests of the GIFT-COFB 'opt32' implementation: the known answer test of the
+* reference implementation, then every entry point of 'giftcofb.h' against
+* 'giftcofb_crypt' on messages of pseudorandom lengths and contents.
+*
+* Build and run with 'make && ./run_test_vectors'. The GIFTb-128 backend can
+* be chosen through the 'GIFT_BACKEND' environment variable. The Makefile
+* enables the round key cache, which is only tested if GIFTCOFB_CACHE_ENTRIES
+* is nonzero.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "api.h"
+#include "giftcofb.h"
+
+int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
+                const unsigned char* m, unsigned long long mlen,
+                const unsigned char* ad, unsigned long long adlen,
+                const unsigned char* nsec, const unsigned char* npub,
+                const unsigned char* k);
+int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                unsigned char* nsec, const unsigned char* c,
+                unsigned long long clen, const unsigned char* ad,
+                unsigned long long adlen, const unsigned char* npub,
+                const unsigned char* k);
+
+#define MAX_AD_LEN      80
+#define MAX_MSG_LEN     200
+
+// key, nonce, message and associated data 00 01 02... (as in the AVR
+// sketches): empty message and associated data, then 32-byte message with
+// 16 bytes of associated data
+static const u8 kat_empty[16] = {
+    0x36, 0x89, 0x65, 0x83, 0x6d, 0x36, 0x61, 0x4d,
+    0xe2, 0xfc, 0x24, 0xd0, 0xf8, 0x01, 0xb9, 0xaf
+};
+
+static const u8 kat_ctext[48] = {
+    0x3b, 0xff, 0x71, 0x5a, 0x56, 0xcb, 0xa4, 0x9d,
+    0x1f, 0x7a, 0xc0, 0x69, 0x1a, 0x96, 0x6f, 0xdc,
+    0x89, 0xb9, 0x47, 0xbc, 0x66, 0x2f, 0xa2, 0x75,
+    0x28, 0xd1, 0xac, 0x30, 0x53, 0x43, 0x03, 0x33,
+    0x2f, 0x79, 0xd0, 0x9d, 0x51, 0x86, 0x93, 0xf6,
+    0xf8, 0x13, 0xb9, 0x35, 0xd6, 0x0e, 0xf6, 0x41
+};
+
+static u64 prng_state = 0x0123456789abcdefULL;
+
+// xorshift64* generator, so that the tests are reproducible
+static u32 prng(void) {
+    prng_state ^= prng_state >> 12;
+    prng_state ^= prng_state << 25;
+    prng_state ^= prng_state >> 27;
+    return (u32)((prng_state * 0x2545f4914f6cdd1dULL) >> 32);
+}
+
+static void fill(u8* p, u32 len) {
+    for (u32 i = 0; i < len; i++)
+        p[i] = (u8)prng();
+}
+
+/*****************************************************************************
+* Checks the known answer tests with the NIST API and all the single-message
+* functions, and that a modified ciphertext is rejected.
+*****************************************************************************/
+static int check_kat(void) {
+    u8 key[16], msg[32], out[48];
+    u32 rkey[80];
+    unsigned long long len;
+    int ret = 0;
+    for (int i = 0; i < 32; i++)
+        msg[i] = (u8)i;
+    memcpy(key, msg, 16);
+    precompute_rkeys(rkey, key);
+    ret |= crypto_aead_encrypt(out, &len, msg, 0, key, 0, NULL, key, key);
+    ret |= (len != 16) | memcmp(out, kat_empty, 16);
+    ret |= crypto_aead_decrypt(out, &len, NULL, kat_empty, 16, key, 0, key,
+        key);
+    ret |= (len != 0);
+    ret |= crypto_aead_encrypt(out, &len, msg, 32, key, 16, NULL, key, key);
+    ret |= (len != 48) | memcmp(out, kat_ctext, 48);
+    ret |= crypto_aead_decrypt(out, &len, NULL, kat_ctext, 48, key, 16, key,
+        key);
+    ret |= (len != 32) | memcmp(out, msg, 32);
+    ret |= giftcofb_crypt(out, key, key, key, 16, msg, 32, 1);
+    ret |= memcmp(out, kat_ctext, 48);
+    ret |= giftcofb_crypt_rkey(out, rkey, key, key, 16, msg, 32, 1);
+    ret |= memcmp(out, kat_ctext, 48);
+    ret |= giftcofb_crypt_otf(out, key, key, key, 16, msg, 32, 1);
+    ret |= memcmp(out, kat_ctext, 48);
+    ret |= giftcofb_crypt_otf(out, key, key, key, 16, kat_ctext, 48, 0);
+    ret |= memcmp(out, msg, 32);
+    memcpy(out, kat_ctext, 48);
+    out[40] ^= 0x01;
+    ret |= (giftcofb_crypt(msg, key, key, key, 16, out, 48, 0) == 0);
+    ret |= (crypto_aead_decrypt(msg, &len, NULL, out, 48, key, 16, key,
+        key) == 0);
+    return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Checks 'giftcofb_crypt_x4' and 'giftcofb_crypt_x4_rkey' against
+* 'giftcofb_crypt' for all lengths up to 2 blocks and pseudorandom longer
+* ones, and that decryption reports exactly the lanes whose ciphertext was
+* modified, the plaintexts of the other lanes being correct.
+*****************************************************************************/
+static int check_x4(void) {
+    u8 key[4][16], nonce[4][16], ad[4][MAX_AD_LEN], msg[4][MAX_MSG_LEN];
+    u8 ct[4][MAX_MSG_LEN + 16], pt[4][MAX_MSG_LEN + 16];
+    u8 ref[MAX_MSG_LEN + 16];
+    u32 rkey[80], rkeys[4*80];
+    const u8 *k[4], *n[4], *a[4], *m[4], *c[4];
+    u8 *o[4], *p[4];
+    int ret = 0;
+    for (int j = 0; j < 4; j++) {
+        k[j] = key[j];
+        n[j] = nonce[j];
+        a[j] = ad[j];
+        m[j] = msg[j];
+        c[j] = ct[j];
+        o[j] = ct[j];
+        p[j] = pt[j];
+    }
+    for (u32 t = 0; t < 33*33 + 200; t++) {
+        u32 ad_len = (t < 33*33) ? t / 33 : prng() % (MAX_AD_LEN + 1);
+        u32 msg_len = (t < 33*33) ? t % 33 : prng() % (MAX_MSG_LEN + 1);
+        u32 tampered = t % 16;
+        for (int j = 0; j < 4; j++) {
+            fill(key[j], 16);
+            fill(nonce[j], 16);
+            fill(ad[j], ad_len);
+            fill(msg[j], msg_len);
+            precompute_rkeys(rkey, key[j]);
+            for (int i = 0; i < 80; i++)
+                rkeys[4*i + j] = rkey[i];
+        }
+        if (t & 1)
+            ret |= giftcofb_crypt_x4_rkey(o, rkeys, n, a, ad_len, m,
+                msg_len, 1);
+        else
+            ret |= giftcofb_crypt_x4(o, k, n, a, ad_len, m, msg_len, 1);
+        for (int j = 0; j < 4; j++) {
+            giftcofb_crypt(ref, key[j], nonce[j], ad[j], ad_len, msg[j],
+                msg_len, 1);
+            ret |= memcmp(ct[j], ref, msg_len + 16);
+            if ((tampered >> j) & 1)
+                ct[j][prng() % (msg_len + 16)] ^= 1 << (prng() % 8);
+        }
+        if (t & 1)
+            ret |= (giftcofb_crypt_x4_rkey(p, rkeys, n, a, ad_len, c,
+                msg_len + 16, 0) != (int)tampered);
+        else
+            ret |= (giftcofb_crypt_x4(p, k, n, a, ad_len, c, msg_len + 16,
+                0) != (int)tampered);
+        for (int j = 0; j < 4; j++)
+            if (!((tampered >> j) & 1))
+                ret |= memcmp(pt[j], msg[j], msg_len);
+    }
+    return ret ? -1 : 0;
+}
+
+#define BATCH_JOBS      150
+
+static u8 job_key[BATCH_JOBS][16], job_nonce[BATCH_JOBS][16];
+static u8 job_ad[BATCH_JOBS][MAX_AD_LEN], job_msg[BATCH_JOBS][MAX_MSG_LEN];
+static u8 job_ref[BATCH_JOBS][MAX_MSG_LEN + 16];
+static u8 job_out[BATCH_JOBS][MAX_MSG_LEN + 16];
+
+/*****************************************************************************
+* Fills 'n' jobs of pseudorandom lengths and directions under 'nkeys'
+* distinct keys, computing their expected outputs with 'giftcofb_crypt'. The
+* inputs of the decryptions are the ciphertexts, modified for the jobs 'j'
+* such that 'j % 7 == 3', which are counted in 'tampered'.
+*****************************************************************************/
+static void make_jobs(giftcofb_job* jobs, u32 n, u32 nkeys, u32* tampered) {
+    *tampered = 0;
+    fill(job_key[0], nkeys*16);
+    for (u32 j = 0; j < n; j++) {
+        giftcofb_job* job = &jobs[j];
+        u32 msg_len = prng() % (MAX_MSG_LEN + 1);
+        job->key = job_key[prng() % nkeys];
+        job->nonce = job_nonce[j];
+        job->ad = job_ad[j];
+        job->ad_len = prng() % (MAX_AD_LEN + 1);
+        job->encrypting = prng() & 1;
+        job->verdict = 7;
+        fill(job_nonce[j], 16);
+        fill(job_ad[j], job->ad_len);
+        fill(job_msg[j], msg_len);
+        giftcofb_crypt(job_ref[j], job->key, job->nonce, job->ad,
+            job->ad_len, job_msg[j], msg_len, 1);
+        job->in_len = msg_len;
+        job->in = job_msg[j];
+        if (!job->encrypting) {
+            // decryption in place of the ciphertext
+            memcpy(job_out[j], job_ref[j], msg_len + 16);
+            memcpy(job_ref[j], job_msg[j], msg_len);
+            job->in_len = msg_len + 16;
+            job->in = job_out[j];
+            if (j % 7 == 3) {
+                job_out[j][prng() % (msg_len + 16)] ^= 0x80;
+                (*tampered)++;
+            }
+        }
+        job->out = job_out[j];
+    }
+}
+
+// checks the outputs and verdicts of the jobs filled by 'make_jobs'
+static int check_jobs(const giftcofb_job* jobs, u32 n) {
+    int ret = 0;
+    for (u32 j = 0; j < n; j++) {
+        const giftcofb_job* job = &jobs[j];
+        int tampered = !job->encrypting && j % 7 == 3;
+        ret |= (job->verdict != 0) != tampered;
+        if (job->encrypting)
+            ret |= memcmp(job_out[j], job_ref[j], job->in_len + 16);
+        else if (!tampered)
+            ret |= memcmp(job_out[j], job_ref[j], job->in_len - 16);
+    }
+    return ret;
+}
+
+/*****************************************************************************
+* Checks 'giftcofb_batch_submit' against 'giftcofb_crypt' on batches of
+* encryptions and decryptions of pseudorandom lengths, under few keys
+* (grouped by pairwise search) or many (grouped by sorting), including
+* modified ciphertexts and an arena too small.
+*****************************************************************************/
+static int check_batch(void) {
+    static giftcofb_job jobs[BATCH_JOBS];
+    static u8 arena[BATCH_JOBS*512];
+    static const u32 nkeys[] = {1, 5, 32, 33, 100, BATCH_JOBS};
+    u32 tampered;
+    int ret = 0;
+    if (giftcofb_batch_arena_size(BATCH_JOBS) > sizeof(arena))
+        return -1;
+    for (u32 t = 0; t < sizeof(nkeys) / sizeof(nkeys[0]); t++) {
+        for (u32 n = 1; n <= BATCH_JOBS; n += BATCH_JOBS / 2) {
+            make_jobs(jobs, n, nkeys[t] < n ? nkeys[t] : n, &tampered);
+            ret |= (giftcofb_batch_submit(jobs, n, arena + t,
+                giftcofb_batch_arena_size(n)) != (int)tampered);
+            ret |= check_jobs(jobs, n);
+        }
+    }
+    make_jobs(jobs, BATCH_JOBS, 3, &tampered);
+    ret |= (giftcofb_batch_submit(jobs, BATCH_JOBS, arena,
+        giftcofb_batch_arena_size(BATCH_JOBS) - 1) != -1);
+    ret |= (jobs[0].verdict != 7);
+    ret |= giftcofb_batch_submit(jobs, 0, arena, sizeof(arena));
+    return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Checks the multi-buffer manager against 'giftcofb_crypt' on jobs of mixed
+* lengths and directions (so that lanes are refilled at different times),
+* with one call of 'giftcofb_mb_flush' after each submission or only at the
+* end, and that every job is returned exactly once.
+*****************************************************************************/
+static int check_mb(void) {
+    static giftcofb_job jobs[BATCH_JOBS];
+    static u32 rkey[BATCH_JOBS][80];
+    u32 returned[BATCH_JOBS], tampered;
+    giftcofb_job* done;
+    giftcofb_mb mb;
+    int ret = 0;
+    for (int interleaved = 0; interleaved < 2; interleaved++) {
+        make_jobs(jobs, BATCH_JOBS, 7, &tampered);
+        memset(returned, 0, sizeof(returned));
+        for (u32 j = 0; j < BATCH_JOBS; j++)
+            precompute_rkeys(rkey[j], jobs[j].key);
+        giftcofb_mb_init(&mb);
+        for (u32 j = 0; j < BATCH_JOBS; j++) {
+            done = giftcofb_mb_submit(&mb, &jobs[j], rkey[j]);
+            if (done)
+                returned[done - jobs]++;
+            if (interleaved && j % 5 == 4 && (done = giftcofb_mb_flush(&mb)))
+                returned[done - jobs]++;
+        }
+        while ((done = giftcofb_mb_flush(&mb)))
+            returned[done - jobs]++;
+        for (u32 j = 0; j < BATCH_JOBS; j++)
+            ret |= (returned[j] != 1);
+        ret |= check_jobs(jobs, BATCH_JOBS);
+        ret |= (giftcofb_mb_flush(&mb) != NULL);
+    }
+    // a ciphertext shorter than the tag is rejected at once
+    jobs[0].encrypting = 0;
+    jobs[0].in_len = 15;
+    giftcofb_mb_init(&mb);
+    ret |= (giftcofb_mb_submit(&mb, &jobs[0], rkey[0]) != &jobs[0]);
+    ret |= (jobs[0].verdict != -1) | (giftcofb_mb_flush(&mb) != NULL);
+    return ret ? -1 : 0;
+}
+
+// pseudorandom chunk size, possibly 0, at most 'left'
+static u32 chunk_size(u32 left) {
+    u32 r = prng() % 8;
+    u32 len = (r == 0) ? 0 : (r < 6) ? prng() % 20 : prng() % 70;
+    return (len < left) ? len : left;
+}
+
+/*****************************************************************************
+* Checks the incremental GIFT-COFB against 'giftcofb_crypt' with the
+* associated data and the message passed in chunks of pseudorandom sizes
+* (including empty and block-aligned ones), in both directions, and that
+* a modified tag is rejected.
+*****************************************************************************/
+static int check_stream(void) {
+    u8 key[16], nonce[16], ad[MAX_AD_LEN], msg[MAX_MSG_LEN];
+    u8 ref[MAX_MSG_LEN + 16], out[MAX_MSG_LEN + 16], tag[16];
+    giftcofb_stream st;
+    u64 written, last;
+    int ret = 0;
+    for (u32 t = 0; t < 2000; t++) {
+        u32 ad_len = (t < 100) ? 16*(t % 4) : prng() % (MAX_AD_LEN + 1);
+        u32 msg_len = (t < 100) ? 16*(t / 4 % 4) : prng() % (MAX_MSG_LEN + 1);
+        fill(key, 16);
+        fill(nonce, 16);
+        fill(ad, ad_len);
+        fill(msg, msg_len);
+        giftcofb_crypt(ref, key, nonce, ad, ad_len, msg, msg_len, 1);
+        for (int encrypting = 1; encrypting >= 0; encrypting--) {
+            const u8* in = encrypting ? msg : ref;
+            memset(out, 0, sizeof(out));
+            giftcofb_stream_init(&st, key, nonce, encrypting);
+            for (u32 off = 0, n; off < ad_len; off += n) {
+                n = chunk_size(ad_len - off);
+                giftcofb_stream_update_ad(&st, ad + off, n);
+            }
+            written = 0;
+            for (u32 off = 0, n; off < msg_len; off += n) {
+                n = chunk_size(msg_len - off);
+                written += giftcofb_stream_update(&st, out + written,
+                    in + off, n);
+            }
+            if (encrypting) {
+                ret |= giftcofb_stream_final(&st, out + written, &last, tag);
+                ret |= memcmp(tag, ref + msg_len, 16);
+                ret |= memcmp(out, ref, msg_len);
+            }
+            else {
+                memcpy(tag, ref + msg_len, 16);
+                tag[t % 16] ^= (t & 1) << (t % 8);
+                ret |= (giftcofb_stream_final(&st, out + written, &last,
+                    tag) != 0) != (t & 1);
+                ret |= memcmp(out, msg, msg_len);
+            }
+            ret |= (written + last != msg_len);
+        }
+    }
+    return ret ? -1 : 0;
+}
+
+#define STORE_KEYS      1000
+#define STORE_PATH      "test_store.rks"
+
+/*****************************************************************************
+* Checks that the round keys of a store built from keys with unordered ids
+* match 'precompute_rkeys', are aligned on cache lines and give the same
+* results as 'giftcofb_crypt', that unknown ids are not found, and that
+* duplicate ids, empty stores and corrupted headers are handled.
+*****************************************************************************/
+static int check_store(void) {
+    static u8 key[STORE_KEYS][16];
+    static u64 id[STORE_KEYS];
+    u8 nonce[16], msg[64], out[80], ref[80];
+    u32 rkey[80];
+    const u32* stored;
+    giftcofb_store s;
+    FILE* f;
+    int ret = 0;
+    fill(key[0], sizeof(key));
+    for (u32 i = 0; i < STORE_KEYS; i++)
+        id[i] = (u64)(STORE_KEYS - i)*0x9e3779b97f4a7c15ULL;
+    if (giftcofb_store_build(STORE_PATH, id, (const u8 (*)[16])key,
+            STORE_KEYS) || giftcofb_store_open(&s, STORE_PATH))
+        return -1;
+    ret |= (s.count != STORE_KEYS);
+    for (u32 i = 0; i < STORE_KEYS; i++) {
+        stored = giftcofb_store_rkey(&s, id[i]);
+        if (!stored)
+            return -1;
+        precompute_rkeys(rkey, key[i]);
+        ret |= memcmp(stored, rkey, sizeof(rkey)) | ((size_t)stored & 63);
+        if (i % 50 == 0) {
+            fill(nonce, 16);
+            fill(msg, 64);
+            giftcofb_crypt(ref, key[i], nonce, msg, i % 17, msg, 64, 1);
+            giftcofb_crypt_rkey(out, stored, nonce, msg, i % 17, msg, 64, 1);
+            ret |= memcmp(out, ref, 80);
+        }
+    }
+    ret |= (giftcofb_store_rkey(&s, 1) != NULL);
+    ret |= (giftcofb_store_rkey(&s, ~(u64)0) != NULL);
+    giftcofb_store_close(&s);
+    id[5] = id[6];
+    ret |= (giftcofb_store_build(STORE_PATH, id, (const u8 (*)[16])key,
+        STORE_KEYS) != -1);
+    ret |= giftcofb_store_build(STORE_PATH, id, (const u8 (*)[16])key, 0);
+    ret |= giftcofb_store_open(&s, STORE_PATH);
+    ret |= (s.count != 0) | (giftcofb_store_rkey(&s, id[0]) != NULL);
+    giftcofb_store_close(&s);
+    f = fopen(STORE_PATH, "r+b");
+    if (!f)
+        return -1;
+    fseek(f, 8, SEEK_SET);              // version
+    fputc(0xff, f);
+    fclose(f);
+    ret |= (giftcofb_store_open(&s, STORE_PATH) != -1);
+    ret |= (giftcofb_store_open(&s, "missing_store.rks") != -1);
+    remove(STORE_PATH);
+    return ret ? -1 : 0;
+}
+
+#if GIFTCOFB_CACHE_ENTRIES > 0
+#define CACHE_KEYS      (GIFTCOFB_CACHE_ENTRIES + 4)
+
+// looks up 'key' and checks its round keys and the change of the counters
+static int cache_lookup(const u8* key, u64 hits, u64 misses, u64 evictions) {
+    giftcofb_cache_stats before, after;
+    u32 rkey[80];
+    const u32* cached;
+    giftcofb_cache_get_stats(&before);
+    cached = giftcofb_cache_rkey(key);
+    giftcofb_cache_get_stats(&after);
+    precompute_rkeys(rkey, key);
+    return memcmp(cached, rkey, sizeof(rkey)) ||
+        after.hits - before.hits != hits ||
+        after.misses - before.misses != misses ||
+        after.evictions - before.evictions != evictions;
+}
+
+/*****************************************************************************
+* Checks the hit/miss/eviction counters of the round key cache on a known
+* sequence of keys (the least recently used entry being evicted), and that
+* the NIST API gives the same results as 'giftcofb_crypt' through it.
+*****************************************************************************/
+static int check_cache(void) {
+    u8 key[CACHE_KEYS][16], nonce[16], ad[MAX_AD_LEN], msg[MAX_MSG_LEN];
+    u8 out[MAX_MSG_LEN + 16], ref[MAX_MSG_LEN + 16];
+    unsigned long long len;
+    int ret = 0;
+    fill(key[0], sizeof(key));
+    giftcofb_cache_clear();
+    for (int i = 0; i < GIFTCOFB_CACHE_ENTRIES; i++)
+        ret |= cache_lookup(key[i], 0, 1, 0);
+    for (int i = GIFTCOFB_CACHE_ENTRIES - 1; i >= 0; i--)
+        ret |= cache_lookup(key[i], 1, 0, 0);
+    // key[GIFTCOFB_CACHE_ENTRIES - 1] is now the least recently used
+    ret |= cache_lookup(key[GIFTCOFB_CACHE_ENTRIES], 0, 1, 1);
+    ret |= cache_lookup(key[0], 1, 0, 0);
+    ret |= cache_lookup(key[GIFTCOFB_CACHE_ENTRIES - 1], 0, 1, 1);
+    ret |= cache_lookup(key[GIFTCOFB_CACHE_ENTRIES], 1, 0, 0);
+    giftcofb_cache_clear();
+    ret |= cache_lookup(key[0], 0, 1, 0);
+    for (int t = 0; t < 500; t++) {
+        u32 k = prng() % CACHE_KEYS;
+        u32 ad_len = prng() % (MAX_AD_LEN + 1);
+        u32 msg_len = prng() % (MAX_MSG_LEN + 1);
+        fill(nonce, 16);
+        fill(ad, ad_len);
+        fill(msg, msg_len);
+        giftcofb_crypt(ref, key[k], nonce, ad, ad_len, msg, msg_len, 1);
+        crypto_aead_encrypt(out, &len, msg, msg_len, ad, ad_len, NULL, nonce,
+            key[k]);
+        ret |= (len != msg_len + 16) | memcmp(out, ref, msg_len + 16);
+        ret |= crypto_aead_decrypt(out, &len, NULL, ref, msg_len + 16, ad,
+            ad_len, nonce, key[k]);
+        ret |= (len != msg_len) | memcmp(out, msg, msg_len);
+    }
+    giftcofb_cache_clear();
+    return ret ? -1 : 0;
+}
+#endif
+
+int main() {
+    if (check_kat() != 0) {
+        printf("Known answer test failed! :(\n");
+        return -1;
+    }
+    if (check_x4() != 0) {
+        printf("4-message GIFT-COFB failed! :(\n");
+        return -1;
+    }
+    if (check_batch() != 0) {
+        printf("Batched GIFT-COFB failed! :(\n");
+        return -1;
+    }
+    if (check_mb() != 0) {
+        printf("Multi-buffer GIFT-COFB failed! :(\n");
+        return -1;
+    }
+    if (check_stream() != 0) {
+        printf("Incremental GIFT-COFB failed! :(\n");
+        return -1;
+    }
+    if (check_store() != 0) {
+        printf("Round key store failed! :(\n");
+        return -1;
+    }
+#if GIFTCOFB_CACHE_ENTRIES > 0
+    if (check_cache() != 0) {
+        printf("Round key cache failed! :(\n");
+        return -1;
+    }
+#endif
+    printf("All tests have passed successfully! :)\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*******************************************************************************
+* Command-line builder of round key stores (see 'rkey_store.c').
+*
+* Usage:
+*   ./rkey_store build STORE [FILE]
+*       builds STORE from the lines "ID KEY" of FILE (by default, the standard
+*       input), ID being a 64-bit integer (decimal, or hex with a 0x prefix)
+*       and KEY 32 hex digits
+*   ./rkey_store info STORE
+*       checks STORE and prints its number of keys and the time to open it
+*   ./rkey_store bench N STORE
+*       builds STORE from N random keys and compares the time to open it and
+*       to look up all its keys with the time to run their key schedules
+*
+* Build with 'make', from the sources of '../opt32'. This tool is kept out
+* of that directory so that the NIST harness, which compiles all of its
+* '.c' files, does not find a second 'main'.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "giftcofb.h"
+
+static int parse_hex(u8* out, const char* s, u32 len) {
+    unsigned int byte;
+    if (strlen(s) != 2*len)
+        return -1;
+    for (u32 i = 0; i < len; i++) {
+        if (sscanf(s + 2*i, "%2x", &byte) != 1)
+            return -1;
+        out[i] = (u8)byte;
+    }
+    return 0;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// doubles the capacity of the arrays, erasing the keys from the old one
+static int grow(u64** ids, u8 (**keys)[16], u64 n, u64* cap) {
+    u64 new_cap = *cap ? 2 * *cap : 1024;
+    u64* new_ids = realloc(*ids, new_cap*sizeof(u64));
+    u8 (*new_keys)[16];
+    if (!new_ids)
+        return -1;
+    *ids = new_ids;
+    new_keys = malloc(new_cap*16);
+    if (!new_keys)
+        return -1;
+    if (*keys) {
+        memcpy(new_keys, *keys, n*16);
+        memset(*keys, 0, n*16);
+        free(*keys);
+    }
+    *keys = new_keys;
+    *cap = new_cap;
+    return 0;
+}
+
+static int build(const char* path, FILE* in) {
+    char line[256], id_str[64], key_str[64];
+    u64 n = 0, cap = 0, *ids = NULL;
+    u8 (*keys)[16] = NULL;
+    int ret = 1;
+    while (fgets(line, sizeof(line), in)) {
+        if (sscanf(line, "%63s %63s", id_str, key_str) != 2)
+            continue;
+        if (n == cap && grow(&ids, &keys, n, &cap)) {
+            fprintf(stderr, "out of memory\n");
+            goto out;
+        }
+        ids[n] = strtoull(id_str, NULL, 0);
+        if (parse_hex(keys[n], key_str, 16)) {
+            fprintf(stderr, "invalid key for id %s\n", id_str);
+            goto out;
+        }
+        n++;
+    }
+    if (giftcofb_store_build(path, ids, (const u8 (*)[16])keys, n)) {
+        fprintf(stderr, "cannot write %s (or duplicate ids)\n", path);
+        goto out;
+    }
+    printf("%llu keys written to %s\n", n, path);
+    ret = 0;
+out:
+    if (keys)
+        memset(keys, 0, cap*16);
+    free(keys);
+    free(ids);
+    memset(line, 0, sizeof(line));
+    memset(key_str, 0, sizeof(key_str));
+    return ret;
+}
+
+static int info(const char* path) {
+    giftcofb_store s;
+    double t = now();
+    if (giftcofb_store_open(&s, path)) {
+        fprintf(stderr, "%s is not a valid store\n", path);
+        return 1;
+    }
+    t = now() - t;
+    printf("%s: %llu keys, %llu bytes, opened in %.1f us\n", path, s.count,
+        s.size, t*1e6);
+    giftcofb_store_close(&s);
+    return 0;
+}
+
+static int bench(u64 n, const char* path) {
+    giftcofb_store s;
+    u32 rkey[80];
+    u64* ids = malloc(n*sizeof(u64));
+    u8 (*keys)[16] = malloc(n*16);
+    u64 x = (u64)time(NULL), found = 0;
+    double t_schedule, t_open, t_lookup;
+    int ret = 1;
+    if (!ids || !keys)
+        goto out;
+    for (u64 i = 0; i < n; i++) {
+        ids[i] = i*0x9e3779b97f4a7c15ULL;
+        for (int j = 0; j < 16; j++) {
+            x = x*6364136223846793005ULL + 1442695040888963407ULL;
+            keys[i][j] = (u8)(x >> 56);
+        }
+    }
+    if (giftcofb_store_build(path, ids, (const u8 (*)[16])keys, n)) {
+        fprintf(stderr, "cannot write %s\n", path);
+        goto out;
+    }
+    t_schedule = now();
+    for (u64 i = 0; i < n; i++) {
+        precompute_rkeys(rkey, keys[i]);
+        __asm__ __volatile__("" : : "r"(rkey) : "memory");
+    }
+    t_schedule = now() - t_schedule;
+    t_open = now();
+    if (giftcofb_store_open(&s, path))
+        goto out;
+    t_open = now() - t_open;
+    t_lookup = now();
+    for (u64 i = 0; i < n; i++)
+        found += giftcofb_store_rkey(&s, ids[i]) != NULL;
+    t_lookup = now() - t_lookup;
+    giftcofb_store_close(&s);
+    printf("%llu keys: key schedules %.3f s, open %.1f us, "
+        "lookups %.3f s (%llu found)\n", n, t_schedule, t_open*1e6,
+        t_lookup, found);
+    ret = found != n;
+out:
+    free(ids);
+    free(keys);
+    return ret;
+}
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    int ret;
+    if (argc >= 3 && argc <= 4 && !strcmp(argv[1], "build")) {
+        if (argc == 4 && !(in = fopen(argv[3], "r"))) {
+            fprintf(stderr, "cannot read %s\n", argv[3]);
+            return 1;
+        }
+        ret = build(argv[2], in);
+        if (in != stdin)
+            fclose(in);
+        return ret;
+    }
+    if (argc == 3 && !strcmp(argv[1], "info"))
+        return info(argv[2]);
+    if (argc == 4 && !strcmp(argv[1], "bench"))
+        return bench(strtoull(argv[2], NULL, 0), argv[3]);
+    fprintf(stderr, "usage: %s build STORE [FILE] | info STORE | "
+        "bench N STORE\n", argv[0]);
+    return 1;
+}
@@ -0,0 +1,115 @@
+#ifndef GIFT128_BACKEND_H_
+#define GIFT128_BACKEND_H_
+
+#include "encrypt.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GIFT128_BMI2
+#define GIFT128_AVX2
+#define GIFT128_AVX512
+#endif
+
+#if defined(__GNUC__) && defined(__aarch64__)
+#define GIFT128_NEON
+#endif
+
+/****************************************************************************
+* Processes 'nblocks' consecutive 128-bit blocks with the fixsliced round
+* keys 'rkey'.
+****************************************************************************/
+typedef void (*bulk_fn)(u8* out, const u8* in, u32 nblocks, const u32* rkey);
+
+/****************************************************************************
+* Precomputes the fixsliced round keys of several keys at once.
+****************************************************************************/
+typedef void (*rkeys_fn)(u32 (*rkeys)[80], const u8 (*keys)[KEY_SIZE]);
+
+/****************************************************************************
+* Precomputes the round keys of GIFT128_LANES keys at once, interleaved as in
+* 'gift128_multikey_ctx'.
+****************************************************************************/
+typedef void (*mkeys_fn)(u32* rkeys, const u8 (*keys)[KEY_SIZE]);
+
+/****************************************************************************
+* Same as 'bulk_fn' for the rounds 'start' to 'end - 1' only (see
+* 'gift128_encrypt_rounds').
+****************************************************************************/
+typedef void (*rounds_fn)(u8* out, const u8* in, u32 nblocks, const u32* rkey,
+			u32 start, u32 end);
+
+/****************************************************************************
+* An implementation of GIFT-128/GIFTb-128 for the host processor. The bulk
+* functions accept any number of blocks, including incomplete batches.
+****************************************************************************/
+typedef struct {
+	const char* name;
+	int (*supported)(void);
+	bulk_fn gift128_encrypt;
+	bulk_fn gift128_decrypt;
+	bulk_fn giftb128_encrypt;
+	bulk_fn giftb128_decrypt;
+	rkeys_fn precompute_rkeys_x8;
+	rkeys_fn precompute_rkeys_x16;
+	// at most GIFT128_LANES blocks with lane-interleaved round keys
+	mkeys_fn precompute_multikey_rkeys;
+	bulk_fn gift128_encrypt_multikey;
+	bulk_fn gift128_decrypt_multikey;
+	rounds_fn gift128_encrypt_rounds;
+	rounds_fn gift128_decrypt_rounds;
+	rounds_fn giftb128_encrypt_rounds;
+	rounds_fn giftb128_decrypt_rounds;
+} backend_t;
+
+extern const backend_t backend_portable;
+#ifdef GIFT128_BMI2
+extern const backend_t backend_bmi2;
+// 0 if 'pdep'/'pext' are slow, so that 'bmi2' is only used on request
+int bmi2_preferred(void);
+#endif
+#ifdef GIFT128_AVX2
+extern const backend_t backend_avx2;
+#endif
+#ifdef GIFT128_AVX512
+extern const backend_t backend_avx512;
+#endif
+#ifdef GIFT128_NEON
+extern const backend_t backend_neon;
+#endif
+
+extern const backend_t* backend;
+extern const backend_t* scalar_backend;
+extern void select_backend(void);
+
+// returns the backend selected at load time (see 'dispatch.c')
+static inline const backend_t* get_backend(void) {
+	if(!backend)
+		select_backend();
+	return backend;
+}
+
+// returns the backend used for single blocks and incomplete SIMD batches
+static inline const backend_t* get_scalar_backend(void) {
+	if(!scalar_backend)
+		select_backend();
+	return scalar_backend;
+}
+
+// portable batched key schedules, shared by the scalar backends
+void precompute_rkeys_x8_portable(u32 (*rkeys)[80], const u8 (*keys)[KEY_SIZE]);
+void precompute_rkeys_x16_portable(u32 (*rkeys)[80], const u8 (*keys)[KEY_SIZE]);
+void precompute_multikey_rkeys_portable(u32* rkeys, const u8 (*keys)[KEY_SIZE]);
+
+// portable reduced-round functions, shared by the scalar backends
+void gift128_encrypt_rounds_portable(u8* out, const u8* in, u32 nblocks,
+			const u32* rkey, u32 start, u32 end);
+void gift128_decrypt_rounds_portable(u8* out, const u8* in, u32 nblocks,
+			const u32* rkey, u32 start, u32 end);
+void giftb128_encrypt_rounds_portable(u8* out, const u8* in, u32 nblocks,
+			const u32* rkey, u32 start, u32 end);
+void giftb128_decrypt_rounds_portable(u8* out, const u8* in, u32 nblocks,
+			const u32* rkey, u32 start, u32 end);
+
+// blocks processed at once by the bitsliced engine (see 'bitsliced.c')
+u32 bitsliced_batch(void);
+
+#endif  // GIFT128_BACKEND_H_
@@ -0,0 +1,270 @@
+/*******************************************************************************
+* Constant-time bitsliced implementation of GIFT-128 for large batches.
+*
+* Contrary to fixslicing, each of the 128 words of the state holds the same
+* bit of 32 different blocks (one per bit of a 32-bit word), so that the bit
+* permutation only renames words and costs nothing, while the S-box is the
+* very same 'SBOX' circuit as in 'gift128.h' applied on 32 nibbles per round.
+* The price to pay is the transposition of the blocks and the fact that 32
+* blocks are always processed at once, hence this engine is only worth it
+* for large inputs (see 'README.md' for the crossover batch size).
+*
+* The engine is written once for a generic word type: 32-bit words by
+* default, and 256/512-bit GCC vectors (8/16 groups of 32 blocks) when the
+* AVX2/AVX-512 backend is selected.
+*******************************************************************************/
+#include <string.h>
+#include "backend.h"
+#include "endian.h"
+#include "gift128.h"
+
+#define BS_BLOCKS		32		// blocks per 32-bit word
+
+// bit 'i' of the state is moved to bit 'BS_PERM(i)' by the permutation
+#define BS_PERM(i)											\
+	(4*((i)/16) + 32*((3*(((i)%16)/4) + ((i)%4)) % 4) + ((i)%4))
+
+// all-zero or all-one word according to the bit 'i' of 'x'
+#define BS_MASK(x, i)	(0u - (((x) >> (i)) & 1))
+
+/*****************************************************************************
+* The 6-bit round constants of GIFT-128 in the classical representation.
+*****************************************************************************/
+static const u8 bs_rconst[40] = {
+	0x01, 0x03, 0x07, 0x0f, 0x1f, 0x3e, 0x3d, 0x3b, 0x37, 0x2f,
+	0x1e, 0x3c, 0x39, 0x33, 0x27, 0x0e, 0x1d, 0x3a, 0x35, 0x2b,
+	0x16, 0x2c, 0x18, 0x30, 0x21, 0x02, 0x05, 0x0b, 0x17, 0x2e,
+	0x1c, 0x38, 0x31, 0x23, 0x06, 0x0d, 0x1b, 0x36, 0x2d, 0x1a
+};
+
+/*****************************************************************************
+* Classical key schedule: rkey[2*r] and rkey[2*r+1] are the 32-bit words U
+* and V of round r, XORed to the bits 4i+2 and 4i+1 of the state.
+*****************************************************************************/
+void gift128_bitsliced_init(gift128_bitsliced_ctx* ctx, const u8* key) {
+	u32 k[8], t6, t7;
+	for(int i = 0; i < 8; i++)		// k[7] holds the 2 first bytes
+		k[7 - i] = (key[2*i] << 8) | key[2*i + 1];
+	for(int r = 0; r < 40; r++) {
+		ctx->rkey[2*r] = (k[5] << 16) | k[4];
+		ctx->rkey[2*r + 1] = (k[1] << 16) | k[0];
+		t6 = ((k[0] >> 12) | (k[0] << 4)) & 0xffff;
+		t7 = ((k[1] >> 2) | (k[1] << 14)) & 0xffff;
+		for(int i = 0; i < 6; i++)
+			k[i] = k[i + 2];
+		k[6] = t6;
+		k[7] = t7;
+	}
+}
+
+/*****************************************************************************
+* Transposes the 32x32 bit matrix 'a': bit j of a[i] is swapped with bit i of
+* a[j]. Each step exchanges the bit s of the row and column indexes.
+*****************************************************************************/
+static void transpose32(u32* a) {
+	u32 tmp, m = 0x0000ffff;
+	for(int s = 16; s != 0; s >>= 1, m ^= m << s)
+		for(int k = 0; k < 32; k = (k + s + 1) & ~s) {
+			SWAPMOVE(a[k], a[k + s], m, s);
+		}
+}
+
+/*****************************************************************************
+* Bitslices 'nblocks' (at most 32) blocks: bit j of state[i] is the bit i of
+* the j-th block, bit 127 being the MSB of its first byte. Missing blocks are
+* replaced by zeros.
+*****************************************************************************/
+static void bs_packing(u32* state, const u8* in, u32 nblocks) {
+	for(int c = 0; c < 4; c++) {
+		u32* a = state + 32*c;
+		for(u32 j = 0; j < BS_BLOCKS; j++)
+			a[j] = (j < nblocks) ? LOAD32_BE(in + 16*j + 12 - 4*c) : 0;
+		transpose32(a);
+	}
+}
+
+static void bs_unpacking(u8* out, u32* state, u32 nblocks) {
+	for(int c = 0; c < 4; c++) {
+		u32* a = state + 32*c;
+		transpose32(a);
+		for(u32 j = 0; j < nblocks; j++) {
+			STORE32_BE(out + 16*j + 12 - 4*c, a[j]);
+		}
+	}
+}
+
+/*****************************************************************************
+* Rounds of the engine on words of type 'word'. The output bits of the S-box
+* are found in the order (s3, s1, s2, s0), as the final swap of the bitsliced
+* S-box is not computed, hence 'INV_SBOX' takes its operands in that order.
+*****************************************************************************/
+#define BS_ROUNDS(name, word, attr)							\
+attr static void name##_encrypt(word* x, const u32* rkey) {	\
+	word s0, s1, s2, s3, y[128];							\
+	for(int r = 0; r < 40; r++) {							\
+		_Pragma("GCC unroll 32")							\
+		for(int i = 0; i < 32; i++) {						\
+			s0 = x[4*i]; s1 = x[4*i + 1];					\
+			s2 = x[4*i + 2]; s3 = x[4*i + 3];				\
+			SBOX(s0, s1, s2, s3);							\
+			y[BS_PERM(4*i)] = s3;							\
+			y[BS_PERM(4*i + 1)] = s1;						\
+			y[BS_PERM(4*i + 2)] = s2;						\
+			y[BS_PERM(4*i + 3)] = s0;						\
+		}													\
+		for(int i = 0; i < 32; i++) {						\
+			x[4*i] = y[4*i];								\
+			x[4*i + 1] = y[4*i + 1] ^ BS_MASK(rkey[2*r + 1], i);\
+			x[4*i + 2] = y[4*i + 2] ^ BS_MASK(rkey[2*r], i);\
+			x[4*i + 3] = y[4*i + 3];						\
+		}													\
+		for(int i = 0; i < 6; i++)							\
+			x[4*i + 3] ^= BS_MASK(bs_rconst[r], i);			\
+		x[127] ^= 0xffffffff;								\
+	}														\
+}															\
+															\
+attr static void name##_decrypt(word* x, const u32* rkey) {	\
+	word s0, s1, s2, s3, y[128];							\
+	for(int r = 39; r >= 0; r--) {							\
+		for(int i = 0; i < 32; i++) {						\
+			y[4*i] = x[4*i];								\
+			y[4*i + 1] = x[4*i + 1] ^ BS_MASK(rkey[2*r + 1], i);\
+			y[4*i + 2] = x[4*i + 2] ^ BS_MASK(rkey[2*r], i);\
+			y[4*i + 3] = x[4*i + 3];						\
+		}													\
+		for(int i = 0; i < 6; i++)							\
+			y[4*i + 3] ^= BS_MASK(bs_rconst[r], i);			\
+		y[127] ^= 0xffffffff;								\
+		_Pragma("GCC unroll 32")							\
+		for(int i = 0; i < 32; i++) {						\
+			s3 = y[BS_PERM(4*i)]; s1 = y[BS_PERM(4*i + 1)];	\
+			s2 = y[BS_PERM(4*i + 2)]; s0 = y[BS_PERM(4*i + 3)];\
+			INV_SBOX(s3, s1, s2, s0);						\
+			x[4*i] = s0; x[4*i + 1] = s1;					\
+			x[4*i + 2] = s2; x[4*i + 3] = s3;				\
+		}													\
+	}														\
+}
+
+BS_ROUNDS(bs32, u32, )
+
+/*****************************************************************************
+* Processes 'nblocks' blocks by batches of 32.
+*****************************************************************************/
+static void bs32_ecb(u8* out, const u8* in, u32 nblocks, const u32* rkey,
+			int encrypting) {
+	u32 state[128], n;
+	for(; nblocks > 0; nblocks -= n) {
+		n = (nblocks < BS_BLOCKS) ? nblocks : BS_BLOCKS;
+		bs_packing(state, in, n);
+		if(encrypting)
+			bs32_encrypt(state, rkey);
+		else
+			bs32_decrypt(state, rkey);
+		bs_unpacking(out, state, n);
+		in += n*BLOCK_SIZE;
+		out += n*BLOCK_SIZE;
+	}
+}
+
+#ifdef GIFT128_AVX2
+/*****************************************************************************
+* Same engine on GCC vectors of G 32-bit words, processing G groups of 32
+* blocks at once: lane g of the vectors holds the bitsliced state of the g-th
+* group. Batches are completed with zero blocks.
+*****************************************************************************/
+#define BS_VECTOR(name, G, attr)							\
+typedef u32 name##_word __attribute__((vector_size(4*(G))));\
+BS_ROUNDS(name, name##_word, attr)							\
+															\
+attr static void name##_ecb(u8* out, const u8* in, u32 nblocks,\
+			const u32* rkey, int encrypting) {				\
+	name##_word x[128];										\
+	u32 state[128], n, group;								\
+	for(; nblocks > 0; nblocks -= n) {						\
+		n = (nblocks < (G)*BS_BLOCKS) ? nblocks : (G)*BS_BLOCKS;\
+		for(int g = 0; g < (G); g++) {						\
+			group = n - (n < (u32)g*BS_BLOCKS ? n : (u32)g*BS_BLOCKS);\
+			group = (group < BS_BLOCKS) ? group : BS_BLOCKS;\
+			bs_packing(state, in + g*BS_BLOCKS*BLOCK_SIZE, group);\
+			for(int i = 0; i < 128; i++)					\
+				x[i][g] = state[i];							\
+		}													\
+		if(encrypting)										\
+			name##_encrypt(x, rkey);						\
+		else												\
+			name##_decrypt(x, rkey);						\
+		for(int g = 0; g < (G); g++) {						\
+			group = n - (n < (u32)g*BS_BLOCKS ? n : (u32)g*BS_BLOCKS);\
+			group = (group < BS_BLOCKS) ? group : BS_BLOCKS;\
+			for(int i = 0; i < 128; i++)					\
+				state[i] = x[i][g];							\
+			bs_unpacking(out + g*BS_BLOCKS*BLOCK_SIZE, state, group);\
+		}													\
+		in += n*BLOCK_SIZE;									\
+		out += n*BLOCK_SIZE;								\
+	}														\
+}
+
+BS_VECTOR(bs256, 8, __attribute__((target("avx2"))))
+#endif
+
+#ifdef GIFT128_AVX512
+BS_VECTOR(bs512, 16, __attribute__((target("avx512f"))))
+#endif
+
+/*****************************************************************************
+* Uses the widest engine allowed by the selected backend.
+*****************************************************************************/
+static void bs_ecb(u8* out, const u8* in, u32 nblocks, const u32* rkey,
+			int encrypting) {
+	const backend_t* b = get_backend();
+	(void)b;
+#ifdef GIFT128_AVX512
+	if(b == &backend_avx512) {
+		bs512_ecb(out, in, nblocks, rkey, encrypting);
+		return;
+	}
+#endif
+#ifdef GIFT128_AVX2
+	if(b == &backend_avx2) {
+		bs256_ecb(out, in, nblocks, rkey, encrypting);
+		return;
+	}
+#endif
+	bs32_ecb(out, in, nblocks, rkey, encrypting);
+}
+
+/*****************************************************************************
+* Returns the number of blocks processed at once by 'bs_ecb'.
+*****************************************************************************/
+u32 bitsliced_batch(void) {
+	const backend_t* b = get_backend();
+	(void)b;
+#ifdef GIFT128_AVX512
+	if(b == &backend_avx512)
+		return 16*32;
+#endif
+#ifdef GIFT128_AVX2
+	if(b == &backend_avx2)
+		return 8*32;
+#endif
+	return 32;
+}
+
+/*****************************************************************************
+* Encryption/decryption of 128-bit blocks using bitsliced GIFT-128 in ECB
+* mode. Note that 'len' must be a multiple of 16.
+*****************************************************************************/
+int gift128_bitsliced_ecb_encrypt(const gift128_bitsliced_ctx* ctx, u8* ctext,
+			const u8* ptext, u32 ptext_len) {
+	bs_ecb(ctext, ptext, ptext_len/BLOCK_SIZE, ctx->rkey, 1);
+	return 0;
+}
+
+int gift128_bitsliced_ecb_decrypt(const gift128_bitsliced_ctx* ctx, u8* ptext,
+			const u8* ctext, u32 ctext_len) {
+	bs_ecb(ptext, ctext, ctext_len/BLOCK_SIZE, ctx->rkey, 0);
+	return 0;
+}
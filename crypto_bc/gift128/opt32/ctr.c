@@ -0,0 +1,120 @@
+/*******************************************************************************
+* GIFT-128 in counter (CTR) mode.
+*
+* The counter blocks are generated by batches and encrypted at once through
+* 'gift128_ecb_encrypt' so that they benefit from the parallel kernels when
+* available. The counter is the whole 128-bit block, interpreted as a
+* big-endian integer and incremented modulo 2^128.
+*******************************************************************************/
+#include <string.h>
+#include "backend.h"
+
+#define CTR_BATCH		16		// number of counter blocks encrypted at once
+
+/*****************************************************************************
+* Computes the counter block 'ctr' = 'iv' + 'n' (mod 2^128).
+*****************************************************************************/
+static void ctr_add(u8* ctr, const u8* iv, u64 n) {
+	u32 carry = 0;
+	for(int i = BLOCK_SIZE - 1; i >= 0; i--) {
+		carry += iv[i] + (u32)(n & 0xff);
+		ctr[i] = (u8)carry;
+		carry >>= 8;
+		n >>= 8;
+	}
+}
+
+/*****************************************************************************
+* Increments the counter block 'ctr' (mod 2^128).
+*****************************************************************************/
+static void ctr_inc(u8* ctr) {
+	for(int i = BLOCK_SIZE - 1; i >= 0; i--)
+		if(++ctr[i] != 0)
+			break;
+}
+
+/*****************************************************************************
+* Encryption/decryption of 'len' bytes in CTR mode, starting at byte 'offset'
+* of the keystream defined by 'iv', the counter blocks being encrypted by
+* batches of 'batch' blocks through 'ecb' in 'keystream' (of 'batch' blocks),
+* which is erased before returning.
+*****************************************************************************/
+typedef void (*ecb_fn)(const void* ctx, u8* ctext, const u8* ptext, u32 len);
+
+static void ctr_xor(ecb_fn ecb, const void* ctx, u8* keystream, u32 batch,
+			const u8* iv, u64 offset, const u8* in, u8* out, u32 len) {
+	u8 ctr[BLOCK_SIZE];
+	u32 skip = offset % BLOCK_SIZE;
+	ctr_add(ctr, iv, offset / BLOCK_SIZE);
+	while(len > 0) {
+		u32 nblocks, n;
+		// at most 'batch' blocks, the rest being left to the next iterations
+		if(len >= batch*BLOCK_SIZE - skip)
+			nblocks = batch;
+		else
+			nblocks = (skip + len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		for(u32 i = 0; i < nblocks; i++) {
+			memcpy(keystream + i*BLOCK_SIZE, ctr, BLOCK_SIZE);
+			ctr_inc(ctr);
+		}
+		ecb(ctx, keystream, keystream, nblocks*BLOCK_SIZE);
+		n = nblocks*BLOCK_SIZE - skip;
+		if(n > len)
+			n = len;
+		for(u32 i = 0; i < n; i++)
+			out[i] = in[i] ^ keystream[skip + i];
+		in += n;
+		out += n;
+		len -= n;
+		skip = 0;
+	}
+	memset(keystream, 0, batch*BLOCK_SIZE);
+	__asm__ __volatile__("" : : "r"(keystream) : "memory");
+}
+
+static void fixsliced_ecb(const void* ctx, u8* ctext, const u8* ptext,
+			u32 len) {
+	gift128_ecb_encrypt((const gift128_ctx*)ctx, ctext, ptext, len);
+}
+
+static void bitsliced_ecb(const void* ctx, u8* ctext, const u8* ptext,
+			u32 len) {
+	gift128_bitsliced_ecb_encrypt((const gift128_bitsliced_ctx*)ctx, ctext,
+		ptext, len);
+}
+
+/*****************************************************************************
+* Encryption/decryption of 'len' bytes in CTR mode, starting at byte 'offset'
+* of the keystream defined by the initial counter block 'iv'. A long message
+* can therefore be processed by successive calls with the same 'iv' and an
+* increasing 'offset', which does not need to be a multiple of 16.
+*****************************************************************************/
+int gift128_ctr_xor_at(const gift128_ctx* ctx, const u8* iv, u64 offset,
+			const u8* in, u8* out, u32 len) {
+	u8 keystream[CTR_BATCH*BLOCK_SIZE];
+	ctr_xor(fixsliced_ecb, ctx, keystream, CTR_BATCH, iv, offset, in, out,
+		len);
+	return 0;
+}
+
+/*****************************************************************************
+* Encryption/decryption of 'len' bytes in CTR mode with the initial counter
+* block 'iv'. Note that 'len' does not need to be a multiple of 16.
+*****************************************************************************/
+int gift128_ctr_xor(const gift128_ctx* ctx, const u8* iv, const u8* in, u8* out,
+			u32 len) {
+	return gift128_ctr_xor_at(ctx, iv, 0, in, out, len);
+}
+
+/*****************************************************************************
+* Same as 'gift128_ctr_xor' with the bitsliced implementation, the counter
+* blocks being encrypted by batches of the width of the bitsliced engine of
+* the selected backend (32 blocks per 32-bit lane) so that it is fully used.
+*****************************************************************************/
+int gift128_bitsliced_ctr_xor(const gift128_bitsliced_ctx* ctx, const u8* iv,
+			const u8* in, u8* out, u32 len) {
+	u32 batch = bitsliced_batch();
+	u8 keystream[batch*BLOCK_SIZE];
+	ctr_xor(bitsliced_ecb, ctx, keystream, batch, iv, 0, in, out, len);
+	return 0;
+}
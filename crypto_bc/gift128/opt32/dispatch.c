@@ -0,0 +1,112 @@
+/*******************************************************************************
+* Runtime selection of the GIFT-128/GIFTb-128 implementation.
+*
+* The fastest implementation supported by the processor (as reported by
+* CPUID) is selected when the library is loaded. The selection can be
+* overridden for benchmarking purposes by setting the 'GIFT_BACKEND'
+* environment variable to the name of a backend (e.g. 'portable', 'bmi2',
+* 'avx2', 'avx512' or 'neon' on AArch64), or by calling
+* 'gift128_select_backend'.
+*
+* Single blocks and incomplete SIMD batches do not benefit from the SIMD
+* backends and go through a scalar backend instead: 'bmi2' if supported, not
+* slowed down by microcoded 'pdep'/'pext' (AMD processors prior to Zen 3) and
+* the selected backend is not 'portable', 'portable' otherwise. On the
+* processors with slow 'pdep'/'pext', 'bmi2' is only used when requested.
+*
+* A function-pointer table is used rather than GNU ifunc resolvers because
+* the latter run before the environment can safely be accessed.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "backend.h"
+
+/****************************************************************************
+* Backends by decreasing order of preference.
+****************************************************************************/
+static const backend_t* const backends[] = {
+#ifdef GIFT128_AVX512
+	&backend_avx512,
+#endif
+#ifdef GIFT128_AVX2
+	&backend_avx2,
+#endif
+#ifdef GIFT128_BMI2
+	&backend_bmi2,
+#endif
+#ifdef GIFT128_NEON
+	&backend_neon,
+#endif
+	&backend_portable
+};
+
+#define NB_BACKENDS		(sizeof(backends) / sizeof(backends[0]))
+
+const backend_t* backend = NULL;
+const backend_t* scalar_backend = NULL;
+
+static void set_backend(const backend_t* b) {
+	scalar_backend = &backend_portable;
+#ifdef GIFT128_BMI2
+	if(b != &backend_portable && backend_bmi2.supported() &&
+			(b == &backend_bmi2 || bmi2_preferred()))
+		scalar_backend = &backend_bmi2;
+#endif
+	backend = b;
+}
+
+/****************************************************************************
+* Selects the backend named by the 'GIFT_BACKEND' environment variable if
+* supported, the fastest supported one otherwise.
+****************************************************************************/
+__attribute__((constructor))
+void select_backend(void) {
+	const char* name = getenv("GIFT_BACKEND");
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+#endif
+	if(name && gift128_select_backend(name) == 0)
+		return;
+	for(u32 i = 0; i < NB_BACKENDS; i++) {
+#ifdef GIFT128_BMI2
+		if(backends[i] == &backend_bmi2 && !bmi2_preferred())
+			continue;
+#endif
+		if(backends[i]->supported()) {
+			set_backend(backends[i]);
+			return;
+		}
+	}
+}
+
+/****************************************************************************
+* Selects the backend 'name'. Returns 0 on success, -1 if it is unknown or not
+* supported by the processor.
+****************************************************************************/
+int gift128_select_backend(const char* name) {
+	for(u32 i = 0; i < NB_BACKENDS; i++) {
+		if(strcmp(backends[i]->name, name) == 0 && backends[i]->supported()) {
+			set_backend(backends[i]);
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/****************************************************************************
+* Returns the name of the i-th available backend (by decreasing order of
+* preference), or NULL if 'i' is out of range. Backends compiled in but not
+* supported by the processor are also listed.
+****************************************************************************/
+const char* gift128_backend_name(u32 i) {
+	if(i >= NB_BACKENDS)
+		return NULL;
+	return backends[i]->name;
+}
+
+/****************************************************************************
+* Returns the name of the backend currently in use.
+****************************************************************************/
+const char* gift128_current_backend(void) {
+	return get_backend()->name;
+}
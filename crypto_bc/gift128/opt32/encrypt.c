@@ -10,6 +10,8 @@
 *
 * @date		January 2020
 *******************************************************************************/
+#include <string.h>
+#include "backend.h"
 #include "endian.h"
 #include "encrypt.h"
 #include "gift128.h"
@@ -39,42 +41,46 @@ const u32 rconst[40] = {
 void precompute_rkeys(u32* rkey, const u8* key) {
 	u32 tmp;
     //classical initialization
-    rkey[0] = U32BIG(((u32*)key)[3]);
-    rkey[1] = U32BIG(((u32*)key)[1]);
-    rkey[2] = U32BIG(((u32*)key)[2]);
-    rkey[3] = U32BIG(((u32*)key)[0]);
-	// classical keyschedule
-	for(int i = 0; i < 16; i+=2) {
-		rkey[i+4] = rkey[i+1];
-		rkey[i+5] = KEY_UPDATE(rkey[i]);
-	}
-	// transposition to fixsliced representations
-	for(int i = 0; i < 20; i+=10) {
-		rkey[i]	= REARRANGE_RKEY_0(rkey[i]);
-		rkey[i + 1]	= REARRANGE_RKEY_0(rkey[i + 1]);
-		rkey[i + 2]	= REARRANGE_RKEY_1(rkey[i + 2]);
-		rkey[i + 3]	= REARRANGE_RKEY_1(rkey[i + 3]);
-		rkey[i + 4]	= REARRANGE_RKEY_2(rkey[i + 4]);
-		rkey[i + 5]	= REARRANGE_RKEY_2(rkey[i + 5]);
-		rkey[i + 6]	= REARRANGE_RKEY_3(rkey[i + 6]);
-		rkey[i + 7]	= REARRANGE_RKEY_3(rkey[i + 7]);
-	}
-	// keyschedule according to fixsliced representations
-	for(int i = 20; i < 80; i+=10) {
-		rkey[i] = rkey[i-19];
-		rkey[i+1] = KEY_TRIPLE_UPDATE_0(rkey[i-20]);
-		rkey[i+2] = KEY_DOUBLE_UPDATE_1(rkey[i-17]);
-		rkey[i+3] = KEY_TRIPLE_UPDATE_1(rkey[i-18]);
-		rkey[i+4] = KEY_DOUBLE_UPDATE_2(rkey[i-15]);
-		rkey[i+5] = KEY_TRIPLE_UPDATE_2(rkey[i-16]);
-		rkey[i+6] = KEY_DOUBLE_UPDATE_3(rkey[i-13]);
-		rkey[i+7] = KEY_TRIPLE_UPDATE_3(rkey[i-14]);
-		rkey[i+8] = KEY_DOUBLE_UPDATE_4(rkey[i-11]);
-		rkey[i+9] = KEY_TRIPLE_UPDATE_4(rkey[i-12]);
-		SWAPMOVE(rkey[i], rkey[i], 0x00003333, 16);
-		SWAPMOVE(rkey[i], rkey[i], 0x55554444, 1);
-		SWAPMOVE(rkey[i+1], rkey[i+1], 0x55551100, 1);
-	}
+    rkey[0] = LOAD32_BE(key + 12);
+    rkey[1] = LOAD32_BE(key + 4);
+    rkey[2] = LOAD32_BE(key + 8);
+    rkey[3] = LOAD32_BE(key);
+	KEY_SCHEDULE(rkey);
+}
+
+/*****************************************************************************
+* Same as 'precompute_rkeys' for several keys at once. The portable versions
+* rely on the baseline 128-bit SIMD instruction set (e.g. SSE2 or NEON) and
+* process 4 keys at a time.
+*****************************************************************************/
+PRECOMPUTE_RKEYS_XN(precompute_rkeys_x4, 4, )
+
+void precompute_rkeys_x8_portable(u32 (*rkeys)[80],
+				const u8 (*keys)[KEY_SIZE]) {
+	for(int i = 0; i < 8; i += 4)
+		precompute_rkeys_x4(rkeys + i, keys + i);
+}
+
+void precompute_rkeys_x16_portable(u32 (*rkeys)[80],
+				const u8 (*keys)[KEY_SIZE]) {
+	for(int i = 0; i < 16; i += 4)
+		precompute_rkeys_x4(rkeys + i, keys + i);
+}
+
+PRECOMPUTE_MULTIKEY_RKEYS_XN(precompute_multikey_rkeys_x4, 4, static)
+
+void precompute_multikey_rkeys_portable(u32* rkeys,
+				const u8 (*keys)[KEY_SIZE]) {
+	for(int i = 0; i < GIFT128_LANES; i += 4)
+		precompute_multikey_rkeys_x4(rkeys + i, keys + i);
+}
+
+void precompute_rkeys_x8(u32 rkeys[8][80], const u8 keys[8][KEY_SIZE]) {
+	get_backend()->precompute_rkeys_x8(rkeys, keys);
+}
+
+void precompute_rkeys_x16(u32 rkeys[16][80], const u8 keys[16][KEY_SIZE]) {
+	get_backend()->precompute_rkeys_x16(rkeys, keys);
 }
 
 /*****************************************************************************
@@ -82,13 +88,13 @@ void precompute_rkeys(u32* rkey, const u8* key) {
 *****************************************************************************/
 void packing(u32* state, const u8* input) {
 	u32 tmp;
-	state[0] =	(input[6] << 24)	| (input[7] << 16)	|
+	state[0] =	((u32)input[6] << 24)	| (input[7] << 16)	|
 				(input[14] << 8)	| input[15];
-	state[1] =	(input[4] << 24)	| (input[5] << 16)	|
+	state[1] =	((u32)input[4] << 24)	| (input[5] << 16)	|
 				(input[12] << 8)	| input[13];
-	state[2] =	(input[2] << 24)	| (input[3] << 16)	|
+	state[2] =	((u32)input[2] << 24)	| (input[3] << 16)	|
 				(input[10] << 8)	| input[11];
-	state[3] =	(input[0] << 24)	| (input[1] << 16)	|
+	state[3] =	((u32)input[0] << 24)	| (input[1] << 16)	|
 				(input[8] << 8)		| input[9];
     SWAPMOVE(state[0], state[0], 0x0a0a0a0a, 3);
     SWAPMOVE(state[0], state[0], 0x00cc00cc, 6);
@@ -135,22 +141,215 @@ void unpacking(u8* output, u32* state) {
 	output[14] = (state[0] >> 8) & 0xff; output[15] = state[0] & 0xff;
 }
 
+/*****************************************************************************
+* Expands the key into the fixsliced round keys used by all the functions
+* taking a context as parameter.
+*****************************************************************************/
+void gift128_init(gift128_ctx* ctx, const u8* key) {
+	precompute_rkeys(ctx->rkey, key);
+}
+
+/*****************************************************************************
+* Encryption of a single 128-bit block using GIFT-128.
+*****************************************************************************/
+static void encrypt_block(u8* ctext, const u8* ptext, const u32* rkey) {
+	u32 tmp, state[4];
+	packing(state, ptext);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
+	unpacking(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of a single 128-bit block using GIFT-128.
+*****************************************************************************/
+static void decrypt_block(u8* ptext, const u8* ctext, const u32* rkey) {
+	u32 tmp, state[4];
+	packing(state, ctext);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
+	unpacking(ptext, state);
+}
+
+/*****************************************************************************
+* Encryption of a single 128-bit block with GIFTb-128 (used in GIFT-COFB).
+*****************************************************************************/
+static void encryptb_block(u8* ctext, const u8* ptext, const u32* rkey) {
+	u32 tmp, state[4];
+	state[0] = LOAD32_BE(ptext);
+	state[1] = LOAD32_BE(ptext + 4);
+	state[2] = LOAD32_BE(ptext + 8);
+	state[3] = LOAD32_BE(ptext + 12);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
+	U8BIG(ctext, state[0]);
+	U8BIG(ctext + 4, state[1]);
+	U8BIG(ctext + 8, state[2]);
+	U8BIG(ctext + 12, state[3]);
+}
+
+/*****************************************************************************
+* Decryption of a single 128-bit block with GIFTb-128 (used in GIFT-COFB).
+*****************************************************************************/
+static void decryptb_block(u8* ptext, const u8* ctext, const u32* rkey) {
+	u32 tmp, state[4];
+	state[0] = LOAD32_BE(ctext);
+	state[1] = LOAD32_BE(ctext + 4);
+	state[2] = LOAD32_BE(ctext + 8);
+	state[3] = LOAD32_BE(ctext + 12);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
+	U8BIG(ptext, state[0]);
+	U8BIG(ptext + 4, state[1]);
+	U8BIG(ptext + 8, state[2]);
+	U8BIG(ptext + 12, state[3]);
+}
+
+/*****************************************************************************
+* Bulk functions of the portable backend, processing one block at a time.
+*****************************************************************************/
+#define PORTABLE_BULK(name, block_fn)							\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	for(; nblocks > 0; nblocks--) {								\
+		block_fn(out, in, rkey);								\
+		in += BLOCK_SIZE;										\
+		out += BLOCK_SIZE;										\
+	}															\
+}
+
+PORTABLE_BULK(gift128_encrypt_portable, encrypt_block)
+PORTABLE_BULK(gift128_decrypt_portable, decrypt_block)
+PORTABLE_BULK(giftb128_encrypt_portable, encryptb_block)
+PORTABLE_BULK(giftb128_decrypt_portable, decryptb_block)
+
+/*****************************************************************************
+* Multi-key functions of the portable backend: the round keys of each block
+* are gathered from the lane-interleaved ones before processing the block.
+*****************************************************************************/
+#define PORTABLE_MULTIKEY_BULK(name, block_fn)					\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	u32 lane_rkey[80];											\
+	for(u32 j = 0; j < nblocks; j++) {							\
+		for(int i = 0; i < 80; i++)								\
+			lane_rkey[i] = rkey[i*GIFT128_LANES + j];			\
+		block_fn(out, in, lane_rkey);							\
+		in += BLOCK_SIZE;										\
+		out += BLOCK_SIZE;										\
+	}															\
+}
+
+PORTABLE_MULTIKEY_BULK(gift128_encrypt_multikey_portable, encrypt_block)
+PORTABLE_MULTIKEY_BULK(gift128_decrypt_multikey_portable, decrypt_block)
+
+/*****************************************************************************
+* Reduced-round functions of the portable backend (see 'ROUNDS_W' in
+* 'fixsliced.h'), GIFTb-128 blocks being loaded as in 'encryptb_block'.
+*****************************************************************************/
+static void packingb(u32* state, const u8* input) {
+	state[0] = LOAD32_BE(input);
+	state[1] = LOAD32_BE(input + 4);
+	state[2] = LOAD32_BE(input + 8);
+	state[3] = LOAD32_BE(input + 12);
+}
+
+static void unpackingb(u8* output, u32* state) {
+	U8BIG(output, state[0]);
+	U8BIG(output + 4, state[1]);
+	U8BIG(output + 8, state[2]);
+	U8BIG(output + 12, state[3]);
+}
+
+#define PORTABLE_ROUNDS(name, load, store, rounds)				\
+void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+			u32 start, u32 end) {								\
+	u32 tmp, state[4];											\
+	for(; nblocks > 0; nblocks--) {								\
+		load(state, in);										\
+		rounds(state, rkey, rconst, start, end);				\
+		store(out, state);										\
+		in += BLOCK_SIZE;										\
+		out += BLOCK_SIZE;										\
+	}															\
+}
+
+PORTABLE_ROUNDS(gift128_encrypt_rounds_portable, packing, unpacking, ROUNDS)
+PORTABLE_ROUNDS(gift128_decrypt_rounds_portable, packing, unpacking,
+	INV_ROUNDS)
+PORTABLE_ROUNDS(giftb128_encrypt_rounds_portable, packingb, unpackingb,
+	ROUNDS)
+PORTABLE_ROUNDS(giftb128_decrypt_rounds_portable, packingb, unpackingb,
+	INV_ROUNDS)
+
+/*****************************************************************************
+* Encryption of a single block with the round keys derived on the fly from
+* the 4 classical key words 'key': only the round keys of the next 2
+* quintuples are held, those of a quintuple being replaced by the ones of the
+* quintuple after the next one once used (see 'KEY_QUINTUPLE_UPDATE').
+*****************************************************************************/
+#define OTF_ENCRYPT_BLOCK(name, load, store)					\
+static void name(u8* out, const u8* in, const u32* key) {		\
+	u32 tmp, state[4], rkey[20];								\
+	for(int i = 0; i < 4; i++)									\
+		rkey[i] = key[i];										\
+	KEY_SCHEDULE_INIT(rkey);									\
+	load(state, in);											\
+	for(int i = 0; i < 40; i+=5) {								\
+		u32* rk = rkey + (i % 10)*2;							\
+		QUINTUPLE_ROUND(state, rk, rconst + i);					\
+		if(i < 30)												\
+			KEY_QUINTUPLE_UPDATE(rk);							\
+	}															\
+	store(out, state);											\
+	memset(rkey, 0, sizeof(rkey));								\
+	__asm__ __volatile__("" : : "r"(rkey) : "memory");			\
+}
+
+OTF_ENCRYPT_BLOCK(gift128_encrypt_otf, packing, unpacking)
+OTF_ENCRYPT_BLOCK(giftb128_encrypt_otf, packingb, unpackingb)
+
+static int portable_supported(void) {
+	return 1;
+}
+
+const backend_t backend_portable = {
+	"portable",
+	portable_supported,
+	gift128_encrypt_portable,
+	gift128_decrypt_portable,
+	giftb128_encrypt_portable,
+	giftb128_decrypt_portable,
+	precompute_rkeys_x8_portable,
+	precompute_rkeys_x16_portable,
+	precompute_multikey_rkeys_portable,
+	gift128_encrypt_multikey_portable,
+	gift128_decrypt_multikey_portable,
+	gift128_encrypt_rounds_portable,
+	gift128_decrypt_rounds_portable,
+	giftb128_encrypt_rounds_portable,
+	giftb128_decrypt_rounds_portable
+};
+
+/*****************************************************************************
+* Encryption of a single 128-bit block using GIFT-128.
+*****************************************************************************/
+void gift128_encrypt_block(const gift128_ctx* ctx, u8* ctext, const u8* ptext) {
+	get_scalar_backend()->gift128_encrypt(ctext, ptext, 1, ctx->rkey);
+}
+
+/*****************************************************************************
+* Decryption of a single 128-bit block using GIFT-128.
+*****************************************************************************/
+void gift128_decrypt_block(const gift128_ctx* ctx, u8* ptext, const u8* ctext) {
+	get_scalar_backend()->gift128_decrypt(ptext, ctext, 1, ctx->rkey);
+}
+
 /*****************************************************************************
 * Encryption of 128-bit blocks using GIFT-128 in ECB mode.
 * Note that 'ptext_len' must be a mutliple of 16.
 *****************************************************************************/
-int gift128_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key) {
-	u32 tmp, state[4], rkey[80];
-	precompute_rkeys(rkey, key);
-	while(ptext_len > 0) {
-		packing(state, ptext);
-		for(int i = 0; i < 40; i+=5)
-			QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
-		unpacking(ctext, state);
-		ptext += BLOCK_SIZE;
-		ctext += BLOCK_SIZE;
-		ptext_len -= BLOCK_SIZE;
-	}
+int gift128_ecb_encrypt(const gift128_ctx* ctx, u8* ctext, const u8* ptext,
+				u32 ptext_len) {
+	get_backend()->gift128_encrypt(ctext, ptext, ptext_len/BLOCK_SIZE, ctx->rkey);
 	return 0;
 }
 
@@ -158,67 +357,263 @@ int gift128_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key
 * Decryption of 128-bit blocks using GIFT-128 in ECB mode.
 * Note that 'ctext_len' must be a mutliple of 16.
 *****************************************************************************/
-int gift128_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key) {
-	u32 tmp, state[4], rkey[80];
-	precompute_rkeys(rkey, key);
-	while(ctext_len > 0) {
-		packing(state, ctext);
-		for(int i = 35; i >= 0; i-=5)
-			INV_QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
-		unpacking(ptext, state);
-		ptext += BLOCK_SIZE;
-		ctext += BLOCK_SIZE;
-		ctext_len -= BLOCK_SIZE;
+int gift128_ecb_decrypt(const gift128_ctx* ctx, u8* ptext, const u8* ctext,
+				u32 ctext_len) {
+	get_backend()->gift128_decrypt(ptext, ctext, ctext_len/BLOCK_SIZE, ctx->rkey);
+	return 0;
+}
+
+/*****************************************************************************
+* Precomputes the round keys of the 'nkeys' (at most GIFT128_LANES) keys and
+* interleaves them. Returns -1 if there are too many keys.
+*****************************************************************************/
+int gift128_multikey_init(gift128_multikey_ctx* ctx, const u8 keys[][KEY_SIZE],
+			u32 nkeys) {
+	u8 lane_keys[GIFT128_LANES][KEY_SIZE] = {{0}};
+	if(nkeys > GIFT128_LANES)
+		return -1;
+	if(nkeys == GIFT128_LANES) {
+		get_backend()->precompute_multikey_rkeys(ctx->rkey, keys);
+		return 0;
 	}
+	for(u32 j = 0; j < nkeys; j++)
+		for(int i = 0; i < KEY_SIZE; i++)
+			lane_keys[j][i] = keys[j][i];
+	get_backend()->precompute_multikey_rkeys(ctx->rkey,
+		(const u8 (*)[KEY_SIZE])lane_keys);
+	memset(lane_keys, 0, sizeof(lane_keys));
+	__asm__ __volatile__("" : : "r"(lane_keys) : "memory");
+	return 0;
+}
+
+/*****************************************************************************
+* Encryption of 'nblocks' (at most GIFT128_LANES) consecutive 128-bit blocks
+* using GIFT-128, the i-th block being encrypted with the i-th key.
+*****************************************************************************/
+int gift128_multikey_encrypt(const gift128_multikey_ctx* ctx, u8* ctext,
+			const u8* ptext, u32 nblocks) {
+	if(nblocks > GIFT128_LANES)
+		return -1;
+	get_backend()->gift128_encrypt_multikey(ctext, ptext, nblocks, ctx->rkey);
+	return 0;
+}
+
+/*****************************************************************************
+* Decryption of 'nblocks' (at most GIFT128_LANES) consecutive 128-bit blocks
+* using GIFT-128, the i-th block being decrypted with the i-th key.
+*****************************************************************************/
+int gift128_multikey_decrypt(const gift128_multikey_ctx* ctx, u8* ptext,
+			const u8* ctext, u32 nblocks) {
+	if(nblocks > GIFT128_LANES)
+		return -1;
+	get_backend()->gift128_decrypt_multikey(ptext, ctext, nblocks, ctx->rkey);
 	return 0;
 }
 
+/*****************************************************************************
+* Encryption of a single 128-bit block with GIFTb-128 (used in GIFT-COFB).
+*****************************************************************************/
+void giftb128_encrypt_block(const gift128_ctx* ctx, u8* ctext, const u8* ptext) {
+	get_scalar_backend()->giftb128_encrypt(ctext, ptext, 1, ctx->rkey);
+}
+
+/*****************************************************************************
+* Decryption of a single 128-bit block with GIFTb-128 (used in GIFT-COFB).
+*****************************************************************************/
+void giftb128_decrypt_block(const gift128_ctx* ctx, u8* ptext, const u8* ctext) {
+	get_scalar_backend()->giftb128_decrypt(ptext, ctext, 1, ctx->rkey);
+}
+
 /*****************************************************************************
 * Encryption of 128-bit blocks with GIFTb-128 (used in GIFT-COFB) in ECB mode.
 * Note that 'ptext_len' must be a mutliple of 16.
 *****************************************************************************/
-int giftb128_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key) {
-	u32 tmp, state[4], rkey[80];
-	precompute_rkeys(rkey, key);
-	while(ptext_len > 0) {
-    	state[0] = U32BIG(((u32*)ptext)[0]);
-    	state[1] = U32BIG(((u32*)ptext)[1]);
-   		state[2] = U32BIG(((u32*)ptext)[2]);
-    	state[3] = U32BIG(((u32*)ptext)[3]);
-		for(int i = 0; i < 40; i+=5)
-			QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
-		U8BIG(ctext, state[0]);
-		U8BIG(ctext + 4, state[1]);
-		U8BIG(ctext + 8, state[2]);
-		U8BIG(ctext + 12, state[3]);
-		ptext += BLOCK_SIZE;
-		ctext += BLOCK_SIZE;
-		ptext_len -= BLOCK_SIZE;
-	}
+int giftb128_ecb_encrypt(const gift128_ctx* ctx, u8* ctext, const u8* ptext,
+				u32 ptext_len) {
+	get_backend()->giftb128_encrypt(ctext, ptext, ptext_len/BLOCK_SIZE, ctx->rkey);
 	return 0;
 }
 
 /*****************************************************************************
 * Decryption of 128-bit blocks with GIFTb-128 (used in GIFT-COFB) in ECB mode.
+* Note that 'ctext_len' must be a mutliple of 16.
+*****************************************************************************/
+int giftb128_ecb_decrypt(const gift128_ctx* ctx, u8* ptext, const u8* ctext,
+				u32 ctext_len) {
+	get_backend()->giftb128_decrypt(ptext, ctext, ctext_len/BLOCK_SIZE, ctx->rkey);
+	return 0;
+}
+
+/*****************************************************************************
+* Encryption of 128-bit blocks with the rounds 'start' to 'start + nrounds - 1'
+* of GIFT-128 only. Note that 'len' must be a multiple of 16.
+*****************************************************************************/
+int gift128_encrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+				u32 len, u32 start, u32 nrounds) {
+	if(start > 40 || nrounds > 40 - start)
+		return -1;
+	get_backend()->gift128_encrypt_rounds(out, in, len/BLOCK_SIZE, ctx->rkey,
+		start, start + nrounds);
+	return 0;
+}
+
+/*****************************************************************************
+* Inverse of 'gift128_encrypt_rounds' with the same 'start' and 'nrounds'.
+*****************************************************************************/
+int gift128_decrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+				u32 len, u32 start, u32 nrounds) {
+	if(start > 40 || nrounds > 40 - start)
+		return -1;
+	get_backend()->gift128_decrypt_rounds(out, in, len/BLOCK_SIZE, ctx->rkey,
+		start, start + nrounds);
+	return 0;
+}
+
+/*****************************************************************************
+* Same as 'gift128_encrypt_rounds' for GIFTb-128.
+*****************************************************************************/
+int giftb128_encrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+				u32 len, u32 start, u32 nrounds) {
+	if(start > 40 || nrounds > 40 - start)
+		return -1;
+	get_backend()->giftb128_encrypt_rounds(out, in, len/BLOCK_SIZE, ctx->rkey,
+		start, start + nrounds);
+	return 0;
+}
+
+/*****************************************************************************
+* Same as 'gift128_decrypt_rounds' for GIFTb-128.
+*****************************************************************************/
+int giftb128_decrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+				u32 len, u32 start, u32 nrounds) {
+	if(start > 40 || nrounds > 40 - start)
+		return -1;
+	get_backend()->giftb128_decrypt_rounds(out, in, len/BLOCK_SIZE, ctx->rkey,
+		start, start + nrounds);
+	return 0;
+}
+
+/*****************************************************************************
+* Loads the key of the on-the-fly mode in the classical representation, as the
+* first 4 words of 'precompute_rkeys'.
+*****************************************************************************/
+void gift128_otf_init(gift128_otf_ctx* ctx, const u8* key) {
+	ctx->key[0] = LOAD32_BE(key + 12);
+	ctx->key[1] = LOAD32_BE(key + 4);
+	ctx->key[2] = LOAD32_BE(key + 8);
+	ctx->key[3] = LOAD32_BE(key);
+}
+
+// full key schedule from the key words of a 'gift128_otf_ctx'
+static void otf_expand(gift128_ctx* ctx, const gift128_otf_ctx* otf) {
+	u32 tmp;
+	for(int i = 0; i < 4; i++)
+		ctx->rkey[i] = otf->key[i];
+	KEY_SCHEDULE(ctx->rkey);
+}
+
+// erases the round keys expanded by 'otf_expand' before returning
+static void otf_wipe(gift128_ctx* ctx) {
+	memset(ctx, 0, sizeof(gift128_ctx));
+	__asm__ __volatile__("" : : "r"(ctx) : "memory");
+}
+
+/*****************************************************************************
+* Encryption of 128-bit blocks using GIFT-128 in ECB mode with the on-the-fly
+* key schedule. A single block is encrypted while deriving its round keys,
+* longer inputs are processed as in 'gift128_ecb_encrypt' with round keys
+* expanded on the stack for the duration of the call only (and erased
+* before returning).
 * Note that 'ptext_len' must be a mutliple of 16.
 *****************************************************************************/
-int giftb128_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key) {
-	u32 tmp, state[4], rkey[80];
-	precompute_rkeys(rkey, key);
-	while(ctext_len > 0) {
-    	state[0] = U32BIG(((u32*)ctext)[0]);
-    	state[1] = U32BIG(((u32*)ctext)[1]);
-   		state[2] = U32BIG(((u32*)ctext)[2]);
-    	state[3] = U32BIG(((u32*)ctext)[3]);
-		for(int i = 35; i >= 0; i-=5)
-			INV_QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);
-		U8BIG(ptext, state[0]);
-		U8BIG(ptext + 4, state[1]);
-		U8BIG(ptext + 8, state[2]);
-		U8BIG(ptext + 12, state[3]);
-		ptext += BLOCK_SIZE;
-		ctext += BLOCK_SIZE;
-		ctext_len -= BLOCK_SIZE;
+int gift128_otf_ecb_encrypt(const gift128_otf_ctx* ctx, u8* ctext,
+				const u8* ptext, u32 ptext_len) {
+	gift128_ctx full;
+	if(ptext_len == BLOCK_SIZE) {
+		gift128_encrypt_otf(ctext, ptext, ctx->key);
+		return 0;
+	}
+	otf_expand(&full, ctx);
+	gift128_ecb_encrypt(&full, ctext, ptext, ptext_len);
+	otf_wipe(&full);
+	return 0;
+}
+
+/*****************************************************************************
+* Decryption of 128-bit blocks using GIFT-128 in ECB mode with the on-the-fly
+* key schedule. As the round keys are needed in reverse order, they are
+* expanded on the stack for the duration of the call and erased afterwards.
+* Note that 'ctext_len' must be a mutliple of 16.
+*****************************************************************************/
+int gift128_otf_ecb_decrypt(const gift128_otf_ctx* ctx, u8* ptext,
+				const u8* ctext, u32 ctext_len) {
+	gift128_ctx full;
+	otf_expand(&full, ctx);
+	gift128_ecb_decrypt(&full, ptext, ctext, ctext_len);
+	otf_wipe(&full);
+	return 0;
+}
+
+/*****************************************************************************
+* Same as 'gift128_otf_ecb_encrypt' for GIFTb-128 (used in GIFT-COFB).
+*****************************************************************************/
+int giftb128_otf_ecb_encrypt(const gift128_otf_ctx* ctx, u8* ctext,
+				const u8* ptext, u32 ptext_len) {
+	gift128_ctx full;
+	if(ptext_len == BLOCK_SIZE) {
+		giftb128_encrypt_otf(ctext, ptext, ctx->key);
+		return 0;
 	}
+	otf_expand(&full, ctx);
+	giftb128_ecb_encrypt(&full, ctext, ptext, ptext_len);
+	otf_wipe(&full);
 	return 0;
 }
+
+/*****************************************************************************
+* Same as 'gift128_otf_ecb_decrypt' for GIFTb-128 (used in GIFT-COFB).
+*****************************************************************************/
+int giftb128_otf_ecb_decrypt(const gift128_otf_ctx* ctx, u8* ptext,
+				const u8* ctext, u32 ctext_len) {
+	gift128_ctx full;
+	otf_expand(&full, ctx);
+	giftb128_ecb_decrypt(&full, ptext, ctext, ctext_len);
+	otf_wipe(&full);
+	return 0;
+}
+
+/*****************************************************************************
+* Same as 'gift128_ecb_encrypt' but the key is expanded at each call.
+*****************************************************************************/
+int gift128_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key) {
+	gift128_ctx ctx;
+	gift128_init(&ctx, key);
+	return gift128_ecb_encrypt(&ctx, ctext, ptext, ptext_len);
+}
+
+/*****************************************************************************
+* Same as 'gift128_ecb_decrypt' but the key is expanded at each call.
+*****************************************************************************/
+int gift128_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key) {
+	gift128_ctx ctx;
+	gift128_init(&ctx, key);
+	return gift128_ecb_decrypt(&ctx, ptext, ctext, ctext_len);
+}
+
+/*****************************************************************************
+* Same as 'giftb128_ecb_encrypt' but the key is expanded at each call.
+*****************************************************************************/
+int giftb128_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key) {
+	gift128_ctx ctx;
+	gift128_init(&ctx, key);
+	return giftb128_ecb_encrypt(&ctx, ctext, ptext, ptext_len);
+}
+
+/*****************************************************************************
+* Same as 'giftb128_ecb_decrypt' but the key is expanded at each call.
+*****************************************************************************/
+int giftb128_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key) {
+	gift128_ctx ctx;
+	gift128_init(&ctx, key);
+	return giftb128_ecb_decrypt(&ctx, ptext, ctext, ctext_len);
+}
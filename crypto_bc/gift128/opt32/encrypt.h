@@ -1,13 +1,209 @@
-#ifndef ENCRYPT_H_
-#define ENCRYPT_H_
+#ifndef GIFT128_ENCRYPT_H_
+#define GIFT128_ENCRYPT_H_
 
 #define BLOCK_SIZE	16
 #define KEY_SIZE	16
 
 typedef unsigned char u8;
 typedef unsigned int u32;
+typedef unsigned long long u64;
+
+/****************************************************************************
+* Expanded key (fixsliced round keys) shared by GIFT-128 and GIFTb-128. It is
+* computed once by 'gift128_init' and can then be reused for any number of
+* calls with the same key.
+****************************************************************************/
+typedef struct {
+	u32 rkey[80];
+} gift128_ctx;
+
+void gift128_init(gift128_ctx* ctx, const u8* key);
+
+/****************************************************************************
+* Batched key schedules: rkeys[i] receives the fixsliced round keys of
+* keys[i], as computed by 'precompute_rkeys' or 'gift128_init'.
+****************************************************************************/
+void precompute_rkeys(u32* rkey, const u8* key);
+void precompute_rkeys_x4(u32 rkeys[4][80], const u8 keys[4][KEY_SIZE]);
+void precompute_rkeys_x8(u32 rkeys[8][80], const u8 keys[8][KEY_SIZE]);
+void precompute_rkeys_x16(u32 rkeys[16][80], const u8 keys[16][KEY_SIZE]);
+
+void gift128_encrypt_block(const gift128_ctx* ctx, u8* ctext, const u8* ptext);
+void gift128_decrypt_block(const gift128_ctx* ctx, u8* ptext, const u8* ctext);
+int gift128_ecb_encrypt(const gift128_ctx* ctx, u8* ctext, const u8* ptext, u32 ptext_len);
+int gift128_ecb_decrypt(const gift128_ctx* ctx, u8* ptext, const u8* ctext, u32 ctext_len);
+
+void giftb128_encrypt_block(const gift128_ctx* ctx, u8* ctext, const u8* ptext);
+void giftb128_decrypt_block(const gift128_ctx* ctx, u8* ptext, const u8* ctext);
+int giftb128_ecb_encrypt(const gift128_ctx* ctx, u8* ctext, const u8* ptext, u32 ptext_len);
+int giftb128_ecb_decrypt(const gift128_ctx* ctx, u8* ptext, const u8* ctext, u32 ctext_len);
+
+/****************************************************************************
+* On-the-fly key schedule mode: the context only holds the key (16 bytes
+* instead of the 320 bytes of 'gift128_ctx'), the round keys being derived
+* during the encryption of a single block, or expanded on the stack for the
+* duration of a call otherwise (see 'encrypt.c').
+****************************************************************************/
+typedef struct {
+	u32 key[4];
+} gift128_otf_ctx;
+
+void gift128_otf_init(gift128_otf_ctx* ctx, const u8* key);
+int gift128_otf_ecb_encrypt(const gift128_otf_ctx* ctx, u8* ctext,
+			const u8* ptext, u32 ptext_len);
+int gift128_otf_ecb_decrypt(const gift128_otf_ctx* ctx, u8* ptext,
+			const u8* ctext, u32 ctext_len);
+int giftb128_otf_ecb_encrypt(const gift128_otf_ctx* ctx, u8* ctext,
+			const u8* ptext, u32 ptext_len);
+int giftb128_otf_ecb_decrypt(const gift128_otf_ctx* ctx, u8* ptext,
+			const u8* ctext, u32 ctext_len);
+
+/****************************************************************************
+* Reduced-round GIFT-128/GIFTb-128 for cryptanalysis: only the rounds 'start'
+* to 'start + nrounds - 1' (numbered from 0) are applied to each block, which
+* is given and returned in the same byte order as plaintexts and ciphertexts.
+* Any 'start' and 'nrounds' are supported by every backend, not only whole
+* quintuples of rounds. Returns -1 if 'start + nrounds' exceeds 40.
+****************************************************************************/
+int gift128_encrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+			u32 len, u32 start, u32 nrounds);
+int gift128_decrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+			u32 len, u32 start, u32 nrounds);
+int giftb128_encrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+			u32 len, u32 start, u32 nrounds);
+int giftb128_decrypt_rounds(const gift128_ctx* ctx, u8* out, const u8* in,
+			u32 len, u32 start, u32 nrounds);
+
+/****************************************************************************
+* Round keys of up to GIFT128_LANES different keys, interleaved so that the
+* i-th word of the j-th key is rkey[i*GIFT128_LANES + j]. It allows to encrypt
+* one block per key at the cost of a single parallel computation.
+****************************************************************************/
+#define GIFT128_LANES	16
+
+typedef struct {
+	u32 rkey[80*GIFT128_LANES];
+} gift128_multikey_ctx;
+
+int gift128_multikey_init(gift128_multikey_ctx* ctx, const u8 keys[][KEY_SIZE],
+			u32 nkeys);
+int gift128_multikey_encrypt(const gift128_multikey_ctx* ctx, u8* ctext,
+			const u8* ptext, u32 nblocks);
+int gift128_multikey_decrypt(const gift128_multikey_ctx* ctx, u8* ptext,
+			const u8* ctext, u32 nblocks);
+
+int gift128_ctr_xor(const gift128_ctx* ctx, const u8* iv, const u8* in, u8* out, u32 len);
+int gift128_ctr_xor_at(const gift128_ctx* ctx, const u8* iv, u64 offset,
+			const u8* in, u8* out, u32 len);
+
+/****************************************************************************
+* Bitsliced GIFT-128 (see 'bitsliced.c'), processing blocks by batches of 32
+* or more, with its own (classical) round keys.
+****************************************************************************/
+typedef struct {
+	u32 rkey[80];
+} gift128_bitsliced_ctx;
+
+void gift128_bitsliced_init(gift128_bitsliced_ctx* ctx, const u8* key);
+int gift128_bitsliced_ecb_encrypt(const gift128_bitsliced_ctx* ctx, u8* ctext,
+			const u8* ptext, u32 ptext_len);
+int gift128_bitsliced_ecb_decrypt(const gift128_bitsliced_ctx* ctx, u8* ptext,
+			const u8* ctext, u32 ctext_len);
+int gift128_bitsliced_ctr_xor(const gift128_bitsliced_ctx* ctx, const u8* iv,
+			const u8* in, u8* out, u32 len);
+
+/****************************************************************************
+* Incremental ECB and CTR accepting chunks of any size (see 'stream.c'). The
+* round keys are not copied, so 'ctx' must outlive the stream.
+****************************************************************************/
+typedef struct {
+	const gift128_ctx* ctx;
+	int encrypting;
+	u32 buf_len;
+	u8 buf[BLOCK_SIZE];
+} gift128_ecb_stream;
+
+typedef struct {
+	const gift128_ctx* ctx;
+	u64 offset;
+	u8 iv[BLOCK_SIZE];
+	u8 keystream[BLOCK_SIZE];
+} gift128_ctr_stream;
+
+void gift128_ecb_stream_init(gift128_ecb_stream* s, const gift128_ctx* ctx,
+			int encrypting);
+u32 gift128_ecb_stream_update(gift128_ecb_stream* s, u8* out, const u8* in,
+			u32 len);
+int gift128_ecb_stream_final(gift128_ecb_stream* s);
+
+void gift128_ctr_stream_init(gift128_ctr_stream* s, const gift128_ctx* ctx,
+			const u8* iv);
+int gift128_ctr_stream_update(gift128_ctr_stream* s, u8* out, const u8* in,
+			u32 len);
+int gift128_ctr_stream_final(gift128_ctr_stream* s);
+
+/****************************************************************************
+* Pool of threads splitting large ECB/CTR inputs into chunks (see
+* 'parallel.c').
+****************************************************************************/
+typedef struct gift128_pool gift128_pool;
+
+gift128_pool* gift128_pool_create(u32 nthreads, u32 chunk_size);
+void gift128_pool_destroy(gift128_pool* pool);
+u32 gift128_pool_threads(const gift128_pool* pool);
+int gift128_pool_ecb_encrypt(gift128_pool* pool, const gift128_ctx* ctx,
+			u8* ctext, const u8* ptext, u64 len);
+int gift128_pool_ecb_decrypt(gift128_pool* pool, const gift128_ctx* ctx,
+			u8* ptext, const u8* ctext, u64 len);
+int gift128_pool_ctr_xor(gift128_pool* pool, const gift128_ctx* ctx,
+			const u8* iv, const u8* in, u8* out, u64 len);
+
+/****************************************************************************
+* Exhaustive key search from a known plaintext/ciphertext pair over the keys
+* equal to 'key' on the bits cleared in 'mask' (see 'keysearch.c'). The bits
+* set in 'mask', at most 64, are enumerated by the multi-key kernels on all
+* the threads.
+****************************************************************************/
+typedef struct {
+	u8 key[KEY_SIZE];
+	u8 mask[KEY_SIZE];
+	u8 ptext[BLOCK_SIZE];
+	u8 ctext[BLOCK_SIZE];
+} gift128_keysearch;
+
+int gift128_key_search(const gift128_keysearch* ks, u32 nthreads, u8* key,
+			u64* ntested);
+
+/****************************************************************************
+* Differential and linear experiments on the rounds 'start' to
+* 'start + nrounds - 1' of GIFT-128 (see 'experiment.c'), over 2^log_n random
+* plaintext pairs or plaintexts generated from 'seed'. 'in' is the input
+* difference or mask and 'out' the output bits to histogram (at most
+* GIFT128_HIST_MAX_BITS) or the output mask.
+****************************************************************************/
+#define GIFT128_HIST_MAX_BITS	20
+
+typedef struct {
+	u32 start;
+	u32 nrounds;
+	u32 log_n;
+	u64 seed;
+	u8 in[BLOCK_SIZE];
+	u8 out[BLOCK_SIZE];
+} gift128_experiment;
+
+int gift128_differential(const gift128_ctx* ctx,
+			const gift128_experiment* exp, u32 nthreads, u64* hist);
+int gift128_linear(const gift128_ctx* ctx, const gift128_experiment* exp,
+			u32 nthreads, u64* count);
+
+int gift128_select_backend(const char* name);
+const char* gift128_backend_name(u32 i);
+const char* gift128_current_backend(void);
 
 int gift128_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key);
 int gift128_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key);
+int giftb128_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key);
+int giftb128_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key);
 
-#endif  // ENCRYPT_H_
\ No newline at end of file
+#endif  // GIFT128_ENCRYPT_H_
\ No newline at end of file
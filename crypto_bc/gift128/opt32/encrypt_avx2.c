@@ -0,0 +1,343 @@
+/*******************************************************************************
+* Constant-time AVX2 implementation of the GIFT-128 block cipher processing 8
+* blocks in parallel.
+*
+* Each 32-bit lane of the 4 '__m256i' words holds the fixsliced state of a
+* different block so that the round function is exactly the same as in
+* 'encrypt.c', only applied on 8 blocks at once.
+*
+* See "Fixslicing: A New GIFT Representation" paper available at
+* https://eprint.iacr.org/2020/412.pdf for more details on the fixsliced
+* representation.
+*******************************************************************************/
+#include "gift128_avx2.h"
+#include "endian.h"
+#include "gift128.h"
+#include "key_schedule.h"
+
+#ifdef GIFT128_AVX2
+
+extern const u32 rconst[40];
+
+/*****************************************************************************
+* Transposes the 32-bit words within each 128-bit lane of 'r0', ..., 'r3' so
+* that the i-th output word gathers the i-th word of every input. The
+* transposition is an involution and is used for both packing and unpacking.
+*****************************************************************************/
+TARGET_AVX2
+static inline void transpose_x8(__m256i* s, __m256i r0, __m256i r1,
+				__m256i r2, __m256i r3) {
+	__m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+	__m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+	__m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+	__m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+	s[0] = _mm256_unpacklo_epi64(t0, t2);
+	s[1] = _mm256_unpackhi_epi64(t0, t2);
+	s[2] = _mm256_unpacklo_epi64(t1, t3);
+	s[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+/*****************************************************************************
+* Rearranges 8 input blocks in a row-wise bitsliced manner. A byte shuffle
+* builds the 4 words of the scalar 'packing' for each block before they are
+* transposed so that state[i] holds the i-th word of all blocks (blocks 0, 2,
+* 4, 6 in the low lane and 1, 3, 5, 7 in the high lane).
+*****************************************************************************/
+TARGET_AVX2
+static inline void packing_x8(__m256i* state, const u8* input) {
+	__m256i tmp, r[4];
+	const __m256i shuffle = _mm256_setr_epi8(
+		15, 14, 7, 6, 13, 12, 5, 4, 11, 10, 3, 2, 9, 8, 1, 0,
+		15, 14, 7, 6, 13, 12, 5, 4, 11, 10, 3, 2, 9, 8, 1, 0);
+	for(int i = 0; i < 4; i++) {
+		r[i] = _mm256_loadu_si256((const __m256i*)(input + 32*i));
+		r[i] = _mm256_shuffle_epi8(r[i], shuffle);
+	}
+	transpose_x8(state, r[0], r[1], r[2], r[3]);
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_X8(state[i], state[i], 0x0a0a0a0a, 3);
+		SWAPMOVE_X8(state[i], state[i], 0x00cc00cc, 6);
+	}
+	SWAPMOVE_X8(state[0], state[1], 0x000f000f, 4);
+	SWAPMOVE_X8(state[0], state[2], 0x000f000f, 8);
+	SWAPMOVE_X8(state[0], state[3], 0x000f000f, 12);
+	SWAPMOVE_X8(state[1], state[2], 0x00f000f0, 4);
+	SWAPMOVE_X8(state[1], state[3], 0x00f000f0, 8);
+	SWAPMOVE_X8(state[2], state[3], 0x0f000f00, 4);
+}
+
+/*****************************************************************************
+* Fills the output from the internal state of 8 blocks.
+*****************************************************************************/
+TARGET_AVX2
+static inline void unpacking_x8(u8* output, __m256i* state) {
+	__m256i tmp, r[4];
+	const __m256i shuffle = _mm256_setr_epi8(
+		15, 14, 11, 10, 7, 6, 3, 2, 13, 12, 9, 8, 5, 4, 1, 0,
+		15, 14, 11, 10, 7, 6, 3, 2, 13, 12, 9, 8, 5, 4, 1, 0);
+	SWAPMOVE_X8(state[2], state[3], 0x0f000f00, 4);
+	SWAPMOVE_X8(state[1], state[3], 0x00f000f0, 8);
+	SWAPMOVE_X8(state[1], state[2], 0x00f000f0, 4);
+	SWAPMOVE_X8(state[0], state[3], 0x000f000f, 12);
+	SWAPMOVE_X8(state[0], state[2], 0x000f000f, 8);
+	SWAPMOVE_X8(state[0], state[1], 0x000f000f, 4);
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_X8(state[i], state[i], 0x00cc00cc, 6);
+		SWAPMOVE_X8(state[i], state[i], 0x0a0a0a0a, 3);
+	}
+	transpose_x8(r, state[0], state[1], state[2], state[3]);
+	for(int i = 0; i < 4; i++) {
+		r[i] = _mm256_shuffle_epi8(r[i], shuffle);
+		_mm256_storeu_si256((__m256i*)(output + 32*i), r[i]);
+	}
+}
+
+/*****************************************************************************
+* Fills the internal state with 8 input blocks for GIFTb-128, for which the
+* input is expected to be already in a row-wise bitsliced representation.
+*****************************************************************************/
+TARGET_AVX2
+static inline void packingb_x8(__m256i* state, const u8* input) {
+	__m256i r[4];
+	for(int i = 0; i < 4; i++) {
+		r[i] = _mm256_loadu_si256((const __m256i*)(input + 32*i));
+		r[i] = BYTE_SHUFFLE_X8(r[i], 3, 2, 1, 0);
+	}
+	transpose_x8(state, r[0], r[1], r[2], r[3]);
+}
+
+/*****************************************************************************
+* Fills the output from the internal GIFTb-128 state of 8 blocks.
+*****************************************************************************/
+TARGET_AVX2
+static inline void unpackingb_x8(u8* output, const __m256i* state) {
+	__m256i r[4];
+	transpose_x8(r, state[0], state[1], state[2], state[3]);
+	for(int i = 0; i < 4; i++) {
+		r[i] = BYTE_SHUFFLE_X8(r[i], 3, 2, 1, 0);
+		_mm256_storeu_si256((__m256i*)(output + 32*i), r[i]);
+	}
+}
+
+/*****************************************************************************
+* Encryption of 8 consecutive 128-bit blocks with GIFT-128.
+*****************************************************************************/
+TARGET_AVX2
+void gift128_encrypt_x8(u8* ctext, const u8* ptext, const u32* rkey) {
+	__m256i tmp, state[4];
+	packing_x8(state, ptext);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X8(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X8);
+	unpacking_x8(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of 8 consecutive 128-bit blocks with GIFT-128.
+*****************************************************************************/
+TARGET_AVX2
+void gift128_decrypt_x8(u8* ptext, const u8* ctext, const u32* rkey) {
+	__m256i tmp, state[4];
+	packing_x8(state, ctext);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X8(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X8);
+	unpacking_x8(ptext, state);
+}
+
+/*****************************************************************************
+* Encryption of 8 consecutive 128-bit blocks with GIFTb-128.
+*****************************************************************************/
+TARGET_AVX2
+void giftb128_encrypt_x8(u8* ctext, const u8* ptext, const u32* rkey) {
+	__m256i tmp, state[4];
+	packingb_x8(state, ptext);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X8(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X8);
+	unpackingb_x8(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of 8 consecutive 128-bit blocks with GIFTb-128.
+*****************************************************************************/
+TARGET_AVX2
+void giftb128_decrypt_x8(u8* ptext, const u8* ctext, const u32* rkey) {
+	__m256i tmp, state[4];
+	packingb_x8(state, ctext);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X8(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X8);
+	unpackingb_x8(ptext, state);
+}
+
+/*****************************************************************************
+* Encryption of 8 consecutive 128-bit blocks with GIFT-128, the i-th block
+* being encrypted with the i-th key of the lane-interleaved round keys 'rkey'
+* (see 'gift128_multikey_ctx'). As 'packing_x8' interleaves the blocks of
+* both 128-bit lanes, the state is permuted so that the i-th 32-bit lane
+* holds the i-th block, as expected by the round keys.
+*****************************************************************************/
+TARGET_AVX2
+void gift128_encrypt_multikey_x8(u8* ctext, const u8* ptext, const u32* rkey) {
+	__m256i tmp, state[4];
+	const __m256i to_blocks = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	const __m256i to_lanes = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	packing_x8(state, ptext);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm256_permutevar8x32_epi32(state[i], to_blocks);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X8(state, rkey + i*2*GIFT128_LANES, rconst + i,
+			LANE_RKEY_X8);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm256_permutevar8x32_epi32(state[i], to_lanes);
+	unpacking_x8(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of 8 consecutive 128-bit blocks with GIFT-128, the i-th block
+* being decrypted with the i-th key of the lane-interleaved round keys 'rkey'.
+*****************************************************************************/
+TARGET_AVX2
+void gift128_decrypt_multikey_x8(u8* ptext, const u8* ctext, const u32* rkey) {
+	__m256i tmp, state[4];
+	const __m256i to_blocks = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	const __m256i to_lanes = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	packing_x8(state, ctext);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm256_permutevar8x32_epi32(state[i], to_blocks);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X8(state, rkey + i*2*GIFT128_LANES, rconst + i,
+			LANE_RKEY_X8);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm256_permutevar8x32_epi32(state[i], to_lanes);
+	unpacking_x8(ptext, state);
+}
+
+/*****************************************************************************
+* Rounds 'start' to 'end - 1' only of GIFT-128/GIFTb-128 on 8 consecutive
+* blocks (see 'ROUNDS_W' in 'fixsliced.h').
+*****************************************************************************/
+#define AVX2_ROUNDS_KERNEL(name, load, store, rounds)			\
+TARGET_AVX2														\
+static void name(u8* out, const u8* in, const u32* rkey, u32 start,	\
+				u32 end) {										\
+	__m256i tmp, state[4];										\
+	load(state, in);											\
+	rounds(state, rkey, rconst, start, end);					\
+	store(out, state);											\
+}
+
+AVX2_ROUNDS_KERNEL(gift128_encrypt_rounds_x8, packing_x8, unpacking_x8,
+	ROUNDS_X8)
+AVX2_ROUNDS_KERNEL(gift128_decrypt_rounds_x8, packing_x8, unpacking_x8,
+	INV_ROUNDS_X8)
+AVX2_ROUNDS_KERNEL(giftb128_encrypt_rounds_x8, packingb_x8, unpackingb_x8,
+	ROUNDS_X8)
+AVX2_ROUNDS_KERNEL(giftb128_decrypt_rounds_x8, packingb_x8, unpackingb_x8,
+	INV_ROUNDS_X8)
+
+/*****************************************************************************
+* Bulk functions of the AVX2 backend: batches of 8 blocks go through the
+* kernels above while the remaining blocks are processed by the portable
+* implementation.
+*****************************************************************************/
+#define AVX2_BULK(name, kernel, tail)							\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	for(; nblocks >= 8; nblocks -= 8) {							\
+		kernel(out, in, rkey);									\
+		in += 8*BLOCK_SIZE;										\
+		out += 8*BLOCK_SIZE;									\
+	}															\
+	get_scalar_backend()->tail(out, in, nblocks, rkey);			\
+}
+
+AVX2_BULK(gift128_encrypt_avx2, gift128_encrypt_x8, gift128_encrypt)
+AVX2_BULK(gift128_decrypt_avx2, gift128_decrypt_x8, gift128_decrypt)
+AVX2_BULK(giftb128_encrypt_avx2, giftb128_encrypt_x8, giftb128_encrypt)
+AVX2_BULK(giftb128_decrypt_avx2, giftb128_decrypt_x8, giftb128_decrypt)
+
+/*****************************************************************************
+* Same for the multi-key functions, where the round keys of the next batch
+* start 8 lanes further.
+*****************************************************************************/
+#define AVX2_MULTIKEY_BULK(name, kernel, tail)					\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	for(; nblocks >= 8; nblocks -= 8) {							\
+		kernel(out, in, rkey);									\
+		in += 8*BLOCK_SIZE;										\
+		out += 8*BLOCK_SIZE;									\
+		rkey += 8;												\
+	}															\
+	get_scalar_backend()->tail(out, in, nblocks, rkey);			\
+}
+
+AVX2_MULTIKEY_BULK(gift128_encrypt_multikey_avx2, gift128_encrypt_multikey_x8,
+	gift128_encrypt_multikey)
+AVX2_MULTIKEY_BULK(gift128_decrypt_multikey_avx2, gift128_decrypt_multikey_x8,
+	gift128_decrypt_multikey)
+
+#define AVX2_ROUNDS_BULK(name, kernel, tail)					\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+				u32 start, u32 end) {							\
+	for(; nblocks >= 8; nblocks -= 8) {							\
+		kernel(out, in, rkey, start, end);						\
+		in += 8*BLOCK_SIZE;										\
+		out += 8*BLOCK_SIZE;									\
+	}															\
+	get_scalar_backend()->tail(out, in, nblocks, rkey, start, end);	\
+}
+
+AVX2_ROUNDS_BULK(gift128_encrypt_rounds_avx2, gift128_encrypt_rounds_x8,
+	gift128_encrypt_rounds)
+AVX2_ROUNDS_BULK(gift128_decrypt_rounds_avx2, gift128_decrypt_rounds_x8,
+	gift128_decrypt_rounds)
+AVX2_ROUNDS_BULK(giftb128_encrypt_rounds_avx2, giftb128_encrypt_rounds_x8,
+	giftb128_encrypt_rounds)
+AVX2_ROUNDS_BULK(giftb128_decrypt_rounds_avx2, giftb128_decrypt_rounds_x8,
+	giftb128_decrypt_rounds)
+
+/*****************************************************************************
+* Batched key schedules, the key of the i-th block being processed in the i-th
+* 32-bit lane of AVX2 registers.
+*****************************************************************************/
+PRECOMPUTE_RKEYS_XN(precompute_rkeys_x8_avx2, 8, static TARGET_AVX2)
+
+static void precompute_rkeys_x16_avx2(u32 (*rkeys)[80],
+				const u8 (*keys)[KEY_SIZE]) {
+	precompute_rkeys_x8_avx2(rkeys, keys);
+	precompute_rkeys_x8_avx2(rkeys + 8, keys + 8);
+}
+
+PRECOMPUTE_MULTIKEY_RKEYS_XN(precompute_multikey_rkeys_x8_avx2, 8,
+	static TARGET_AVX2)
+
+static void precompute_multikey_rkeys_avx2(u32* rkeys,
+				const u8 (*keys)[KEY_SIZE]) {
+	precompute_multikey_rkeys_x8_avx2(rkeys, keys);
+	precompute_multikey_rkeys_x8_avx2(rkeys + 8, keys + 8);
+}
+
+static int avx2_supported(void) {
+	return __builtin_cpu_supports("avx2");
+}
+
+const backend_t backend_avx2 = {
+	"avx2",
+	avx2_supported,
+	gift128_encrypt_avx2,
+	gift128_decrypt_avx2,
+	giftb128_encrypt_avx2,
+	giftb128_decrypt_avx2,
+	precompute_rkeys_x8_avx2,
+	precompute_rkeys_x16_avx2,
+	precompute_multikey_rkeys_avx2,
+	gift128_encrypt_multikey_avx2,
+	gift128_decrypt_multikey_avx2,
+	gift128_encrypt_rounds_avx2,
+	gift128_decrypt_rounds_avx2,
+	giftb128_encrypt_rounds_avx2,
+	giftb128_decrypt_rounds_avx2
+};
+
+#endif  // GIFT128_AVX2
@@ -0,0 +1,347 @@
+/*******************************************************************************
+* Constant-time AVX-512 implementation of the GIFT-128 block cipher processing
+* up to 16 blocks in parallel.
+*
+* Each 32-bit lane of the 4 '__m512i' words holds the fixsliced state of a
+* different block. Only AVX-512F instructions are used: byte shuffles are
+* replaced by rotations and 'vpternlogd' merges. Batches of less than 16
+* blocks are handled with masked loads/stores.
+*
+* See "Fixslicing: A New GIFT Representation" paper available at
+* https://eprint.iacr.org/2020/412.pdf for more details on the fixsliced
+* representation.
+*******************************************************************************/
+#include "gift128_avx512.h"
+#include "endian.h"
+#include "gift128.h"
+#include "key_schedule.h"
+
+#ifdef GIFT128_AVX512
+
+extern const u32 rconst[40];
+
+/*****************************************************************************
+* Transposes the 32-bit words within each 128-bit lane of 'r0', ..., 'r3' so
+* that the i-th output word gathers the i-th word of every input. The
+* transposition is an involution and is used for both packing and unpacking.
+*****************************************************************************/
+TARGET_AVX512
+static inline void transpose_x16(__m512i* s, __m512i r0, __m512i r1,
+				__m512i r2, __m512i r3) {
+	__m512i t0 = _mm512_unpacklo_epi32(r0, r1);
+	__m512i t1 = _mm512_unpackhi_epi32(r0, r1);
+	__m512i t2 = _mm512_unpacklo_epi32(r2, r3);
+	__m512i t3 = _mm512_unpackhi_epi32(r2, r3);
+	s[0] = _mm512_unpacklo_epi64(t0, t2);
+	s[1] = _mm512_unpackhi_epi64(t0, t2);
+	s[2] = _mm512_unpacklo_epi64(t1, t3);
+	s[3] = _mm512_unpackhi_epi64(t1, t3);
+}
+
+/*****************************************************************************
+* Byte swap of each 32-bit lane.
+*****************************************************************************/
+TARGET_AVX512
+static inline __m512i bswap_x16(__m512i x) {
+	return SELECT_X16(SET1_X16(0xff00ff00), ROR_X16(x, 8), ROR_X16(x, 24));
+}
+
+/*****************************************************************************
+* Returns the mask of the 32-bit lanes of the i-th 64-byte chunk that belong
+* to one of the 'nblocks' blocks to process.
+*****************************************************************************/
+static inline __mmask16 chunk_mask(u32 nblocks, int i) {
+	if(nblocks >= (u32)(4*i + 4))
+		return 0xffff;
+	if(nblocks <= (u32)(4*i))
+		return 0;
+	return (__mmask16)((1u << (4*(nblocks - 4*i))) - 1);
+}
+
+/*****************************************************************************
+* Rearranges up to 16 input blocks in a row-wise bitsliced manner. Each block
+* is loaded as 4 big-endian words W0, ..., W3 which are transposed so that a
+* register holds the same word of all blocks, before building the 4 words of
+* the scalar 'packing' by merging their 16-bit halves.
+*****************************************************************************/
+TARGET_AVX512
+static inline void packing_x16(__m512i* state, const u8* input, u32 nblocks) {
+	__m512i tmp, w[4];
+	const __m512i hi = SET1_X16(0xffff0000);
+	for(int i = 0; i < 4; i++) {
+		state[i] = _mm512_maskz_loadu_epi32(chunk_mask(nblocks, i),
+			input + 64*i);
+		state[i] = bswap_x16(state[i]);
+	}
+	transpose_x16(w, state[0], state[1], state[2], state[3]);
+	state[0] = SELECT_X16(hi, _mm512_slli_epi32(w[1], 16), w[3]);
+	state[1] = SELECT_X16(hi, w[1], _mm512_srli_epi32(w[3], 16));
+	state[2] = SELECT_X16(hi, _mm512_slli_epi32(w[0], 16), w[2]);
+	state[3] = SELECT_X16(hi, w[0], _mm512_srli_epi32(w[2], 16));
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_1_X16(state[i], 0x0a0a0a0a, 3);
+		SWAPMOVE_1_X16(state[i], 0x00cc00cc, 6);
+	}
+	SWAPMOVE_X16(state[0], state[1], 0x000f000f, 4);
+	SWAPMOVE_X16(state[0], state[2], 0x000f000f, 8);
+	SWAPMOVE_X16(state[0], state[3], 0x000f000f, 12);
+	SWAPMOVE_X16(state[1], state[2], 0x00f000f0, 4);
+	SWAPMOVE_X16(state[1], state[3], 0x00f000f0, 8);
+	SWAPMOVE_X16(state[2], state[3], 0x0f000f00, 4);
+}
+
+/*****************************************************************************
+* Fills the output from the internal state of up to 16 blocks.
+*****************************************************************************/
+TARGET_AVX512
+static inline void unpacking_x16(u8* output, __m512i* state, u32 nblocks) {
+	__m512i tmp, w[4];
+	const __m512i hi = SET1_X16(0xffff0000);
+	SWAPMOVE_X16(state[2], state[3], 0x0f000f00, 4);
+	SWAPMOVE_X16(state[1], state[3], 0x00f000f0, 8);
+	SWAPMOVE_X16(state[1], state[2], 0x00f000f0, 4);
+	SWAPMOVE_X16(state[0], state[3], 0x000f000f, 12);
+	SWAPMOVE_X16(state[0], state[2], 0x000f000f, 8);
+	SWAPMOVE_X16(state[0], state[1], 0x000f000f, 4);
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_1_X16(state[i], 0x00cc00cc, 6);
+		SWAPMOVE_1_X16(state[i], 0x0a0a0a0a, 3);
+	}
+	w[0] = SELECT_X16(hi, state[3], _mm512_srli_epi32(state[2], 16));
+	w[1] = SELECT_X16(hi, state[1], _mm512_srli_epi32(state[0], 16));
+	w[2] = SELECT_X16(hi, _mm512_slli_epi32(state[3], 16), state[2]);
+	w[3] = SELECT_X16(hi, _mm512_slli_epi32(state[1], 16), state[0]);
+	transpose_x16(state, w[0], w[1], w[2], w[3]);
+	for(int i = 0; i < 4; i++)
+		_mm512_mask_storeu_epi32(output + 64*i, chunk_mask(nblocks, i),
+			bswap_x16(state[i]));
+}
+
+/*****************************************************************************
+* Fills the internal state with up to 16 input blocks for GIFTb-128, for which
+* the input is expected to be already in a row-wise bitsliced representation.
+*****************************************************************************/
+TARGET_AVX512
+static inline void packingb_x16(__m512i* state, const u8* input, u32 nblocks) {
+	__m512i w[4];
+	for(int i = 0; i < 4; i++) {
+		w[i] = _mm512_maskz_loadu_epi32(chunk_mask(nblocks, i), input + 64*i);
+		w[i] = bswap_x16(w[i]);
+	}
+	transpose_x16(state, w[0], w[1], w[2], w[3]);
+}
+
+/*****************************************************************************
+* Fills the output from the internal GIFTb-128 state of up to 16 blocks.
+*****************************************************************************/
+TARGET_AVX512
+static inline void unpackingb_x16(u8* output, const __m512i* state,
+				u32 nblocks) {
+	__m512i w[4];
+	transpose_x16(w, state[0], state[1], state[2], state[3]);
+	for(int i = 0; i < 4; i++)
+		_mm512_mask_storeu_epi32(output + 64*i, chunk_mask(nblocks, i),
+			bswap_x16(w[i]));
+}
+
+/*****************************************************************************
+* Encryption of 'nblocks' (at most 16) consecutive 128-bit blocks with
+* GIFT-128.
+*****************************************************************************/
+TARGET_AVX512
+void gift128_encrypt_x16(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey) {
+	__m512i tmp, state[4];
+	packing_x16(state, ptext, nblocks);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X16(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X16);
+	unpacking_x16(ctext, state, nblocks);
+}
+
+/*****************************************************************************
+* Decryption of 'nblocks' (at most 16) consecutive 128-bit blocks with
+* GIFT-128.
+*****************************************************************************/
+TARGET_AVX512
+void gift128_decrypt_x16(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey) {
+	__m512i tmp, state[4];
+	packing_x16(state, ctext, nblocks);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X16(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X16);
+	unpacking_x16(ptext, state, nblocks);
+}
+
+/*****************************************************************************
+* Encryption of 'nblocks' (at most 16) consecutive 128-bit blocks with
+* GIFTb-128.
+*****************************************************************************/
+TARGET_AVX512
+void giftb128_encrypt_x16(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey) {
+	__m512i tmp, state[4];
+	packingb_x16(state, ptext, nblocks);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X16(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X16);
+	unpackingb_x16(ctext, state, nblocks);
+}
+
+/*****************************************************************************
+* Decryption of 'nblocks' (at most 16) consecutive 128-bit blocks with
+* GIFTb-128.
+*****************************************************************************/
+TARGET_AVX512
+void giftb128_decrypt_x16(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey) {
+	__m512i tmp, state[4];
+	packingb_x16(state, ctext, nblocks);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X16(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X16);
+	unpackingb_x16(ptext, state, nblocks);
+}
+
+/*****************************************************************************
+* Encryption of 'nblocks' (at most 16) consecutive 128-bit blocks with
+* GIFT-128, the i-th block being encrypted with the i-th key of the
+* lane-interleaved round keys 'rkey' (see 'gift128_multikey_ctx'). As
+* 'packing_x16' interleaves the blocks of the 4 128-bit lanes, the state is
+* transposed so that the i-th 32-bit lane holds the i-th block, as expected by
+* the round keys.
+*****************************************************************************/
+TARGET_AVX512
+void gift128_encrypt_multikey_x16(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey) {
+	__m512i tmp, state[4];
+	const __m512i idx = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13,
+		2, 6, 10, 14, 3, 7, 11, 15);
+	packing_x16(state, ptext, nblocks);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm512_permutexvar_epi32(idx, state[i]);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X16(state, rkey + i*2*GIFT128_LANES, rconst + i,
+			LANE_RKEY_X16);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm512_permutexvar_epi32(idx, state[i]);
+	unpacking_x16(ctext, state, nblocks);
+}
+
+/*****************************************************************************
+* Decryption of 'nblocks' (at most 16) consecutive 128-bit blocks with
+* GIFT-128, the i-th block being decrypted with the i-th key of the
+* lane-interleaved round keys 'rkey'.
+*****************************************************************************/
+TARGET_AVX512
+void gift128_decrypt_multikey_x16(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey) {
+	__m512i tmp, state[4];
+	const __m512i idx = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13,
+		2, 6, 10, 14, 3, 7, 11, 15);
+	packing_x16(state, ctext, nblocks);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm512_permutexvar_epi32(idx, state[i]);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X16(state, rkey + i*2*GIFT128_LANES, rconst + i,
+			LANE_RKEY_X16);
+	for(int i = 0; i < 4; i++)
+		state[i] = _mm512_permutexvar_epi32(idx, state[i]);
+	unpacking_x16(ptext, state, nblocks);
+}
+
+/*****************************************************************************
+* Rounds 'start' to 'end - 1' only of GIFT-128/GIFTb-128 on 'nblocks' (at most
+* 16) consecutive blocks (see 'ROUNDS_W' in 'fixsliced.h').
+*****************************************************************************/
+#define AVX512_ROUNDS_KERNEL(name, load, store, rounds)			\
+TARGET_AVX512													\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+				u32 start, u32 end) {							\
+	__m512i tmp, state[4];										\
+	load(state, in, nblocks);									\
+	rounds(state, rkey, rconst, start, end);					\
+	store(out, state, nblocks);									\
+}
+
+AVX512_ROUNDS_KERNEL(gift128_encrypt_rounds_x16, packing_x16, unpacking_x16,
+	ROUNDS_X16)
+AVX512_ROUNDS_KERNEL(gift128_decrypt_rounds_x16, packing_x16, unpacking_x16,
+	INV_ROUNDS_X16)
+AVX512_ROUNDS_KERNEL(giftb128_encrypt_rounds_x16, packingb_x16,
+	unpackingb_x16, ROUNDS_X16)
+AVX512_ROUNDS_KERNEL(giftb128_decrypt_rounds_x16, packingb_x16,
+	unpackingb_x16, INV_ROUNDS_X16)
+
+/*****************************************************************************
+* Bulk functions of the AVX-512 backend: the last batch of less than 16 blocks
+* is processed by the same kernels thanks to masked loads/stores.
+*****************************************************************************/
+#define AVX512_BULK(name, kernel)								\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	while(nblocks > 0) {										\
+		u32 n = (nblocks >= 16) ? 16 : nblocks;					\
+		kernel(out, in, n, rkey);								\
+		in += n*BLOCK_SIZE;										\
+		out += n*BLOCK_SIZE;									\
+		nblocks -= n;											\
+	}															\
+}
+
+AVX512_BULK(gift128_encrypt_avx512, gift128_encrypt_x16)
+AVX512_BULK(gift128_decrypt_avx512, gift128_decrypt_x16)
+AVX512_BULK(giftb128_encrypt_avx512, giftb128_encrypt_x16)
+AVX512_BULK(giftb128_decrypt_avx512, giftb128_decrypt_x16)
+AVX512_BULK(gift128_encrypt_multikey_avx512, gift128_encrypt_multikey_x16)
+AVX512_BULK(gift128_decrypt_multikey_avx512, gift128_decrypt_multikey_x16)
+
+#define AVX512_ROUNDS_BULK(name, kernel)						\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+				u32 start, u32 end) {							\
+	while(nblocks > 0) {										\
+		u32 n = (nblocks >= 16) ? 16 : nblocks;					\
+		kernel(out, in, n, rkey, start, end);					\
+		in += n*BLOCK_SIZE;										\
+		out += n*BLOCK_SIZE;									\
+		nblocks -= n;											\
+	}															\
+}
+
+AVX512_ROUNDS_BULK(gift128_encrypt_rounds_avx512, gift128_encrypt_rounds_x16)
+AVX512_ROUNDS_BULK(gift128_decrypt_rounds_avx512, gift128_decrypt_rounds_x16)
+AVX512_ROUNDS_BULK(giftb128_encrypt_rounds_avx512, giftb128_encrypt_rounds_x16)
+AVX512_ROUNDS_BULK(giftb128_decrypt_rounds_avx512, giftb128_decrypt_rounds_x16)
+
+/*****************************************************************************
+* Batched key schedules, the key of the i-th block being processed in the i-th
+* 32-bit lane of AVX-512 registers.
+*****************************************************************************/
+PRECOMPUTE_RKEYS_XN(precompute_rkeys_x8_avx512, 8, static TARGET_AVX512)
+PRECOMPUTE_RKEYS_XN(precompute_rkeys_x16_avx512, 16, static TARGET_AVX512)
+PRECOMPUTE_MULTIKEY_RKEYS_XN(precompute_multikey_rkeys_avx512, 16,
+	static TARGET_AVX512)
+
+static int avx512_supported(void) {
+	return __builtin_cpu_supports("avx512f");
+}
+
+const backend_t backend_avx512 = {
+	"avx512",
+	avx512_supported,
+	gift128_encrypt_avx512,
+	gift128_decrypt_avx512,
+	giftb128_encrypt_avx512,
+	giftb128_decrypt_avx512,
+	precompute_rkeys_x8_avx512,
+	precompute_rkeys_x16_avx512,
+	precompute_multikey_rkeys_avx512,
+	gift128_encrypt_multikey_avx512,
+	gift128_decrypt_multikey_avx512,
+	gift128_encrypt_rounds_avx512,
+	gift128_decrypt_rounds_avx512,
+	giftb128_encrypt_rounds_avx512,
+	giftb128_decrypt_rounds_avx512
+};
+
+#endif  // GIFT128_AVX512
@@ -0,0 +1,190 @@
+/*******************************************************************************
+* Constant-time scalar implementation of GIFT-128 for x86-64 processors
+* supporting the BMI1/BMI2 extensions, aimed at single-block latency (e.g.
+* the sequential chain of GIFT-COFB) rather than throughput.
+*
+* Compared to 'encrypt.c':
+*	- the NOT of every S-box is removed by keeping track of complemented state
+*	words and using 'andn' where needed (see 'gift128_bmi2.h'),
+*	- 'ROR' is computed by 'rorx', which does not overwrite its source,
+*	- 'packing'/'unpacking' are 8 'pext'/'pdep' instead of 14 SWAPMOVEs.
+*
+* Note that 'pdep'/'pext' are microcoded and slow on AMD processors prior to
+* Zen 3, on which this backend is only used if explicitly selected (see
+* 'bmi2_preferred').
+*******************************************************************************/
+#include <cpuid.h>
+#include <string.h>
+#include "gift128_bmi2.h"
+#include "endian.h"
+#include "gift128.h"
+
+#ifdef GIFT128_BMI2
+
+extern const u32 rconst[40];
+
+// bits of the input at the same position within a nibble end up in one word
+#define NIBBLE_BIT_0	0x1111111111111111ULL
+
+#define LOAD64_BE(p)										\
+	(((u64)LOAD32_BE(p) << 32) | LOAD32_BE((p) + 4))
+
+#define STORE64_BE(p, y)									\
+	STORE32_BE(p, (u32)((y) >> 32));						\
+	STORE32_BE((p) + 4, (u32)(y));
+
+/*****************************************************************************
+* Same as 'packing' in 'encrypt.c': the i-th word gathers the bits i, i+4,
+* i+8, ... of the first 8 bytes (big-endian) in its upper half and of the last
+* 8 bytes in its lower half.
+*****************************************************************************/
+#define PEXT_WORD(hi, lo, i)								\
+	((u32)(_pext_u64(hi, NIBBLE_BIT_0 << (i)) << 16) |		\
+	 (u32)_pext_u64(lo, NIBBLE_BIT_0 << (i)))
+
+TARGET_BMI2
+static inline void packing_bmi2(u32* state, const u8* input) {
+	u64 hi = LOAD64_BE(input), lo = LOAD64_BE(input + 8);
+	state[0] = PEXT_WORD(hi, lo, 0);
+	state[1] = PEXT_WORD(hi, lo, 1);
+	state[2] = PEXT_WORD(hi, lo, 2);
+	state[3] = PEXT_WORD(hi, lo, 3);
+}
+
+/*****************************************************************************
+* Same as 'unpacking' in 'encrypt.c'.
+*****************************************************************************/
+TARGET_BMI2
+static inline void unpacking_bmi2(u8* output, const u32* state) {
+	u64 hi, lo;
+	hi = _pdep_u64(state[0] >> 16, NIBBLE_BIT_0);
+	hi |= _pdep_u64(state[1] >> 16, NIBBLE_BIT_0 << 1);
+	hi |= _pdep_u64(state[2] >> 16, NIBBLE_BIT_0 << 2);
+	hi |= _pdep_u64(state[3] >> 16, NIBBLE_BIT_0 << 3);
+	lo = _pdep_u64(state[0] & 0xffff, NIBBLE_BIT_0);
+	lo |= _pdep_u64(state[1] & 0xffff, NIBBLE_BIT_0 << 1);
+	lo |= _pdep_u64(state[2] & 0xffff, NIBBLE_BIT_0 << 2);
+	lo |= _pdep_u64(state[3] & 0xffff, NIBBLE_BIT_0 << 3);
+	STORE64_BE(output, hi);
+	STORE64_BE(output + 8, lo);
+}
+
+/*****************************************************************************
+* Encryption/decryption of a single block, the state being complemented back
+* after the last round according to the flags.
+*****************************************************************************/
+#define BMI2_BLOCK(name, load, store, round, start, end, step)	\
+TARGET_BMI2														\
+static inline void name(u8* out, const u8* in, const u32* rkey) {	\
+	u32 tmp, state[4], neg[4] = {0};							\
+	load;														\
+	_Pragma("GCC unroll 8")										\
+	for(int i = (start); i != (end); i += (step))				\
+		round(state, neg, rkey + i*2, rconst + i);				\
+	state[0] ^= -neg[0];										\
+	state[1] ^= -neg[1];										\
+	state[2] ^= -neg[2];										\
+	state[3] ^= -neg[3];										\
+	store;														\
+}
+
+BMI2_BLOCK(encrypt_block_bmi2, packing_bmi2(state, in),
+	unpacking_bmi2(out, state), QUINTUPLE_ROUND_NEG, 0, 40, 5)
+BMI2_BLOCK(decrypt_block_bmi2, packing_bmi2(state, in),
+	unpacking_bmi2(out, state), INV_QUINTUPLE_ROUND_NEG, 35, -5, -5)
+
+#define LOAD_B(state, in)										\
+	state[0] = LOAD32_BE(in);									\
+	state[1] = LOAD32_BE((in) + 4);								\
+	state[2] = LOAD32_BE((in) + 8);								\
+	state[3] = LOAD32_BE((in) + 12)
+#define STORE_B(out, state)										\
+	STORE32_BE(out, state[0]);									\
+	STORE32_BE((out) + 4, state[1]);							\
+	STORE32_BE((out) + 8, state[2]);							\
+	STORE32_BE((out) + 12, state[3])
+
+BMI2_BLOCK(encryptb_block_bmi2, LOAD_B(state, in), STORE_B(out, state),
+	QUINTUPLE_ROUND_NEG, 0, 40, 5)
+BMI2_BLOCK(decryptb_block_bmi2, LOAD_B(state, in), STORE_B(out, state),
+	INV_QUINTUPLE_ROUND_NEG, 35, -5, -5)
+
+/*****************************************************************************
+* Bulk functions processing one block at a time, as in the portable backend.
+*****************************************************************************/
+#define BMI2_BULK(name, block_fn)								\
+TARGET_BMI2														\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	for(; nblocks > 0; nblocks--) {								\
+		block_fn(out, in, rkey);								\
+		in += BLOCK_SIZE;										\
+		out += BLOCK_SIZE;										\
+	}															\
+}
+
+BMI2_BULK(gift128_encrypt_bmi2, encrypt_block_bmi2)
+BMI2_BULK(gift128_decrypt_bmi2, decrypt_block_bmi2)
+BMI2_BULK(giftb128_encrypt_bmi2, encryptb_block_bmi2)
+BMI2_BULK(giftb128_decrypt_bmi2, decryptb_block_bmi2)
+
+#define BMI2_MULTIKEY_BULK(name, block_fn)						\
+TARGET_BMI2														\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	u32 lane_rkey[80];											\
+	for(u32 j = 0; j < nblocks; j++) {							\
+		for(int i = 0; i < 80; i++)								\
+			lane_rkey[i] = rkey[i*GIFT128_LANES + j];			\
+		block_fn(out, in, lane_rkey);							\
+		in += BLOCK_SIZE;										\
+		out += BLOCK_SIZE;										\
+	}															\
+}
+
+BMI2_MULTIKEY_BULK(gift128_encrypt_multikey_bmi2, encrypt_block_bmi2)
+BMI2_MULTIKEY_BULK(gift128_decrypt_multikey_bmi2, decrypt_block_bmi2)
+
+static int bmi2_supported(void) {
+	return __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+}
+
+/*****************************************************************************
+* Returns 0 on processors with microcoded 'pdep'/'pext', i.e. AMD (and Hygon)
+* processors of family below 19h (Zen 3), 1 otherwise.
+*****************************************************************************/
+int bmi2_preferred(void) {
+	unsigned int eax, ebx, ecx, edx, family;
+	char vendor[12];
+	if(!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+		return 0;
+	memcpy(vendor, &ebx, 4);
+	memcpy(vendor + 4, &edx, 4);
+	memcpy(vendor + 8, &ecx, 4);
+	if(memcmp(vendor, "AuthenticAMD", 12) && memcmp(vendor, "HygonGenuine", 12))
+		return 1;
+	if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return 0;
+	family = (eax >> 8) & 0xf;
+	if(family == 0xf)
+		family += (eax >> 20) & 0xff;
+	return family >= 0x19;
+}
+
+const backend_t backend_bmi2 = {
+	"bmi2",
+	bmi2_supported,
+	gift128_encrypt_bmi2,
+	gift128_decrypt_bmi2,
+	giftb128_encrypt_bmi2,
+	giftb128_decrypt_bmi2,
+	precompute_rkeys_x8_portable,
+	precompute_rkeys_x16_portable,
+	precompute_multikey_rkeys_portable,
+	gift128_encrypt_multikey_bmi2,
+	gift128_decrypt_multikey_bmi2,
+	gift128_encrypt_rounds_portable,
+	gift128_decrypt_rounds_portable,
+	giftb128_encrypt_rounds_portable,
+	giftb128_decrypt_rounds_portable
+};
+
+#endif  // GIFT128_BMI2
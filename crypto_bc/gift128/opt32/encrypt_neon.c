@@ -0,0 +1,293 @@
+/*******************************************************************************
+* Constant-time NEON implementation of the GIFT-128 block cipher processing 4
+* blocks in parallel, for AArch64 processors.
+*
+* Each 32-bit lane of the 4 'uint32x4_t' words holds the fixsliced state of a
+* different block so that the round function is exactly the same as in
+* 'encrypt.c', only applied on 4 blocks at once. Rotations within bytes and
+* halfwords are computed on 8/16-bit elements with a shift and a
+* shift-left-insert ('vsli'), and rotations by 16 bits or within halfwords by
+* 8 bits are single element reversals ('vrev').
+*
+* See "Fixslicing: A New GIFT Representation" paper available at
+* https://eprint.iacr.org/2020/412.pdf for more details on the fixsliced
+* representation.
+*******************************************************************************/
+#include "gift128_neon.h"
+#include "endian.h"
+#include "gift128.h"
+
+#ifdef GIFT128_NEON
+
+extern const u32 rconst[40];
+
+/*****************************************************************************
+* Transposes 'r0', ..., 'r3' so that the i-th output word gathers the i-th
+* 32-bit lane of every input. The transposition is an involution and is used
+* for both packing and unpacking.
+*****************************************************************************/
+static inline void transpose_x4(uint32x4_t* s, uint32x4_t r0, uint32x4_t r1,
+				uint32x4_t r2, uint32x4_t r3) {
+	uint64x2_t t0 = vreinterpretq_u64_u32(vtrn1q_u32(r0, r1));
+	uint64x2_t t1 = vreinterpretq_u64_u32(vtrn2q_u32(r0, r1));
+	uint64x2_t t2 = vreinterpretq_u64_u32(vtrn1q_u32(r2, r3));
+	uint64x2_t t3 = vreinterpretq_u64_u32(vtrn2q_u32(r2, r3));
+	s[0] = vreinterpretq_u32_u64(vtrn1q_u64(t0, t2));
+	s[1] = vreinterpretq_u32_u64(vtrn1q_u64(t1, t3));
+	s[2] = vreinterpretq_u32_u64(vtrn2q_u64(t0, t2));
+	s[3] = vreinterpretq_u32_u64(vtrn2q_u64(t1, t3));
+}
+
+/*****************************************************************************
+* Rearranges 4 input blocks in a row-wise bitsliced manner. A table lookup
+* builds the 4 words of the scalar 'packing' for each block before they are
+* transposed so that state[i] holds the i-th word of all blocks, the j-th
+* lane holding the j-th block.
+*****************************************************************************/
+static inline void packing_x4(uint32x4_t* state, const u8* input) {
+	uint32x4_t tmp, r[4];
+	const uint8x16_t shuffle = {
+		15, 14, 7, 6, 13, 12, 5, 4, 11, 10, 3, 2, 9, 8, 1, 0};
+	for(int i = 0; i < 4; i++)
+		r[i] = U32_X4_U8(vqtbl1q_u8(vld1q_u8(input + 16*i), shuffle));
+	transpose_x4(state, r[0], r[1], r[2], r[3]);
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_X4(state[i], state[i], 0x0a0a0a0a, 3);
+		SWAPMOVE_X4(state[i], state[i], 0x00cc00cc, 6);
+	}
+	SWAPMOVE_X4(state[0], state[1], 0x000f000f, 4);
+	SWAPMOVE_X4(state[0], state[2], 0x000f000f, 8);
+	SWAPMOVE_X4(state[0], state[3], 0x000f000f, 12);
+	SWAPMOVE_X4(state[1], state[2], 0x00f000f0, 4);
+	SWAPMOVE_X4(state[1], state[3], 0x00f000f0, 8);
+	SWAPMOVE_X4(state[2], state[3], 0x0f000f00, 4);
+}
+
+/*****************************************************************************
+* Fills the output from the internal state of 4 blocks.
+*****************************************************************************/
+static inline void unpacking_x4(u8* output, uint32x4_t* state) {
+	uint32x4_t tmp, r[4];
+	const uint8x16_t shuffle = {
+		15, 14, 11, 10, 7, 6, 3, 2, 13, 12, 9, 8, 5, 4, 1, 0};
+	SWAPMOVE_X4(state[2], state[3], 0x0f000f00, 4);
+	SWAPMOVE_X4(state[1], state[3], 0x00f000f0, 8);
+	SWAPMOVE_X4(state[1], state[2], 0x00f000f0, 4);
+	SWAPMOVE_X4(state[0], state[3], 0x000f000f, 12);
+	SWAPMOVE_X4(state[0], state[2], 0x000f000f, 8);
+	SWAPMOVE_X4(state[0], state[1], 0x000f000f, 4);
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_X4(state[i], state[i], 0x00cc00cc, 6);
+		SWAPMOVE_X4(state[i], state[i], 0x0a0a0a0a, 3);
+	}
+	transpose_x4(r, state[0], state[1], state[2], state[3]);
+	for(int i = 0; i < 4; i++)
+		vst1q_u8(output + 16*i, vqtbl1q_u8(U8_X4(r[i]), shuffle));
+}
+
+/*****************************************************************************
+* Fills the internal state with 4 input blocks for GIFTb-128, for which the
+* input is expected to be already in a row-wise bitsliced representation.
+*****************************************************************************/
+static inline void packingb_x4(uint32x4_t* state, const u8* input) {
+	uint32x4_t r[4];
+	for(int i = 0; i < 4; i++)
+		r[i] = U32_X4_U8(vrev32q_u8(vld1q_u8(input + 16*i)));
+	transpose_x4(state, r[0], r[1], r[2], r[3]);
+}
+
+/*****************************************************************************
+* Fills the output from the internal GIFTb-128 state of 4 blocks.
+*****************************************************************************/
+static inline void unpackingb_x4(u8* output, const uint32x4_t* state) {
+	uint32x4_t r[4];
+	transpose_x4(r, state[0], state[1], state[2], state[3]);
+	for(int i = 0; i < 4; i++)
+		vst1q_u8(output + 16*i, vrev32q_u8(U8_X4(r[i])));
+}
+
+/*****************************************************************************
+* Encryption of 4 consecutive 128-bit blocks with GIFT-128.
+*****************************************************************************/
+void gift128_encrypt_x4(u8* ctext, const u8* ptext, const u32* rkey) {
+	uint32x4_t tmp, state[4];
+	packing_x4(state, ptext);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X4(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X4);
+	unpacking_x4(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of 4 consecutive 128-bit blocks with GIFT-128.
+*****************************************************************************/
+void gift128_decrypt_x4(u8* ptext, const u8* ctext, const u32* rkey) {
+	uint32x4_t tmp, state[4];
+	packing_x4(state, ctext);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X4(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X4);
+	unpacking_x4(ptext, state);
+}
+
+/*****************************************************************************
+* Encryption of 4 consecutive 128-bit blocks with GIFTb-128.
+*****************************************************************************/
+void giftb128_encrypt_x4(u8* ctext, const u8* ptext, const u32* rkey) {
+	uint32x4_t tmp, state[4];
+	packingb_x4(state, ptext);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X4(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X4);
+	unpackingb_x4(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of 4 consecutive 128-bit blocks with GIFTb-128.
+*****************************************************************************/
+void giftb128_decrypt_x4(u8* ptext, const u8* ctext, const u32* rkey) {
+	uint32x4_t tmp, state[4];
+	packingb_x4(state, ctext);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X4(state, rkey + i*2, rconst + i,
+			BCAST_RKEY_X4);
+	unpackingb_x4(ptext, state);
+}
+
+/*****************************************************************************
+* Encryption of 4 consecutive 128-bit blocks with GIFT-128, the i-th block
+* being encrypted with the i-th key of the lane-interleaved round keys 'rkey'
+* (see 'gift128_multikey_ctx'). Contrary to AVX2, the i-th lane already holds
+* the i-th block after packing.
+*****************************************************************************/
+void gift128_encrypt_multikey_x4(u8* ctext, const u8* ptext, const u32* rkey) {
+	uint32x4_t tmp, state[4];
+	packing_x4(state, ptext);
+	for(int i = 0; i < 40; i+=5)
+		QUINTUPLE_ROUND_X4(state, rkey + i*2*GIFT128_LANES, rconst + i,
+			LANE_RKEY_X4);
+	unpacking_x4(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of 4 consecutive 128-bit blocks with GIFT-128, the i-th block
+* being decrypted with the i-th key of the lane-interleaved round keys 'rkey'.
+*****************************************************************************/
+void gift128_decrypt_multikey_x4(u8* ptext, const u8* ctext, const u32* rkey) {
+	uint32x4_t tmp, state[4];
+	packing_x4(state, ctext);
+	for(int i = 35; i >= 0; i-=5)
+		INV_QUINTUPLE_ROUND_X4(state, rkey + i*2*GIFT128_LANES, rconst + i,
+			LANE_RKEY_X4);
+	unpacking_x4(ptext, state);
+}
+
+/*****************************************************************************
+* Rounds 'start' to 'end - 1' only of GIFT-128/GIFTb-128 on 4 consecutive
+* blocks (see 'ROUNDS_W' in 'fixsliced.h').
+*****************************************************************************/
+#define NEON_ROUNDS_KERNEL(name, load, store, rounds)			\
+static void name(u8* out, const u8* in, const u32* rkey, u32 start,	\
+				u32 end) {										\
+	uint32x4_t tmp, state[4];									\
+	load(state, in);											\
+	rounds(state, rkey, rconst, start, end);					\
+	store(out, state);											\
+}
+
+NEON_ROUNDS_KERNEL(gift128_encrypt_rounds_x4, packing_x4, unpacking_x4,
+	ROUNDS_X4)
+NEON_ROUNDS_KERNEL(gift128_decrypt_rounds_x4, packing_x4, unpacking_x4,
+	INV_ROUNDS_X4)
+NEON_ROUNDS_KERNEL(giftb128_encrypt_rounds_x4, packingb_x4, unpackingb_x4,
+	ROUNDS_X4)
+NEON_ROUNDS_KERNEL(giftb128_decrypt_rounds_x4, packingb_x4, unpackingb_x4,
+	INV_ROUNDS_X4)
+
+/*****************************************************************************
+* Bulk functions of the NEON backend: batches of 4 blocks go through the
+* kernels above while the remaining blocks are processed by the portable
+* implementation.
+*****************************************************************************/
+#define NEON_BULK(name, kernel, tail)							\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	for(; nblocks >= 4; nblocks -= 4) {							\
+		kernel(out, in, rkey);									\
+		in += 4*BLOCK_SIZE;										\
+		out += 4*BLOCK_SIZE;									\
+	}															\
+	get_scalar_backend()->tail(out, in, nblocks, rkey);			\
+}
+
+NEON_BULK(gift128_encrypt_neon, gift128_encrypt_x4, gift128_encrypt)
+NEON_BULK(gift128_decrypt_neon, gift128_decrypt_x4, gift128_decrypt)
+NEON_BULK(giftb128_encrypt_neon, giftb128_encrypt_x4, giftb128_encrypt)
+NEON_BULK(giftb128_decrypt_neon, giftb128_decrypt_x4, giftb128_decrypt)
+
+/*****************************************************************************
+* Same for the multi-key functions, where the round keys of the next batch
+* start 4 lanes further.
+*****************************************************************************/
+#define NEON_MULTIKEY_BULK(name, kernel, tail)					\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	for(; nblocks >= 4; nblocks -= 4) {							\
+		kernel(out, in, rkey);									\
+		in += 4*BLOCK_SIZE;										\
+		out += 4*BLOCK_SIZE;									\
+		rkey += 4;												\
+	}															\
+	get_scalar_backend()->tail(out, in, nblocks, rkey);			\
+}
+
+NEON_MULTIKEY_BULK(gift128_encrypt_multikey_neon, gift128_encrypt_multikey_x4,
+	gift128_encrypt_multikey)
+NEON_MULTIKEY_BULK(gift128_decrypt_multikey_neon, gift128_decrypt_multikey_x4,
+	gift128_decrypt_multikey)
+
+#define NEON_ROUNDS_BULK(name, kernel, tail)					\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+				u32 start, u32 end) {							\
+	for(; nblocks >= 4; nblocks -= 4) {							\
+		kernel(out, in, rkey, start, end);						\
+		in += 4*BLOCK_SIZE;										\
+		out += 4*BLOCK_SIZE;									\
+	}															\
+	get_scalar_backend()->tail(out, in, nblocks, rkey, start, end);	\
+}
+
+NEON_ROUNDS_BULK(gift128_encrypt_rounds_neon, gift128_encrypt_rounds_x4,
+	gift128_encrypt_rounds)
+NEON_ROUNDS_BULK(gift128_decrypt_rounds_neon, gift128_decrypt_rounds_x4,
+	gift128_decrypt_rounds)
+NEON_ROUNDS_BULK(giftb128_encrypt_rounds_neon, giftb128_encrypt_rounds_x4,
+	giftb128_encrypt_rounds)
+NEON_ROUNDS_BULK(giftb128_decrypt_rounds_neon, giftb128_decrypt_rounds_x4,
+	giftb128_decrypt_rounds)
+
+static int neon_supported(void) {
+	return 1;
+}
+
+/*****************************************************************************
+* The portable batched key schedules already map onto NEON, as they rely on
+* GCC vectors of 4 32-bit words.
+*****************************************************************************/
+const backend_t backend_neon = {
+	"neon",
+	neon_supported,
+	gift128_encrypt_neon,
+	gift128_decrypt_neon,
+	giftb128_encrypt_neon,
+	giftb128_decrypt_neon,
+	precompute_rkeys_x8_portable,
+	precompute_rkeys_x16_portable,
+	precompute_multikey_rkeys_portable,
+	gift128_encrypt_multikey_neon,
+	gift128_decrypt_multikey_neon,
+	gift128_encrypt_rounds_neon,
+	gift128_decrypt_rounds_neon,
+	giftb128_encrypt_rounds_neon,
+	giftb128_decrypt_rounds_neon
+};
+
+#endif  // GIFT128_NEON
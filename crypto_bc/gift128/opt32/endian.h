@@ -1,5 +1,5 @@
-#ifndef ENDIAN_H_
-#define ENDIAN_H_
+#ifndef GIFT128_ENDIAN_H_
+#define GIFT128_ENDIAN_H_
 
 #define U32BIG(x)											\
   ((((x) & 0x000000FF) << 24) | (((x) & 0x0000FF00) << 8) | \
@@ -11,4 +11,19 @@
 	(x)[2] = ((y) >> 8) & 0xff; 							\
 	(x)[3] = (y) & 0xff;
 
-#endif  // ENDIAN_H_
\ No newline at end of file
+/****************************************************************************
+* Big-endian 32-bit load/store from/to byte arrays of arbitrary alignment.
+* Compilers recognize these patterns and emit a single 'movbe' or a load
+* followed by 'bswap' when available.
+****************************************************************************/
+#define LOAD32_BE(p)										\
+	(((u32)(p)[0] << 24) | ((u32)(p)[1] << 16) |			\
+	 ((u32)(p)[2] << 8) | (u32)(p)[3])
+
+#define STORE32_BE(p, y)									\
+	(p)[0] = (u8)((y) >> 24); 								\
+	(p)[1] = (u8)((y) >> 16); 								\
+	(p)[2] = (u8)((y) >> 8); 								\
+	(p)[3] = (u8)(y);
+
+#endif  // GIFT128_ENDIAN_H_
\ No newline at end of file
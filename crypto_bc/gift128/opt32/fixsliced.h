@@ -0,0 +1,325 @@
+#ifndef GIFT128_FIXSLICED_H_
+#define GIFT128_FIXSLICED_H_
+
+/****************************************************************************
+* Fixsliced round functions of GIFT-128, written once for any word type.
+*
+* Every operation on words is named after its scalar version in 'gift128.h'
+* followed by the suffix 'W' (empty for 32-bit words, '_X4' for NEON, '_X8'
+* for AVX2 and '_X16' for AVX-512), so that a new word type only has to
+* provide the following macros:
+*	- XOR##W(x, y) and SET1##W(x), the latter broadcasting a 32-bit constant,
+*	- SBOX##W and INV_SBOX##W,
+*	- NIBBLE_ROR_{1,2,3}##W, HALF_ROR_{4,8,12}##W, BYTE_ROR_{2,4,6}##W and
+*	  ROR_{8,16,24}##W, rotating each 32-bit slice,
+*	- SWAPMOVE_1##W(a, mask, n), i.e. SWAPMOVE within a single word.
+* The caller declares a variable 'tmp' of the word type. 'rk(rkey, i)' returns
+* the i-th round key as a word, so that the same rounds can use round keys
+* shared by all blocks or specific to each block (multi-key).
+*
+* The scalar operators of 'gift128.h' also apply to GCC vectors of 32-bit
+* words, hence the empty suffix covers any vector width as well.
+****************************************************************************/
+#define ADD_RKEY_W(W, state, rkey, rconst, i, j, k, rk) ({	\
+	state[1] = XOR##W(state[1], rk(rkey, i));				\
+	state[2] = XOR##W(state[2], rk(rkey, (i)+1));			\
+	state[k] = XOR##W(state[k], SET1##W((rconst)[j]));		\
+})
+
+/****************************************************************************
+* The 5 rounds of a quintuple, each one with its own fixsliced representation
+* of the state: 'rkey' and 'rconst' point to the round keys and constants of
+* the whole quintuple.
+****************************************************************************/
+#define ROUND_0_W(W, state, rkey, rconst, rk) ({			\
+	SBOX##W(state[0], state[1], state[2], state[3]);		\
+	state[3] = NIBBLE_ROR_1##W(state[3]);					\
+	state[1] = NIBBLE_ROR_2##W(state[1]);					\
+	state[2] = NIBBLE_ROR_3##W(state[2]);					\
+	ADD_RKEY_W(W, state, rkey, rconst, 0, 0, 0, rk);		\
+})
+
+#define ROUND_1_W(W, state, rkey, rconst, rk) ({			\
+	SBOX##W(state[3], state[1], state[2], state[0]);		\
+	state[0] = HALF_ROR_4##W(state[0]);						\
+	state[1] = HALF_ROR_8##W(state[1]);						\
+	state[2] = HALF_ROR_12##W(state[2]);					\
+	ADD_RKEY_W(W, state, rkey, rconst, 2, 1, 3, rk);		\
+})
+
+#define ROUND_2_W(W, state, rkey, rconst, rk) ({			\
+	SBOX##W(state[0], state[1], state[2], state[3]);		\
+	state[3] = ROR_16##W(state[3]);							\
+	state[2] = ROR_16##W(state[2]);							\
+	SWAPMOVE_1##W(state[1], 0x55555555, 1);					\
+	SWAPMOVE_1##W(state[2], 0x00005555, 1);					\
+	SWAPMOVE_1##W(state[3], 0x55550000, 1);					\
+	ADD_RKEY_W(W, state, rkey, rconst, 4, 2, 0, rk);		\
+})
+
+#define ROUND_3_W(W, state, rkey, rconst, rk) ({			\
+	SBOX##W(state[3], state[1], state[2], state[0]);		\
+	state[0] = BYTE_ROR_6##W(state[0]);						\
+	state[1] = BYTE_ROR_4##W(state[1]);						\
+	state[2] = BYTE_ROR_2##W(state[2]);						\
+	ADD_RKEY_W(W, state, rkey, rconst, 6, 3, 3, rk);		\
+})
+
+#define ROUND_4_W(W, state, rkey, rconst, rk) ({			\
+	SBOX##W(state[0], state[1], state[2], state[3]);		\
+	state[3] = ROR_24##W(state[3]);							\
+	state[1] = ROR_16##W(state[1]);							\
+	state[2] = ROR_8##W(state[2]);							\
+	ADD_RKEY_W(W, state, rkey, rconst, 8, 4, 0, rk);		\
+	tmp = state[0];											\
+	state[0] = state[3];									\
+	state[3] = tmp;											\
+})
+
+#define QUINTUPLE_ROUND_W(W, state, rkey, rconst, rk) ({	\
+	ROUND_0_W(W, state, rkey, rconst, rk);					\
+	ROUND_1_W(W, state, rkey, rconst, rk);					\
+	ROUND_2_W(W, state, rkey, rconst, rk);					\
+	ROUND_3_W(W, state, rkey, rconst, rk);					\
+	ROUND_4_W(W, state, rkey, rconst, rk);					\
+})
+
+#define INV_ROUND_4_W(W, state, rkey, rconst, rk) ({		\
+	tmp = state[0];											\
+	state[0] = state[3];									\
+	state[3] = tmp;											\
+	ADD_RKEY_W(W, state, rkey, rconst, 8, 4, 0, rk);		\
+	state[3] = ROR_8##W(state[3]);							\
+	state[1] = ROR_16##W(state[1]);							\
+	state[2] = ROR_24##W(state[2]);							\
+	INV_SBOX##W(state[3], state[1], state[2], state[0]);	\
+})
+
+#define INV_ROUND_3_W(W, state, rkey, rconst, rk) ({		\
+	ADD_RKEY_W(W, state, rkey, rconst, 6, 3, 3, rk);		\
+	state[0] = BYTE_ROR_2##W(state[0]);						\
+	state[1] = BYTE_ROR_4##W(state[1]);						\
+	state[2] = BYTE_ROR_6##W(state[2]);						\
+	INV_SBOX##W(state[0], state[1], state[2], state[3]);	\
+})
+
+#define INV_ROUND_2_W(W, state, rkey, rconst, rk) ({		\
+	ADD_RKEY_W(W, state, rkey, rconst, 4, 2, 0, rk);		\
+	SWAPMOVE_1##W(state[3], 0x55550000, 1);					\
+	SWAPMOVE_1##W(state[1], 0x55555555, 1);					\
+	SWAPMOVE_1##W(state[2], 0x00005555, 1);					\
+	state[3] = ROR_16##W(state[3]);							\
+	state[2] = ROR_16##W(state[2]);							\
+	INV_SBOX##W(state[3], state[1], state[2], state[0]);	\
+})
+
+#define INV_ROUND_1_W(W, state, rkey, rconst, rk) ({		\
+	ADD_RKEY_W(W, state, rkey, rconst, 2, 1, 3, rk);		\
+	state[0] = HALF_ROR_12##W(state[0]);					\
+	state[1] = HALF_ROR_8##W(state[1]);						\
+	state[2] = HALF_ROR_4##W(state[2]);						\
+	INV_SBOX##W(state[0], state[1], state[2], state[3]);	\
+})
+
+#define INV_ROUND_0_W(W, state, rkey, rconst, rk) ({		\
+	ADD_RKEY_W(W, state, rkey, rconst, 0, 0, 0, rk);		\
+	state[3] = NIBBLE_ROR_3##W(state[3]);					\
+	state[1] = NIBBLE_ROR_2##W(state[1]);					\
+	state[2] = NIBBLE_ROR_1##W(state[2]);					\
+	INV_SBOX##W(state[3], state[1], state[2], state[0]);	\
+})
+
+#define INV_QUINTUPLE_ROUND_W(W, state, rkey, rconst, rk) ({\
+	INV_ROUND_4_W(W, state, rkey, rconst, rk);				\
+	INV_ROUND_3_W(W, state, rkey, rconst, rk);				\
+	INV_ROUND_2_W(W, state, rkey, rconst, rk);				\
+	INV_ROUND_1_W(W, state, rkey, rconst, rk);				\
+	INV_ROUND_0_W(W, state, rkey, rconst, rk);				\
+})
+
+/****************************************************************************
+* Before the round 5i+k, the state is in the representation of 'packing' up
+* to the same permutation TAU_k of the bits of every word, applied to
+* (state[3], state[1], state[2], state[0]) if k is odd. TAU_3 and TAU_4 being
+* the inverses of TAU_2 and TAU_1, every representation change is a sequence
+* of SWAPMOVEs and rotations, all of them being involutions.
+****************************************************************************/
+#define TAU_1_W(W, x) ({									\
+	x = HALF_ROR_8##W(x);									\
+	x = ROR_16##W(x);										\
+	SWAPMOVE_1##W(x, 0x0000aaaa, 15);						\
+	SWAPMOVE_1##W(x, 0x00cc00cc, 6);						\
+	SWAPMOVE_1##W(x, 0x0000f0f0, 12);						\
+	SWAPMOVE_1##W(x, 0x22222222, 1);						\
+})
+
+#define INV_TAU_1_W(W, x) ({								\
+	SWAPMOVE_1##W(x, 0x22222222, 1);						\
+	SWAPMOVE_1##W(x, 0x0000f0f0, 12);						\
+	SWAPMOVE_1##W(x, 0x00cc00cc, 6);						\
+	SWAPMOVE_1##W(x, 0x0000aaaa, 15);						\
+	x = ROR_16##W(x);										\
+	x = HALF_ROR_8##W(x);									\
+})
+
+#define TAU_2_W(W, x) ({									\
+	x = NIBBLE_ROR_2##W(x);									\
+	x = BYTE_ROR_4##W(x);									\
+	x = HALF_ROR_8##W(x);									\
+	x = ROR_16##W(x);										\
+	SWAPMOVE_1##W(x, 0x0000aaaa, 15);						\
+	SWAPMOVE_1##W(x, 0x00cc00cc, 6);						\
+	SWAPMOVE_1##W(x, 0x0c0c0c0c, 2);						\
+	SWAPMOVE_1##W(x, 0x00aa00aa, 7);						\
+})
+
+#define INV_TAU_2_W(W, x) ({								\
+	SWAPMOVE_1##W(x, 0x00aa00aa, 7);						\
+	SWAPMOVE_1##W(x, 0x0c0c0c0c, 2);						\
+	SWAPMOVE_1##W(x, 0x00cc00cc, 6);						\
+	SWAPMOVE_1##W(x, 0x0000aaaa, 15);						\
+	x = ROR_16##W(x);										\
+	x = HALF_ROR_8##W(x);									\
+	x = BYTE_ROR_4##W(x);									\
+	x = NIBBLE_ROR_2##W(x);									\
+})
+
+#define TAU_W(W, state, tau) ({								\
+	tau##_W(W, state[0]);									\
+	tau##_W(W, state[1]);									\
+	tau##_W(W, state[2]);									\
+	tau##_W(W, state[3]);									\
+})
+
+#define SWAP_03(state) ({									\
+	tmp = state[0];											\
+	state[0] = state[3];									\
+	state[3] = tmp;											\
+})
+
+// from the representation of 'packing' to the one of the round 5i+k
+#define TO_ROUND_W(W, state, k) ({							\
+	switch(k) {												\
+	case 1:													\
+		SWAP_03(state);										\
+		TAU_W(W, state, TAU_1);								\
+		break;												\
+	case 2:													\
+		TAU_W(W, state, TAU_2);								\
+		break;												\
+	case 3:													\
+		SWAP_03(state);										\
+		TAU_W(W, state, INV_TAU_2);							\
+		break;												\
+	case 4:													\
+		TAU_W(W, state, INV_TAU_1);							\
+		break;												\
+	}														\
+})
+
+// from the representation of the round 5i+k to the one of 'packing'
+#define FROM_ROUND_W(W, state, k) ({						\
+	switch(k) {												\
+	case 1:													\
+		TAU_W(W, state, INV_TAU_1);							\
+		SWAP_03(state);										\
+		break;												\
+	case 2:													\
+		TAU_W(W, state, INV_TAU_2);							\
+		break;												\
+	case 3:													\
+		TAU_W(W, state, TAU_2);								\
+		SWAP_03(state);										\
+		break;												\
+	case 4:													\
+		TAU_W(W, state, TAU_1);								\
+		break;												\
+	}														\
+})
+
+// round 5i+k alone, 'rkey' and 'rconst' pointing to the ones of round 5i
+#define ROUND_K_W(W, state, rkey, rconst, rk, k) ({			\
+	switch(k) {												\
+	case 0:													\
+		ROUND_0_W(W, state, rkey, rconst, rk);				\
+		break;												\
+	case 1:													\
+		ROUND_1_W(W, state, rkey, rconst, rk);				\
+		break;												\
+	case 2:													\
+		ROUND_2_W(W, state, rkey, rconst, rk);				\
+		break;												\
+	case 3:													\
+		ROUND_3_W(W, state, rkey, rconst, rk);				\
+		break;												\
+	case 4:													\
+		ROUND_4_W(W, state, rkey, rconst, rk);				\
+		break;												\
+	}														\
+})
+
+#define INV_ROUND_K_W(W, state, rkey, rconst, rk, k) ({		\
+	switch(k) {												\
+	case 0:													\
+		INV_ROUND_0_W(W, state, rkey, rconst, rk);			\
+		break;												\
+	case 1:													\
+		INV_ROUND_1_W(W, state, rkey, rconst, rk);			\
+		break;												\
+	case 2:													\
+		INV_ROUND_2_W(W, state, rkey, rconst, rk);			\
+		break;												\
+	case 3:													\
+		INV_ROUND_3_W(W, state, rkey, rconst, rk);			\
+		break;												\
+	case 4:													\
+		INV_ROUND_4_W(W, state, rkey, rconst, rk);			\
+		break;												\
+	}														\
+})
+
+/****************************************************************************
+* Rounds 'start' to 'end - 1' (0 <= start <= end <= 40) with round keys shared
+* by all blocks, the state being in the representation of 'packing' before
+* and after. Whole quintuples are processed as usual, the remaining rounds
+* one at a time, so that only the first and last ones cost a representation
+* change.
+****************************************************************************/
+#define ROUNDS_W(W, state, rkey, rconst, rk, start, end) ({	\
+	u32 r = (start);										\
+	TO_ROUND_W(W, state, r % 5);							\
+	while(r < (end)) {										\
+		const u32 q = r - r % 5;							\
+		if(r == q && r + 5 <= (end)) {						\
+			QUINTUPLE_ROUND_W(W, state, (rkey) + 2*q,		\
+				(rconst) + q, rk);							\
+			r += 5;											\
+		} else {											\
+			ROUND_K_W(W, state, (rkey) + 2*q, (rconst) + q,	\
+				rk, r - q);									\
+			r++;											\
+		}													\
+	}														\
+	FROM_ROUND_W(W, state, r % 5);							\
+})
+
+// inverse of 'ROUNDS_W' with the same 'start' and 'end'
+#define INV_ROUNDS_W(W, state, rkey, rconst, rk, start, end) ({\
+	u32 r = (end);											\
+	TO_ROUND_W(W, state, r % 5);							\
+	while(r > (start)) {									\
+		const u32 q = (r - 1) - (r - 1) % 5;				\
+		if(r == q + 5 && q >= (start)) {					\
+			INV_QUINTUPLE_ROUND_W(W, state, (rkey) + 2*q,	\
+				(rconst) + q, rk);							\
+			r -= 5;											\
+		} else {											\
+			INV_ROUND_K_W(W, state, (rkey) + 2*q,			\
+				(rconst) + q, rk, r - 1 - q);				\
+			r--;											\
+		}													\
+	}														\
+	FROM_ROUND_W(W, state, r % 5);							\
+})
+
+#endif  // GIFT128_FIXSLICED_H_
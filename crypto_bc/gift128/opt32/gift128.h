@@ -1,19 +1,21 @@
 #ifndef GIFT128_H_
 #define GIFT128_H_
 
+#include "fixsliced.h"
+
 #define ROR(x,y)											\
 	(((x) >> (y)) | ((x) << (32 - (y))))
 #define BYTE_ROR_2(x)										\
 	((((x) >> 2) & 0x3f3f3f3f)	| (((x) & 0x03030303) << 6))
-#define BYTE_ROR_4(x) 										\
+#define BYTE_ROR_4(x)										\
 	((((x) >> 4) & 0x0f0f0f0f)	| (((x) & 0x0f0f0f0f) << 4))
-#define BYTE_ROR_6(x) 										\
+#define BYTE_ROR_6(x)										\
 	((((x) >> 6) & 0x03030303)	| (((x) & 0x3f3f3f3f) << 2))
-#define HALF_ROR_4(x) 										\
+#define HALF_ROR_4(x)										\
 	((((x) >> 4) & 0x0fff0fff)	| (((x) & 0x000f000f) << 12))
-#define HALF_ROR_8(x) 										\
+#define HALF_ROR_8(x)										\
 	((((x) >> 8) & 0x00ff00ff)	| (((x) & 0x00ff00ff) << 8))
-#define HALF_ROR_12(x) 										\
+#define HALF_ROR_12(x)										\
 	((((x) >> 12)& 0x000f000f)	| (((x) & 0x0fff0fff) << 4))
 #define NIBBLE_ROR_1(x)										\
 	((((x) >> 1) & 0x77777777) 	| (((x) & 0x11111111) << 3))
@@ -45,90 +47,23 @@
 	s3 ^= s1 & s0;											\
 	s1 ^= s3 & s2;
 
-#define QUINTUPLE_ROUND(state, rkey, rconst) ({				\
-	SBOX(state[0], state[1], state[2], state[3]);			\
-	state[3] = NIBBLE_ROR_1(state[3]);						\
-	state[1] = NIBBLE_ROR_2(state[1]);						\
-	state[2] = NIBBLE_ROR_3(state[2]);						\
-	state[1] ^= (rkey)[0];									\
-	state[2] ^= (rkey)[1];									\
-	state[0] ^= (rconst)[0];								\
-	SBOX(state[3], state[1], state[2], state[0]);			\
-	state[0] = HALF_ROR_4(state[0]);						\
-	state[1] = HALF_ROR_8(state[1]);						\
-	state[2] = HALF_ROR_12(state[2]);						\
-	state[1] ^= (rkey)[2];									\
-	state[2] ^= (rkey)[3];									\
-	state[3] ^= (rconst)[1];								\
-	SBOX(state[0], state[1], state[2], state[3]);			\
-	state[3] = ROR(state[3], 16);							\
-	state[2] = ROR(state[2], 16);							\
-	SWAPMOVE(state[1], state[1], 0x55555555, 1);			\
-	SWAPMOVE(state[2], state[2], 0x00005555, 1);			\
-	SWAPMOVE(state[3], state[3], 0x55550000, 1);			\
-	state[1] ^= (rkey)[4];									\
-	state[2] ^= (rkey)[5];									\
-	state[0] ^= (rconst)[2];								\
-	SBOX(state[3], state[1], state[2], state[0]);			\
-	state[0] = BYTE_ROR_6(state[0]);						\
-	state[1] = BYTE_ROR_4(state[1]);						\
-	state[2] = BYTE_ROR_2(state[2]);						\
-	state[1] ^= (rkey)[6];									\
-	state[2] ^= (rkey)[7];									\
-	state[3] ^= (rconst)[3];								\
-	SBOX(state[0], state[1], state[2], state[3]);			\
-	state[3] = ROR(state[3], 24);							\
-	state[1] = ROR(state[1], 16);							\
-	state[2] = ROR(state[2], 8);							\
-	state[1] ^= (rkey)[8];									\
-	state[2] ^= (rkey)[9];									\
-	state[0] ^= (rconst)[4];								\
-	state[0] ^= state[3];									\
-	state[3] ^= state[0];									\
-	state[0] ^= state[3];									\
-})
+// remaining operations and round keys expected by 'fixsliced.h'
+#define XOR(x,y)			((x) ^ (y))
+#define SET1(x)				(x)
+#define ROR_8(x)			ROR(x, 8)
+#define ROR_16(x)			ROR(x, 16)
+#define ROR_24(x)			ROR(x, 24)
+#define SWAPMOVE_1(a, mask, n)								\
+	SWAPMOVE(a, a, mask, n)
+#define RKEY(rkey, i)		((rkey)[i])
 
-#define INV_QUINTUPLE_ROUND(state, rkey, rconst) ({			\
-	state[0] ^= state[3];									\
-	state[3] ^= state[0];									\
-	state[0] ^= state[3];									\
-	state[1] ^= (rkey)[8];									\
-	state[2] ^= (rkey)[9];									\
-	state[0] ^= (rconst)[4];								\
-	state[3] = ROR(state[3], 8);							\
-	state[1] = ROR(state[1], 16);							\
-	state[2] = ROR(state[2], 24);							\
-	INV_SBOX(state[3], state[1], state[2], state[0]);		\
-	state[1] ^= (rkey)[6];									\
-	state[2] ^= (rkey)[7];									\
-	state[3] ^= (rconst)[3];								\
-	state[0] = BYTE_ROR_2(state[0]);						\
-	state[1] = BYTE_ROR_4(state[1]);						\
-	state[2] = BYTE_ROR_6(state[2]);						\
-	INV_SBOX(state[0], state[1], state[2], state[3]);		\
-	state[1] ^= (rkey)[4];									\
-	state[2] ^= (rkey)[5];									\
-	state[0] ^= (rconst)[2];								\
-	SWAPMOVE(state[3], state[3], 0x55550000, 1);			\
-	SWAPMOVE(state[1], state[1], 0x55555555, 1);			\
-	SWAPMOVE(state[2], state[2], 0x00005555, 1);			\
-	state[3] = ROR(state[3], 16);							\
-	state[2] = ROR(state[2], 16);							\
-	INV_SBOX(state[3], state[1], state[2], state[0]);		\
-	state[1] ^= (rkey)[2];									\
-	state[2] ^= (rkey)[3];									\
-	state[3] ^= (rconst)[1];								\
-	state[0] = HALF_ROR_12(state[0]);						\
-	state[1] = HALF_ROR_8(state[1]);						\
-	state[2] = HALF_ROR_4(state[2]);						\
-	INV_SBOX(state[0], state[1], state[2], state[3]);		\
-	state[1] ^= (rkey)[0];									\
-	state[2] ^= (rkey)[1];									\
-	state[0] ^= (rconst)[0];								\
-	state[3] = NIBBLE_ROR_3(state[3]);						\
-	state[1] = NIBBLE_ROR_2(state[1]);						\
-	state[2] = NIBBLE_ROR_1(state[2]);						\
-	INV_SBOX(state[3], state[1], state[2], state[0]);		\
-})
+#define QUINTUPLE_ROUND(state, rkey, rconst)				\
+	QUINTUPLE_ROUND_W(, state, rkey, rconst, RKEY)
+#define INV_QUINTUPLE_ROUND(state, rkey, rconst)			\
+	INV_QUINTUPLE_ROUND_W(, state, rkey, rconst, RKEY)
+#define ROUNDS(state, rkey, rconst, start, end)				\
+	ROUNDS_W(, state, rkey, rconst, RKEY, start, end)
+#define INV_ROUNDS(state, rkey, rconst, start, end)			\
+	INV_ROUNDS_W(, state, rkey, rconst, RKEY, start, end)
 
 #endif  // GIFT128_H_
\ No newline at end of file
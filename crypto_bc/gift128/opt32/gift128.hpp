@@ -0,0 +1,293 @@
+#ifndef GIFT128_HPP_
+#define GIFT128_HPP_
+
+/****************************************************************************
+* Header-only C++20 interface to GIFT-128 and GIFTb-128 (see 'encrypt.h').
+*
+* 'gift::Gift128' holds the fixsliced round keys, which are erased when it is
+* destroyed or moved from, while 'gift::Gift128Ref' refers to round keys held
+* elsewhere, e.g. computed at compile time by 'gift::gift128_rkeys':
+*	static constexpr gift128_ctx ctx = gift::gift128_rkeys(FIRMWARE_KEY);
+*	gift::Gift128Ref(ctx).ctr_xor(iv, in, out);
+* The member functions take 'std::span's, never allocate nor throw, and
+* directly forward to the C functions, hence to the backend selected at run
+* time (see 'dispatch.c'). Inputs that do not fit in the 32-bit lengths of
+* the C interface are split into several calls.
+* The macros of the C headers, 'BLOCK_SIZE' and 'KEY_SIZE' included, are
+* undefined at the end of this header so that it can be included along with
+* 'gift64.hpp': use 'block_size' and 'key_size' instead.
+* The C sources of this directory have to be linked as usual.
+****************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+extern "C" {
+#include "encrypt.h"
+}
+#include "endian.h"
+#include "gift128.h"
+#include "key_schedule.h"
+
+namespace gift {
+
+using Key = std::span<const std::uint8_t, KEY_SIZE>;
+
+/****************************************************************************
+* Evaluates the very same 'KEY_SCHEDULE' macro as 'precompute_rkeys' (see
+* 'key_schedule.h'), at compile time when 'key' is a constant expression.
+****************************************************************************/
+constexpr gift128_ctx gift128_rkeys(Key key) noexcept {
+	gift128_ctx ctx{};
+	u32 tmp = 0, *rkey = ctx.rkey;
+	rkey[0] = LOAD32_BE(key.data() + 12);
+	rkey[1] = LOAD32_BE(key.data() + 4);
+	rkey[2] = LOAD32_BE(key.data() + 8);
+	rkey[3] = LOAD32_BE(key.data());
+	KEY_SCHEDULE(rkey);
+	return ctx;
+}
+
+// first and last round keys of the 3rd test vector, as computed at run time
+static_assert([] {
+	constexpr std::uint8_t key[KEY_SIZE] = {
+		0xd0, 0xf5, 0xc5, 0x9a, 0x77, 0x00, 0xd3, 0xe7,
+		0x99, 0x02, 0x8f, 0xa9, 0xf9, 0x0a, 0xd8, 0x37};
+	constexpr gift128_ctx ctx = gift128_rkeys(key);
+	return ctx.rkey[0] == 0x559d78a9 && ctx.rkey[1] == 0xcd9509dd &&
+		ctx.rkey[78] == 0x743d59ac && ctx.rkey[79] == 0x2990a98f;
+}(), "compile-time and run-time GIFT-128 key schedules differ");
+
+/****************************************************************************
+* Operations shared by 'Gift128' and 'Gift128Ref', both of which provide the
+* round keys through 'ctx()'.
+****************************************************************************/
+template<typename Derived>
+class Gift128Ops {
+public:
+	static constexpr std::size_t block_size = BLOCK_SIZE;
+	static constexpr std::size_t key_size = KEY_SIZE;
+
+	using InBlock = std::span<const std::uint8_t, block_size>;
+	using OutBlock = std::span<std::uint8_t, block_size>;
+	using In = std::span<const std::uint8_t>;
+	using Out = std::span<std::uint8_t>;
+
+	void encrypt_block(OutBlock out, InBlock in) const noexcept {
+		gift128_encrypt_block(ctx_ptr(), out.data(), in.data());
+	}
+
+	void decrypt_block(OutBlock out, InBlock in) const noexcept {
+		gift128_decrypt_block(ctx_ptr(), out.data(), in.data());
+	}
+
+	void encryptb_block(OutBlock out, InBlock in) const noexcept {
+		giftb128_encrypt_block(ctx_ptr(), out.data(), in.data());
+	}
+
+	void decryptb_block(OutBlock out, InBlock in) const noexcept {
+		giftb128_decrypt_block(ctx_ptr(), out.data(), in.data());
+	}
+
+	/************************************************************************
+	* ECB functions: the length of 'in' must be a multiple of 16 and 'out' at
+	* least as long as 'in', otherwise nothing is done and false is returned.
+	* 'in' and 'out' may be the same buffer.
+	************************************************************************/
+	[[nodiscard]] bool ecb_encrypt(Out out, In in) const noexcept {
+		return ecb(gift128_ecb_encrypt, out, in);
+	}
+
+	[[nodiscard]] bool ecb_decrypt(Out out, In in) const noexcept {
+		return ecb(gift128_ecb_decrypt, out, in);
+	}
+
+	[[nodiscard]] bool ecbb_encrypt(Out out, In in) const noexcept {
+		return ecb(giftb128_ecb_encrypt, out, in);
+	}
+
+	[[nodiscard]] bool ecbb_decrypt(Out out, In in) const noexcept {
+		return ecb(giftb128_ecb_decrypt, out, in);
+	}
+
+	/************************************************************************
+	* CTR encryption/decryption of 'in' starting at byte 'offset' of the
+	* keystream defined by 'iv' (see 'gift128_ctr_xor_at'). Returns false if
+	* 'out' is shorter than 'in'.
+	************************************************************************/
+	[[nodiscard]] bool ctr_xor(InBlock iv, In in, Out out,
+				std::uint64_t offset = 0) const noexcept {
+		if(out.size() < in.size())
+			return false;
+		for(std::size_t done = 0, n; done < in.size(); done += n) {
+			n = chunk(in.size() - done);
+			gift128_ctr_xor_at(ctx_ptr(), iv.data(), offset + done,
+				in.data() + done, out.data() + done, (u32)n);
+		}
+		return true;
+	}
+
+private:
+	// longest input of a single call, a multiple of the block size
+	static constexpr std::size_t max_chunk = 0xfffffff0;
+
+	static std::size_t chunk(std::size_t len) noexcept {
+		return (len < max_chunk) ? len : max_chunk;
+	}
+
+	using ecb_fn = int (*)(const gift128_ctx*, u8*, const u8*, u32);
+
+	bool ecb(ecb_fn fn, Out out, In in) const noexcept {
+		if(in.size() % block_size != 0 || out.size() < in.size())
+			return false;
+		for(std::size_t done = 0, n; done < in.size(); done += n) {
+			n = chunk(in.size() - done);
+			fn(ctx_ptr(), out.data() + done, in.data() + done, (u32)n);
+		}
+		return true;
+	}
+
+	const gift128_ctx* ctx_ptr() const noexcept {
+		return &static_cast<const Derived*>(this)->ctx();
+	}
+};
+
+class Gift128 : public Gift128Ops<Gift128> {
+public:
+	explicit Gift128(Key key) noexcept {
+		gift128_init(&ctx_, key.data());
+	}
+
+	// the round keys are not copied implicitly, only moved
+	Gift128(const Gift128&) = delete;
+	Gift128& operator=(const Gift128&) = delete;
+
+	Gift128(Gift128&& other) noexcept : ctx_(other.ctx_) {
+		other.wipe();
+	}
+
+	Gift128& operator=(Gift128&& other) noexcept {
+		if(this != &other) {
+			ctx_ = other.ctx_;
+			other.wipe();
+		}
+		return *this;
+	}
+
+	~Gift128() {
+		wipe();
+	}
+
+	void rekey(Key key) noexcept {
+		gift128_init(&ctx_, key.data());
+	}
+
+	// underlying context, to call the C functions not wrapped here
+	const gift128_ctx& ctx() const noexcept {
+		return ctx_;
+	}
+
+private:
+	void wipe() noexcept {
+		volatile u32* rkey = ctx_.rkey;
+		for(std::size_t i = 0; i < sizeof(ctx_.rkey)/sizeof(u32); i++)
+			rkey[i] = 0;
+	}
+
+	gift128_ctx ctx_;
+};
+
+// non-owning view on round keys that must outlive it
+class Gift128Ref : public Gift128Ops<Gift128Ref> {
+public:
+	constexpr explicit Gift128Ref(const gift128_ctx& ctx) noexcept
+		: ctx_(&ctx) {}
+
+	const gift128_ctx& ctx() const noexcept {
+		return *ctx_;
+	}
+
+private:
+	const gift128_ctx* ctx_;
+};
+
+}  // namespace gift
+
+// the macros of the C headers, which would clash with those of 'gift64.hpp'
+#undef BLOCK_SIZE
+#undef KEY_SIZE
+#undef U32BIG
+#undef U8BIG
+#undef LOAD32_BE
+#undef STORE32_BE
+#undef REARRANGE_RKEY_0
+#undef REARRANGE_RKEY_1
+#undef REARRANGE_RKEY_2
+#undef REARRANGE_RKEY_3
+#undef KEY_UPDATE
+#undef KEY_TRIPLE_UPDATE_0
+#undef KEY_DOUBLE_UPDATE_1
+#undef KEY_TRIPLE_UPDATE_1
+#undef KEY_DOUBLE_UPDATE_2
+#undef KEY_TRIPLE_UPDATE_2
+#undef KEY_DOUBLE_UPDATE_3
+#undef KEY_TRIPLE_UPDATE_3
+#undef KEY_DOUBLE_UPDATE_4
+#undef KEY_TRIPLE_UPDATE_4
+#undef KEY_SCHEDULE_INIT
+#undef KEY_SCHEDULE
+#undef KEY_QUINTUPLE_UPDATE
+#undef KEY_SCHEDULE_XN
+#undef PRECOMPUTE_RKEYS_XN
+#undef PRECOMPUTE_MULTIKEY_RKEYS_XN
+#undef ROR
+#undef BYTE_ROR_2
+#undef BYTE_ROR_4
+#undef BYTE_ROR_6
+#undef HALF_ROR_4
+#undef HALF_ROR_8
+#undef HALF_ROR_12
+#undef NIBBLE_ROR_1
+#undef NIBBLE_ROR_2
+#undef NIBBLE_ROR_3
+#undef SWAPMOVE
+#undef SBOX
+#undef INV_SBOX
+#undef XOR
+#undef SET1
+#undef ROR_8
+#undef ROR_16
+#undef ROR_24
+#undef SWAPMOVE_1
+#undef RKEY
+#undef QUINTUPLE_ROUND
+#undef INV_QUINTUPLE_ROUND
+#undef ROUNDS
+#undef INV_ROUNDS
+#undef ADD_RKEY_W
+#undef ROUND_0_W
+#undef ROUND_1_W
+#undef ROUND_2_W
+#undef ROUND_3_W
+#undef ROUND_4_W
+#undef QUINTUPLE_ROUND_W
+#undef INV_ROUND_4_W
+#undef INV_ROUND_3_W
+#undef INV_ROUND_2_W
+#undef INV_ROUND_1_W
+#undef INV_ROUND_0_W
+#undef INV_QUINTUPLE_ROUND_W
+#undef TAU_1_W
+#undef INV_TAU_1_W
+#undef TAU_2_W
+#undef INV_TAU_2_W
+#undef TAU_W
+#undef SWAP_03
+#undef TO_ROUND_W
+#undef FROM_ROUND_W
+#undef ROUND_K_W
+#undef INV_ROUND_K_W
+#undef ROUNDS_W
+#undef INV_ROUNDS_W
+
+#endif  // GIFT128_HPP_
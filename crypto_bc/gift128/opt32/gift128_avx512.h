@@ -0,0 +1,117 @@
+#ifndef GIFT128_AVX512_H_
+#define GIFT128_AVX512_H_
+
+#include "backend.h"
+#include "fixsliced.h"
+
+#ifdef GIFT128_AVX512
+
+#include <immintrin.h>
+
+#define TARGET_AVX512	__attribute__((target("avx512f")))
+
+/****************************************************************************
+* Same macros as in 'gift128.h' but operating on 16 blocks at once, each of
+* the 16 32-bit lanes of a '__m512i' holding the same slice of another block.
+* Boolean functions of up to 3 inputs are computed with a single 'vpternlogd'
+* whose immediate is the truth table of the function, where the 1st, 2nd and
+* 3rd operands are respectively represented by 0xf0, 0xcc and 0xaa.
+****************************************************************************/
+#define SET1_X16(x)											\
+	_mm512_set1_epi32((int)(x))
+#define XOR_X16(x,y)										\
+	_mm512_xor_si512((x), (y))
+#define TERNLOG_X16(a, b, c, imm)							\
+	_mm512_ternarylogic_epi32((a), (b), (c), (imm))
+#define XOR_AND_X16(a, b, c)		TERNLOG_X16(a, b, c, 0x78)	// a^(b&c)
+#define XOR_OR_X16(a, b, c)			TERNLOG_X16(a, b, c, 0x1e)	// a^(b|c)
+#define XOR3_X16(a, b, c)			TERNLOG_X16(a, b, c, 0x96)	// a^b^c
+#define XNOR_X16(a, b)				TERNLOG_X16(a, b, b, 0xc3)	// ~(a^b)
+#define SELECT_X16(m, a, b)			TERNLOG_X16(m, a, b, 0xca)	// m?a:b
+#define ROR_X16(x, y)										\
+	_mm512_ror_epi32((x), (y))
+// rotations within bit-fields, for which 'm1 << ls' is always equal to '~m0'
+#define SHIFT_OR_X16(x, rs, m0, m1, ls)						\
+	SELECT_X16(SET1_X16(m0), _mm512_srli_epi32((x), (rs)),	\
+		_mm512_slli_epi32((x), (ls)))
+
+#define ROR_8_X16(x)		ROR_X16(x, 8)
+#define ROR_16_X16(x)		ROR_X16(x, 16)
+#define ROR_24_X16(x)		ROR_X16(x, 24)
+#define BYTE_ROR_2_X16(x)									\
+	SHIFT_OR_X16(x, 2, 0x3f3f3f3f, 0x03030303, 6)
+#define BYTE_ROR_4_X16(x)									\
+	SHIFT_OR_X16(x, 4, 0x0f0f0f0f, 0x0f0f0f0f, 4)
+#define BYTE_ROR_6_X16(x)									\
+	SHIFT_OR_X16(x, 6, 0x03030303, 0x3f3f3f3f, 2)
+#define HALF_ROR_4_X16(x)									\
+	SHIFT_OR_X16(x, 4, 0x0fff0fff, 0x000f000f, 12)
+#define HALF_ROR_8_X16(x)									\
+	SHIFT_OR_X16(x, 8, 0x00ff00ff, 0x00ff00ff, 8)
+#define HALF_ROR_12_X16(x)									\
+	SHIFT_OR_X16(x, 12, 0x000f000f, 0x0fff0fff, 4)
+#define NIBBLE_ROR_1_X16(x)									\
+	SHIFT_OR_X16(x, 1, 0x77777777, 0x11111111, 3)
+#define NIBBLE_ROR_2_X16(x)									\
+	SHIFT_OR_X16(x, 2, 0x33333333, 0x33333333, 2)
+#define NIBBLE_ROR_3_X16(x)									\
+	SHIFT_OR_X16(x, 3, 0x11111111, 0x77777777, 1)
+
+#define SWAPMOVE_X16(a, b, mask, n)							\
+	tmp = TERNLOG_X16(b, _mm512_srli_epi32(a, n), SET1_X16(mask), 0x28);\
+	b = XOR_X16(b, tmp);									\
+	a = XOR_X16(a, _mm512_slli_epi32(tmp, n));
+
+// SWAPMOVE within a single word, both XORs are merged into one 'vpternlogd'
+#define SWAPMOVE_1_X16(a, mask, n)							\
+	tmp = TERNLOG_X16(a, _mm512_srli_epi32(a, n), SET1_X16(mask), 0x28);\
+	a = XOR3_X16(a, tmp, _mm512_slli_epi32(tmp, n));
+
+// the NOT is merged with the computation of s3
+#define SBOX_X16(s0, s1, s2, s3)							\
+	s1 = XOR_AND_X16(s1, s0, s2);							\
+	s0 = XOR_AND_X16(s0, s1, s3);							\
+	s2 = XOR_OR_X16(s2, s0, s1);							\
+	s1 = XOR3_X16(s1, s3, s2);								\
+	s3 = XNOR_X16(s3, s2);									\
+	s2 = XOR_AND_X16(s2, s0, s1);
+
+// the NOT is merged with the computations of s1 and s0
+#define INV_SBOX_X16(s0, s1, s2, s3)						\
+	s2 = XOR_AND_X16(s2, s3, s1);							\
+	s1 = XNOR_X16(s1, s0);									\
+	s0 = XNOR_X16(s0, s2);									\
+	s2 = XOR_OR_X16(s2, s3, s1);							\
+	s3 = XOR_AND_X16(s3, s1, s0);							\
+	s1 = XOR_AND_X16(s1, s3, s2);
+
+// round keys shared by all blocks or specific to each block (multi-key)
+#define BCAST_RKEY_X16(rkey, i)	SET1_X16((rkey)[i])
+#define LANE_RKEY_X16(rkey, i)								\
+	_mm512_loadu_si512((const void*)((rkey) + (i)*GIFT128_LANES))
+
+#define QUINTUPLE_ROUND_X16(state, rkey, rconst, rk)		\
+	QUINTUPLE_ROUND_W(_X16, state, rkey, rconst, rk)
+#define INV_QUINTUPLE_ROUND_X16(state, rkey, rconst, rk)	\
+	INV_QUINTUPLE_ROUND_W(_X16, state, rkey, rconst, rk)
+#define ROUNDS_X16(state, rkey, rconst, start, end)			\
+	ROUNDS_W(_X16, state, rkey, rconst, BCAST_RKEY_X16, start, end)
+#define INV_ROUNDS_X16(state, rkey, rconst, start, end)		\
+	INV_ROUNDS_W(_X16, state, rkey, rconst, BCAST_RKEY_X16, start, end)
+
+extern void gift128_encrypt_x16(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey);
+extern void gift128_decrypt_x16(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey);
+extern void giftb128_encrypt_x16(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey);
+extern void giftb128_decrypt_x16(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey);
+extern void gift128_encrypt_multikey_x16(u8* ctext, const u8* ptext,
+				u32 nblocks, const u32* rkey);
+extern void gift128_decrypt_multikey_x16(u8* ptext, const u8* ctext,
+				u32 nblocks, const u32* rkey);
+
+#endif  // GIFT128_AVX512
+
+#endif  // GIFT128_AVX512_H_
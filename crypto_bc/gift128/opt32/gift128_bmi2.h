@@ -0,0 +1,158 @@
+#ifndef GIFT128_BMI2_H_
+#define GIFT128_BMI2_H_
+
+#include "backend.h"
+
+#ifdef GIFT128_BMI2
+
+#include <immintrin.h>
+
+#define TARGET_BMI2		__attribute__((target("bmi,bmi2")))
+
+/****************************************************************************
+* S-boxes without any NOT: each state word may be held complemented, which is
+* recorded in the flag 'f' attached to it. A complemented operand turns an
+* AND/OR into a single 'andn', OR or AND (De Morgan), so that the NOT of the
+* S-box only flips a flag. As the round loop is fully unrolled, all the flags
+* are compile-time constants and the selections below vanish. The state is
+* eventually corrected with at most 4 NOTs after the last round.
+****************************************************************************/
+#define ANDN(x, y)			_andn_u32((x), (y))			// ~x & y
+
+// held value of x & y, complemented iff fx & fy
+#define AND_NEG(x, fx, y, fy)								\
+	((fx) ? ((fy) ? ((x) | (y)) : ANDN(x, y)) :				\
+			((fy) ? ANDN(y, x) : ((x) & (y))))
+
+// held value of x | y, complemented iff fx | fy
+#define OR_NEG(x, fx, y, fy)								\
+	((fx) ? ((fy) ? ((x) & (y)) : ANDN(y, x)) :				\
+			((fy) ? ANDN(x, y) : ((x) | (y))))
+
+#define SBOX_NEG(s0, s1, s2, s3, f0, f1, f2, f3)			\
+	s1 ^= AND_NEG(s0, f0, s2, f2);		f1 ^= (f0) & (f2);	\
+	s0 ^= AND_NEG(s1, f1, s3, f3);		f0 ^= (f1) & (f3);	\
+	s2 ^= OR_NEG(s0, f0, s1, f1);		f2 ^= (f0) | (f1);	\
+	s3 ^= s2;							f3 ^= (f2);			\
+	s1 ^= s3;							f1 ^= (f3);			\
+										f3 ^= 1;			\
+	s2 ^= AND_NEG(s0, f0, s1, f1);		f2 ^= (f0) & (f1);
+
+#define INV_SBOX_NEG(s0, s1, s2, s3, f0, f1, f2, f3)		\
+	s2 ^= AND_NEG(s3, f3, s1, f1);		f2 ^= (f3) & (f1);	\
+										f0 ^= 1;			\
+	s1 ^= s0;							f1 ^= (f0);			\
+	s0 ^= s2;							f0 ^= (f2);			\
+	s2 ^= OR_NEG(s3, f3, s1, f1);		f2 ^= (f3) | (f1);	\
+	s3 ^= AND_NEG(s1, f1, s0, f0);		f3 ^= (f1) & (f0);	\
+	s1 ^= AND_NEG(s3, f3, s2, f2);		f1 ^= (f3) & (f2);
+
+#define SWAP_STATE_0_3(state, neg) ({						\
+	tmp = state[0];											\
+	state[0] = state[3];									\
+	state[3] = tmp;											\
+	tmp = neg[0];											\
+	neg[0] = neg[3];										\
+	neg[3] = tmp;											\
+})
+
+/****************************************************************************
+* Same as 'QUINTUPLE_ROUND' in 'gift128.h' with the S-boxes above. The
+* rotations and XORs commute with the NOT and are left unchanged (GCC emits
+* 'rorx' for 'ROR' when targeting BMI2).
+****************************************************************************/
+#define QUINTUPLE_ROUND_NEG(state, neg, rkey, rconst) ({	\
+	SBOX_NEG(state[0], state[1], state[2], state[3],		\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[3] = NIBBLE_ROR_1(state[3]);						\
+	state[1] = NIBBLE_ROR_2(state[1]);						\
+	state[2] = NIBBLE_ROR_3(state[2]);						\
+	state[1] ^= (rkey)[0];									\
+	state[2] ^= (rkey)[1];									\
+	state[0] ^= (rconst)[0];								\
+	SBOX_NEG(state[3], state[1], state[2], state[0],		\
+		neg[3], neg[1], neg[2], neg[0]);					\
+	state[0] = HALF_ROR_4(state[0]);						\
+	state[1] = HALF_ROR_8(state[1]);						\
+	state[2] = HALF_ROR_12(state[2]);						\
+	state[1] ^= (rkey)[2];									\
+	state[2] ^= (rkey)[3];									\
+	state[3] ^= (rconst)[1];								\
+	SBOX_NEG(state[0], state[1], state[2], state[3],		\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[3] = ROR(state[3], 16);							\
+	state[2] = ROR(state[2], 16);							\
+	SWAPMOVE(state[1], state[1], 0x55555555, 1);			\
+	SWAPMOVE(state[2], state[2], 0x00005555, 1);			\
+	SWAPMOVE(state[3], state[3], 0x55550000, 1);			\
+	state[1] ^= (rkey)[4];									\
+	state[2] ^= (rkey)[5];									\
+	state[0] ^= (rconst)[2];								\
+	SBOX_NEG(state[3], state[1], state[2], state[0],		\
+		neg[3], neg[1], neg[2], neg[0]);					\
+	state[0] = BYTE_ROR_6(state[0]);						\
+	state[1] = BYTE_ROR_4(state[1]);						\
+	state[2] = BYTE_ROR_2(state[2]);						\
+	state[1] ^= (rkey)[6];									\
+	state[2] ^= (rkey)[7];									\
+	state[3] ^= (rconst)[3];								\
+	SBOX_NEG(state[0], state[1], state[2], state[3],		\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[3] = ROR(state[3], 24);							\
+	state[1] = ROR(state[1], 16);							\
+	state[2] = ROR(state[2], 8);							\
+	state[1] ^= (rkey)[8];									\
+	state[2] ^= (rkey)[9];									\
+	state[0] ^= (rconst)[4];								\
+	SWAP_STATE_0_3(state, neg);								\
+})
+
+#define INV_QUINTUPLE_ROUND_NEG(state, neg, rkey, rconst) ({\
+	SWAP_STATE_0_3(state, neg);								\
+	state[1] ^= (rkey)[8];									\
+	state[2] ^= (rkey)[9];									\
+	state[0] ^= (rconst)[4];								\
+	state[3] = ROR(state[3], 8);							\
+	state[1] = ROR(state[1], 16);							\
+	state[2] = ROR(state[2], 24);							\
+	INV_SBOX_NEG(state[3], state[1], state[2], state[0],	\
+		neg[3], neg[1], neg[2], neg[0]);					\
+	state[1] ^= (rkey)[6];									\
+	state[2] ^= (rkey)[7];									\
+	state[3] ^= (rconst)[3];								\
+	state[0] = BYTE_ROR_2(state[0]);						\
+	state[1] = BYTE_ROR_4(state[1]);						\
+	state[2] = BYTE_ROR_6(state[2]);						\
+	INV_SBOX_NEG(state[0], state[1], state[2], state[3],	\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[1] ^= (rkey)[4];									\
+	state[2] ^= (rkey)[5];									\
+	state[0] ^= (rconst)[2];								\
+	SWAPMOVE(state[3], state[3], 0x55550000, 1);			\
+	SWAPMOVE(state[1], state[1], 0x55555555, 1);			\
+	SWAPMOVE(state[2], state[2], 0x00005555, 1);			\
+	state[3] = ROR(state[3], 16);							\
+	state[2] = ROR(state[2], 16);							\
+	INV_SBOX_NEG(state[3], state[1], state[2], state[0],	\
+		neg[3], neg[1], neg[2], neg[0]);					\
+	state[1] ^= (rkey)[2];									\
+	state[2] ^= (rkey)[3];									\
+	state[3] ^= (rconst)[1];								\
+	state[0] = HALF_ROR_12(state[0]);						\
+	state[1] = HALF_ROR_8(state[1]);						\
+	state[2] = HALF_ROR_4(state[2]);						\
+	INV_SBOX_NEG(state[0], state[1], state[2], state[3],	\
+		neg[0], neg[1], neg[2], neg[3]);					\
+	state[1] ^= (rkey)[0];									\
+	state[2] ^= (rkey)[1];									\
+	state[0] ^= (rconst)[0];								\
+	state[3] = NIBBLE_ROR_3(state[3]);						\
+	state[1] = NIBBLE_ROR_2(state[1]);						\
+	state[2] = NIBBLE_ROR_1(state[2]);						\
+	INV_SBOX_NEG(state[3], state[1], state[2], state[0],	\
+		neg[3], neg[1], neg[2], neg[0]);					\
+})
+
+#endif  // GIFT128_BMI2
+
+#endif  // GIFT128_BMI2_H_
@@ -0,0 +1,110 @@
+#ifndef GIFT128_NEON_H_
+#define GIFT128_NEON_H_
+
+#include "backend.h"
+#include "fixsliced.h"
+
+#ifdef GIFT128_NEON
+
+#include <arm_neon.h>
+
+/****************************************************************************
+* Same macros as in 'gift128.h' but operating on 4 blocks at once, each of
+* the 4 32-bit lanes of a 'uint32x4_t' holding the same slice of another
+* block. NEON is mandatory on AArch64, so no target attribute is needed.
+****************************************************************************/
+#define SET1_X4(x)											\
+	vdupq_n_u32(x)
+#define XOR_X4(x,y)											\
+	veorq_u32((x), (y))
+#define AND_X4(x,y)											\
+	vandq_u32((x), (y))
+#define OR_X4(x,y)											\
+	vorrq_u32((x), (y))
+#define NOT_X4(x)											\
+	vmvnq_u32(x)
+
+#define U8_X4(x)			vreinterpretq_u8_u32(x)
+#define U16_X4(x)			vreinterpretq_u16_u32(x)
+#define U32_X4_U8(x)		vreinterpretq_u32_u8(x)
+#define U32_X4_U16(x)		vreinterpretq_u32_u16(x)
+
+// rotations within 8/16/32-bit elements: a shift and a shift-left-insert
+#define ROR_X4(x, n)										\
+	vsliq_n_u32(vshrq_n_u32((x), (n)), (x), 32 - (n))
+#define ROR_U16_X4(x, n)									\
+	U32_X4_U16(vsliq_n_u16(vshrq_n_u16(U16_X4(x), (n)),		\
+		U16_X4(x), 16 - (n)))
+#define ROR_U8_X4(x, n)										\
+	U32_X4_U8(vsliq_n_u8(vshrq_n_u8(U8_X4(x), (n)),			\
+		U8_X4(x), 8 - (n)))
+// rotations within nibbles, for which 'm1 << ls' is always equal to '~m0'
+#define SHIFT_OR_X4(x, rs, m0, ls)							\
+	vbslq_u32(SET1_X4(m0), vshrq_n_u32((x), (rs)),			\
+		vshlq_n_u32((x), (ls)))
+
+#define ROR_8_X4(x)			ROR_X4(x, 8)
+#define ROR_16_X4(x)		U32_X4_U16(vrev32q_u16(U16_X4(x)))
+#define ROR_24_X4(x)		ROR_X4(x, 24)
+#define HALF_ROR_4_X4(x)	ROR_U16_X4(x, 4)
+#define HALF_ROR_8_X4(x)	U32_X4_U8(vrev16q_u8(U8_X4(x)))
+#define HALF_ROR_12_X4(x)	ROR_U16_X4(x, 12)
+#define BYTE_ROR_2_X4(x)	ROR_U8_X4(x, 2)
+#define BYTE_ROR_4_X4(x)	ROR_U8_X4(x, 4)
+#define BYTE_ROR_6_X4(x)	ROR_U8_X4(x, 6)
+#define NIBBLE_ROR_1_X4(x)	SHIFT_OR_X4(x, 1, 0x77777777, 3)
+#define NIBBLE_ROR_2_X4(x)	SHIFT_OR_X4(x, 2, 0x33333333, 2)
+#define NIBBLE_ROR_3_X4(x)	SHIFT_OR_X4(x, 3, 0x11111111, 1)
+
+#define SWAPMOVE_X4(a, b, mask, n)							\
+	tmp = AND_X4(XOR_X4(b, vshrq_n_u32(a, n)), SET1_X4(mask));\
+	b = XOR_X4(b, tmp);										\
+	a = XOR_X4(a, vshlq_n_u32(tmp, n));
+
+// SWAPMOVE within a single word
+#define SWAPMOVE_1_X4(a, mask, n)							\
+	SWAPMOVE_X4(a, a, mask, n)
+
+#define SBOX_X4(s0, s1, s2, s3)								\
+	s1 = XOR_X4(s1, AND_X4(s0, s2));						\
+	s0 = XOR_X4(s0, AND_X4(s1, s3));						\
+	s2 = XOR_X4(s2, OR_X4(s0, s1));							\
+	s3 = XOR_X4(s3, s2);									\
+	s1 = XOR_X4(s1, s3);									\
+	s3 = NOT_X4(s3);										\
+	s2 = XOR_X4(s2, AND_X4(s0, s1));
+
+#define INV_SBOX_X4(s0, s1, s2, s3)							\
+	s2 = XOR_X4(s2, AND_X4(s3, s1));						\
+	s0 = NOT_X4(s0);										\
+	s1 = XOR_X4(s1, s0);									\
+	s0 = XOR_X4(s0, s2);									\
+	s2 = XOR_X4(s2, OR_X4(s3, s1));							\
+	s3 = XOR_X4(s3, AND_X4(s1, s0));						\
+	s1 = XOR_X4(s1, AND_X4(s3, s2));
+
+// round keys shared by all blocks or specific to each block (multi-key)
+#define BCAST_RKEY_X4(rkey, i)	SET1_X4((rkey)[i])
+#define LANE_RKEY_X4(rkey, i)	vld1q_u32((rkey) + (i)*GIFT128_LANES)
+
+#define QUINTUPLE_ROUND_X4(state, rkey, rconst, rk)			\
+	QUINTUPLE_ROUND_W(_X4, state, rkey, rconst, rk)
+#define INV_QUINTUPLE_ROUND_X4(state, rkey, rconst, rk)		\
+	INV_QUINTUPLE_ROUND_W(_X4, state, rkey, rconst, rk)
+#define ROUNDS_X4(state, rkey, rconst, start, end)			\
+	ROUNDS_W(_X4, state, rkey, rconst, BCAST_RKEY_X4, start, end)
+#define INV_ROUNDS_X4(state, rkey, rconst, start, end)		\
+	INV_ROUNDS_W(_X4, state, rkey, rconst, BCAST_RKEY_X4, start, end)
+
+extern void gift128_encrypt_x4(u8* ctext, const u8* ptext, const u32* rkey);
+extern void gift128_decrypt_x4(u8* ptext, const u8* ctext, const u32* rkey);
+extern void giftb128_encrypt_x4(u8* ctext, const u8* ptext, const u32* rkey);
+extern void giftb128_decrypt_x4(u8* ptext, const u8* ctext, const u32* rkey);
+extern void gift128_encrypt_multikey_x4(u8* ctext, const u8* ptext,
+				const u32* rkey);
+extern void gift128_decrypt_multikey_x4(u8* ptext, const u8* ctext,
+				const u32* rkey);
+
+#endif  // GIFT128_NEON
+
+#endif  // GIFT128_NEON_H_
@@ -0,0 +1,97 @@
+/*******************************************************************************
+* Command-line front end of 'gift128_key_search', reporting the number of
+* keys tried per second.
+*
+* Usage:
+*	./keysearch KEY MASK PTEXT CTEXT [THREADS]
+*		searches the bits set in MASK (at most 64) of the key encrypting
+*		PTEXT to CTEXT, the other ones being those of KEY (32 hex digits each)
+*	./keysearch NBITS [THREADS]
+*		benchmark: searches the NBITS last bits of a test key
+* THREADS defaults to the number of online processors and the backend can be
+* chosen through the GIFT_BACKEND environment variable.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "encrypt.h"
+
+static int parse_hex(u8* out, const char* s, u32 len) {
+	unsigned int byte;
+	if(strlen(s) != 2*len)
+		return -1;
+	for(u32 i = 0; i < len; i++) {
+		if(sscanf(s + 2*i, "%2x", &byte) != 1)
+			return -1;
+		out[i] = (u8)byte;
+	}
+	return 0;
+}
+
+static void print_hex(const u8* in, u32 len) {
+	for(u32 i = 0; i < len; i++)
+		printf("%02x", in[i]);
+	printf("\n");
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+int main(int argc, char** argv) {
+	gift128_keysearch ks;
+	u8 key[KEY_SIZE];
+	u32 nthreads = 0;
+	u64 ntested;
+	double t;
+	int ret;
+	memset(&ks, 0, sizeof(ks));
+	if(argc == 2 || argc == 3) {
+		int nbits = atoi(argv[1]);
+		if(nbits < 0 || nbits > 64)
+			return 1;
+		for(int i = 0; i < KEY_SIZE; i++) {
+			ks.key[i] = (u8)(i*0x1d + 0x5a);
+			ks.ptext[i] = (u8)(i*0x33 + 0x0f);
+			if(8*(KEY_SIZE - i) <= nbits)
+				ks.mask[i] = 0xff;
+			else if(8*(KEY_SIZE - 1 - i) < nbits)
+				ks.mask[i] = (u8)((1 << (nbits % 8)) - 1);
+		}
+		gift128_encrypt_ecb(ks.ctext, ks.ptext, BLOCK_SIZE, ks.key);
+		if(argc == 3)
+			nthreads = (u32)atoi(argv[2]);
+	} else if(argc == 5 || argc == 6) {
+		if(parse_hex(ks.key, argv[1], KEY_SIZE) ||
+				parse_hex(ks.mask, argv[2], KEY_SIZE) ||
+				parse_hex(ks.ptext, argv[3], BLOCK_SIZE) ||
+				parse_hex(ks.ctext, argv[4], BLOCK_SIZE)) {
+			fprintf(stderr, "KEY, MASK, PTEXT and CTEXT must be 32 hex "
+				"digits\n");
+			return 1;
+		}
+		if(argc == 6)
+			nthreads = (u32)atoi(argv[5]);
+	} else {
+		fprintf(stderr, "usage: %s KEY MASK PTEXT CTEXT [THREADS]\n"
+			"       %s NBITS [THREADS]\n", argv[0], argv[0]);
+		return 1;
+	}
+	t = now();
+	ret = gift128_key_search(&ks, nthreads, key, &ntested);
+	t = now() - t;
+	if(ret == 0) {
+		printf("key found: ");
+		print_hex(key, KEY_SIZE);
+	} else {
+		printf("no key found\n");
+	}
+	printf("%llu keys in %.3f s with the '%s' backend: %.3g keys/s\n",
+		ntested, t, gift128_current_backend(), ntested / t);
+	return ret ? 1 : 0;
+}
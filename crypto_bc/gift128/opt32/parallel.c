@@ -0,0 +1,257 @@
+/*******************************************************************************
+* Multi-threaded GIFT-128 ECB and CTR over large buffers.
+*
+* The input is split into chunks of a configurable size which are processed
+* by a fixed pool of threads (the calling thread included), each of them
+* grabbing the next unprocessed chunk until none is left. Chunks go through
+* the regular ECB/CTR functions so that every thread benefits from the
+* backend selected at load time.
+*
+* Every thread works on its own copy of the round keys, aligned on a cache
+* line so that it never shares a line with data written by another thread.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "encrypt.h"
+
+#define CACHE_LINE			64
+#define DEFAULT_CHUNK_SIZE	(64*1024)
+
+enum { JOB_ECB_ENCRYPT, JOB_ECB_DECRYPT, JOB_CTR };
+
+/****************************************************************************
+* Round keys of a thread, padded to a whole number of cache lines.
+****************************************************************************/
+typedef struct {
+	gift128_ctx ctx;
+} __attribute__((aligned(CACHE_LINE))) worker_slot;
+
+typedef struct {
+	int op;
+	const gift128_ctx* ctx;
+	const u8* iv;
+	const u8* in;
+	u8* out;
+	u64 len;
+	u64 nchunks;
+	// written by all threads, hence kept away from the read-only fields
+	u64 next_chunk __attribute__((aligned(CACHE_LINE)));
+} job_t;
+
+struct gift128_pool {
+	pthread_mutex_t lock;
+	pthread_cond_t start;
+	pthread_cond_t done;
+	pthread_t* threads;
+	worker_slot* slots;
+	u32 nthreads;			// including the calling thread
+	u32 chunk_size;
+	u32 running;			// workers still busy with the current job
+	u64 generation;			// incremented for every new job
+	int stop;
+	job_t job;
+};
+
+typedef struct {
+	gift128_pool* pool;
+	u32 id;
+} worker_arg;
+
+/****************************************************************************
+* Processes chunks of the current job until none is left, using the round
+* keys of the slot 'id'.
+****************************************************************************/
+static void run_job(gift128_pool* pool, u32 id) {
+	job_t* job = &pool->job;
+	gift128_ctx* ctx = &pool->slots[id].ctx;
+	u64 chunk, offset, len;
+	memcpy(ctx, job->ctx, sizeof(gift128_ctx));
+	for(;;) {
+		chunk = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+		if(chunk >= job->nchunks)
+			break;
+		offset = chunk * pool->chunk_size;
+		len = job->len - offset;
+		if(len > pool->chunk_size)
+			len = pool->chunk_size;
+		switch(job->op) {
+			case JOB_ECB_ENCRYPT:
+				gift128_ecb_encrypt(ctx, job->out + offset, job->in + offset,
+					(u32)len);
+				break;
+			case JOB_ECB_DECRYPT:
+				gift128_ecb_decrypt(ctx, job->out + offset, job->in + offset,
+					(u32)len);
+				break;
+			default:
+				gift128_ctr_xor_at(ctx, job->iv, offset, job->in + offset,
+					job->out + offset, (u32)len);
+				break;
+		}
+	}
+}
+
+static void* worker(void* arg) {
+	gift128_pool* pool = ((worker_arg*)arg)->pool;
+	u32 id = ((worker_arg*)arg)->id;
+	u64 generation = 0;
+	free(arg);
+	pthread_mutex_lock(&pool->lock);
+	for(;;) {
+		while(!pool->stop && pool->generation == generation)
+			pthread_cond_wait(&pool->start, &pool->lock);
+		if(pool->stop)
+			break;
+		generation = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+		run_job(pool, id);
+		pthread_mutex_lock(&pool->lock);
+		if(--pool->running == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+/****************************************************************************
+* Creates a pool of 'nthreads' threads (calling thread included) processing
+* chunks of 'chunk_size' bytes. A null 'nthreads' stands for the number of
+* online processors and a null 'chunk_size' for 64 KiB. The chunk size is
+* rounded down to a multiple of the block size. Returns NULL on failure.
+****************************************************************************/
+gift128_pool* gift128_pool_create(u32 nthreads, u32 chunk_size) {
+	gift128_pool* pool;
+	void* slots;
+	if(nthreads == 0) {
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = (n > 0) ? (u32)n : 1;
+	}
+	if(chunk_size == 0)
+		chunk_size = DEFAULT_CHUNK_SIZE;
+	chunk_size -= chunk_size % BLOCK_SIZE;
+	if(chunk_size == 0)
+		chunk_size = BLOCK_SIZE;
+	pool = calloc(1, sizeof(gift128_pool));
+	if(!pool)
+		return NULL;
+	if(posix_memalign(&slots, CACHE_LINE, nthreads*sizeof(worker_slot))) {
+		free(pool);
+		return NULL;
+	}
+	pool->slots = slots;
+	pool->threads = calloc(nthreads, sizeof(pthread_t));
+	if(!pool->threads) {
+		free(pool->slots);
+		free(pool);
+		return NULL;
+	}
+	pool->nthreads = 1;
+	pool->chunk_size = chunk_size;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	// slot 0 is used by the calling thread
+	for(u32 i = 1; i < nthreads; i++) {
+		worker_arg* arg = malloc(sizeof(worker_arg));
+		if(!arg)
+			break;
+		arg->pool = pool;
+		arg->id = i;
+		if(pthread_create(&pool->threads[i], NULL, worker, arg) != 0) {
+			free(arg);
+			break;
+		}
+		pool->nthreads++;
+	}
+	return pool;
+}
+
+/****************************************************************************
+* Stops the threads of the pool and releases it. The round keys copied by the
+* threads are erased.
+****************************************************************************/
+void gift128_pool_destroy(gift128_pool* pool) {
+	if(!pool)
+		return;
+	pthread_mutex_lock(&pool->lock);
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	for(u32 i = 1; i < pool->nthreads; i++)
+		pthread_join(pool->threads[i], NULL);
+	memset(pool->slots, 0, pool->nthreads*sizeof(worker_slot));
+	__asm__ __volatile__("" : : "r"(pool->slots) : "memory");
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->start);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool->threads);
+	free(pool->slots);
+	free(pool);
+}
+
+/****************************************************************************
+* Returns the number of threads of the pool, calling thread included.
+****************************************************************************/
+u32 gift128_pool_threads(const gift128_pool* pool) {
+	return pool->nthreads;
+}
+
+/****************************************************************************
+* Runs a job on all threads of the pool and waits for its completion. Jobs
+* of a single chunk are processed by the calling thread only. A pool must
+* not be used by several threads at once.
+****************************************************************************/
+static void submit(gift128_pool* pool, int op, const gift128_ctx* ctx,
+			const u8* iv, const u8* in, u8* out, u64 len) {
+	job_t* job = &pool->job;
+	job->op = op;
+	job->ctx = ctx;
+	job->iv = iv;
+	job->in = in;
+	job->out = out;
+	job->len = len;
+	job->nchunks = (len + pool->chunk_size - 1) / pool->chunk_size;
+	job->next_chunk = 0;
+	if(job->nchunks <= 1 || pool->nthreads == 1) {
+		run_job(pool, 0);
+		return;
+	}
+	pthread_mutex_lock(&pool->lock);
+	pool->running = pool->nthreads - 1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	run_job(pool, 0);
+	pthread_mutex_lock(&pool->lock);
+	while(pool->running > 0)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/****************************************************************************
+* Multi-threaded GIFT-128 ECB. Note that 'len' must be a multiple of 16.
+****************************************************************************/
+int gift128_pool_ecb_encrypt(gift128_pool* pool, const gift128_ctx* ctx,
+			u8* ctext, const u8* ptext, u64 len) {
+	submit(pool, JOB_ECB_ENCRYPT, ctx, NULL, ptext, ctext, len);
+	return 0;
+}
+
+int gift128_pool_ecb_decrypt(gift128_pool* pool, const gift128_ctx* ctx,
+			u8* ptext, const u8* ctext, u64 len) {
+	submit(pool, JOB_ECB_DECRYPT, ctx, NULL, ctext, ptext, len);
+	return 0;
+}
+
+/****************************************************************************
+* Multi-threaded GIFT-128 CTR, same as 'gift128_ctr_xor' for any 'len'.
+****************************************************************************/
+int gift128_pool_ctr_xor(gift128_pool* pool, const gift128_ctx* ctx,
+			const u8* iv, const u8* in, u8* out, u64 len) {
+	submit(pool, JOB_CTR, ctx, iv, in, out, len);
+	return 0;
+}
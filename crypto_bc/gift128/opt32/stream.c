@@ -0,0 +1,128 @@
+/*******************************************************************************
+* Incremental (init/update/final) GIFT-128 ECB and CTR.
+*
+* Data can be passed in chunks of any size. Bytes that do not fill a whole
+* block are kept in the stream state until the next call, while all the whole
+* blocks available in a chunk are processed at once so that they go through
+* the parallel kernels of the selected backend.
+*******************************************************************************/
+#include <string.h>
+#include "encrypt.h"
+
+/*****************************************************************************
+* Starts an ECB encryption or decryption ('encrypting' = 1/0) with the round
+* keys of 'ctx', which must remain valid until the stream is finalized.
+*****************************************************************************/
+void gift128_ecb_stream_init(gift128_ecb_stream* s, const gift128_ctx* ctx,
+			int encrypting) {
+	s->ctx = ctx;
+	s->encrypting = encrypting;
+	s->buf_len = 0;
+}
+
+static void ecb_blocks(const gift128_ecb_stream* s, u8* out, const u8* in,
+			u32 len) {
+	if(s->encrypting)
+		gift128_ecb_encrypt(s->ctx, out, in, len);
+	else
+		gift128_ecb_decrypt(s->ctx, out, in, len);
+}
+
+/*****************************************************************************
+* Processes 'len' bytes and returns the number of bytes written to 'out',
+* which is always a multiple of 16 and at most 'len' + 15. 'out' and 'in' can
+* be equal as long as all the previous calls were on multiples of 16 bytes.
+*****************************************************************************/
+u32 gift128_ecb_stream_update(gift128_ecb_stream* s, u8* out, const u8* in,
+			u32 len) {
+	u32 n, written = 0;
+	if(s->buf_len > 0) {
+		n = BLOCK_SIZE - s->buf_len;
+		if(n > len)
+			n = len;
+		memcpy(s->buf + s->buf_len, in, n);
+		s->buf_len += n;
+		in += n;
+		len -= n;
+		if(s->buf_len < BLOCK_SIZE)
+			return 0;
+		ecb_blocks(s, out, s->buf, BLOCK_SIZE);
+		s->buf_len = 0;
+		out += BLOCK_SIZE;
+		written = BLOCK_SIZE;
+	}
+	n = len - len % BLOCK_SIZE;
+	if(n > 0) {
+		ecb_blocks(s, out, in, n);
+		written += n;
+	}
+	s->buf_len = len - n;
+	memcpy(s->buf, in + n, s->buf_len);
+	return written;
+}
+
+/*****************************************************************************
+* Ends the stream and erases its internal buffer. Returns -1 if the total
+* length of the input was not a multiple of 16, 0 otherwise.
+*****************************************************************************/
+int gift128_ecb_stream_final(gift128_ecb_stream* s) {
+	int ret = (s->buf_len == 0) ? 0 : -1;
+	memset(s, 0, sizeof(gift128_ecb_stream));
+	__asm__ __volatile__("" : : "r"(s) : "memory");
+	return ret;
+}
+
+/*****************************************************************************
+* Starts a CTR encryption/decryption with the round keys of 'ctx', which must
+* remain valid until the stream is finalized, and the initial counter block
+* 'iv'.
+*****************************************************************************/
+void gift128_ctr_stream_init(gift128_ctr_stream* s, const gift128_ctx* ctx,
+			const u8* iv) {
+	s->ctx = ctx;
+	memcpy(s->iv, iv, BLOCK_SIZE);
+	s->offset = 0;
+}
+
+/*****************************************************************************
+* Processes 'len' bytes, the output being always as long as the input. The
+* unused part of the last keystream block is kept for the next call.
+*****************************************************************************/
+int gift128_ctr_stream_update(gift128_ctr_stream* s, u8* out, const u8* in,
+			u32 len) {
+	u32 n, used = s->offset % BLOCK_SIZE;
+	if(used > 0) {
+		n = BLOCK_SIZE - used;
+		if(n > len)
+			n = len;
+		for(u32 i = 0; i < n; i++)
+			out[i] = in[i] ^ s->keystream[used + i];
+		s->offset += n;
+		in += n;
+		out += n;
+		len -= n;
+	}
+	n = len - len % BLOCK_SIZE;
+	if(n > 0) {
+		gift128_ctr_xor_at(s->ctx, s->iv, s->offset, in, out, n);
+		s->offset += n;
+	}
+	if(len > n) {
+		memset(s->keystream, 0, BLOCK_SIZE);
+		gift128_ctr_xor_at(s->ctx, s->iv, s->offset, s->keystream,
+			s->keystream, BLOCK_SIZE);
+		for(u32 i = 0; i < len - n; i++)
+			out[n + i] = in[n + i] ^ s->keystream[i];
+		s->offset += len - n;
+	}
+	return 0;
+}
+
+/*****************************************************************************
+* Ends the stream and erases the remaining keystream.
+*****************************************************************************/
+int gift128_ctr_stream_final(gift128_ctr_stream* s) {
+	memset(s, 0, sizeof(gift128_ctr_stream));
+	__asm__ __volatile__("" : : "r"(s) : "memory");
+	return 0;
+}
@@ -0,0 +1,179 @@
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include "gift128.hpp"
+// both wrappers can be used in the same translation unit
+#include "../../gift64/opt32/gift64.hpp"
+
+static_assert(gift::Gift128::block_size == 16 && gift::gift64_block_size == 8,
+	"GIFT-128 and GIFT-64 block sizes mixed up");
+
+constexpr std::size_t block_size = gift::Gift128::block_size;
+constexpr std::size_t key_size = gift::Gift128::key_size;
+
+const u8 key[2][key_size] = {
+	{0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,	//2nd key
+	0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10},
+	{0xd0, 0xf5, 0xc5, 0x9a, 0x77, 0x00, 0xd3, 0xe7,	//3rd key
+	0x99, 0x02, 0x8f, 0xa9, 0xf9, 0x0a, 0xd8, 0x37}
+};
+const u8 ptext[2][block_size] = {
+	{0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,	//2nd plaintext
+	0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10},
+	{0xe3, 0x9c, 0x14, 0x1f, 0xa5, 0x7d, 0xba, 0x43,	//3rd plaintext
+	0xf0, 0x8a, 0x85, 0xb6, 0xa9, 0x1f, 0x86, 0xc1}
+};
+const u8 ctext[2][block_size] = {
+	{0x84, 0x22, 0x24, 0x1a, 0x6d, 0xbf, 0x5a, 0x93,	//2nd ciphertext
+	0x46, 0xaf, 0x46, 0x84, 0x09, 0xee, 0x01, 0x52},
+	{0x13, 0xed, 0xe6, 0x7c, 0xbd, 0xcc, 0x3d, 0xbf,	//3rd ciphertext
+	0x40, 0x0a, 0x62, 0xd6, 0x97, 0x72, 0x65, 0xea}
+};
+
+// round keys of the 3rd test vector, computed at compile time
+constexpr gift128_ctx firmware_ctx = gift::gift128_rkeys(key[1]);
+
+constexpr std::size_t NBLOCKS = 37;	// not a multiple of any batch size
+
+/*****************************************************************************
+* Checks the single-block and ECB member functions against the test vectors,
+* in place or not, and that inputs of invalid lengths are rejected.
+*****************************************************************************/
+int check_ecb(int i) {
+	u8 input[NBLOCKS*block_size], output[NBLOCKS*block_size], block[block_size];
+	gift::Gift128 cipher(key[i]);
+	cipher.encrypt_block(block, ptext[i]);
+	if(std::memcmp(block, ctext[i], block_size) != 0)
+		return -1;
+	cipher.decrypt_block(block, ctext[i]);
+	if(std::memcmp(block, ptext[i], block_size) != 0)
+		return -1;
+	for(std::size_t j = 0; j < NBLOCKS; j++)
+		std::memcpy(input + j*block_size, ptext[i], block_size);
+	if(!cipher.ecb_encrypt(output, input))
+		return -1;
+	for(std::size_t j = 0; j < NBLOCKS; j++)
+		if(std::memcmp(output + j*block_size, ctext[i], block_size) != 0)
+			return -1;
+	if(!cipher.ecb_decrypt(output, output) ||
+			std::memcmp(output, input, sizeof(input)) != 0)
+		return -1;
+	// GIFTb-128 round trip, checked against the C interface
+	if(!cipher.ecbb_encrypt(output, input))
+		return -1;
+	giftb128_encrypt_block(&cipher.ctx(), block, input);
+	if(std::memcmp(output, block, block_size) != 0)
+		return -1;
+	if(!cipher.ecbb_decrypt(output, output) ||
+			std::memcmp(output, input, sizeof(input)) != 0)
+		return -1;
+	// partial block or output too short
+	std::span<const u8> in(input);
+	if(cipher.ecb_encrypt(output, in.first(block_size + 1)) ||
+			cipher.ecb_encrypt(std::span(output).first(block_size), in))
+		return -1;
+	return 0;
+}
+
+/*****************************************************************************
+* Checks that CTR calls starting at any offset of the keystream, including
+* offsets in the middle of a block, match a single call of the C interface,
+* both through 'Gift128' and through 'Gift128Ref' on compile-time round keys.
+*****************************************************************************/
+int check_ctr(void) {
+	u8 iv[block_size], input[NBLOCKS*block_size], output[NBLOCKS*block_size];
+	u8 ref[NBLOCKS*block_size];
+	gift::Gift128 cipher(key[1]);
+	gift::Gift128Ref firmware(firmware_ctx);
+	for(std::size_t i = 0; i < block_size; i++)
+		iv[i] = (i < 13) ? key[1][i] : 0xff;
+	for(std::size_t i = 0; i < sizeof(input); i++)
+		input[i] = (u8)(i*13 + 1);
+	gift128_ctr_xor(&cipher.ctx(), iv, input, ref, sizeof(input));
+	for(std::size_t off : {0, 1, 15, 16, 100}) {
+		std::span<const u8> in = std::span<const u8>(input).subspan(off);
+		std::span<u8> out = std::span<u8>(output).subspan(off);
+		std::memset(output, 0, sizeof(output));
+		if(!cipher.ctr_xor(iv, in, out, off) ||
+				std::memcmp(output + off, ref + off, in.size()) != 0)
+			return -1;
+		std::memset(output, 0, sizeof(output));
+		if(!firmware.ctr_xor(iv, in, out, off) ||
+				std::memcmp(output + off, ref + off, in.size()) != 0)
+			return -1;
+	}
+	// output too short
+	if(cipher.ctr_xor(iv, input, std::span(output).first(sizeof(output) - 1)))
+		return -1;
+	return 0;
+}
+
+/*****************************************************************************
+* Checks that moving a 'Gift128' transfers the round keys and erases those of
+* the moved-from object.
+*****************************************************************************/
+static bool is_wiped(const gift::Gift128& cipher) {
+	const gift128_ctx& ctx = cipher.ctx();
+	for(std::size_t i = 0; i < sizeof(ctx.rkey)/sizeof(u32); i++)
+		if(ctx.rkey[i] != 0)
+			return false;
+	return true;
+}
+
+int check_move(void) {
+	u8 block[block_size];
+	gift::Gift128 a(key[0]);
+	gift::Gift128 b(std::move(a));
+	if(!is_wiped(a))
+		return -1;
+	b.encrypt_block(block, ptext[0]);
+	if(std::memcmp(block, ctext[0], block_size) != 0)
+		return -1;
+	gift::Gift128 c(key[1]);
+	c = std::move(b);
+	if(!is_wiped(b))
+		return -1;
+	c.encrypt_block(block, ptext[0]);
+	if(std::memcmp(block, ctext[0], block_size) != 0)
+		return -1;
+	// a moved-from object can be rekeyed
+	a.rekey(key[1]);
+	a.encrypt_block(block, ptext[1]);
+	if(std::memcmp(block, ctext[1], block_size) != 0)
+		return -1;
+	return 0;
+}
+
+int run_tests(void) {
+	for(int i = 0; i < 2; i++) {
+		if(check_ecb(i) != 0) {
+			std::printf("ECB wrappers failed! :(\n");
+			return -1;
+		}
+	}
+	if(check_ctr() != 0) {
+		std::printf("CTR wrappers failed! :(\n");
+		return -1;
+	}
+	if(check_move() != 0) {
+		std::printf("Move semantics failed! :(\n");
+		return -1;
+	}
+	return 0;
+}
+
+int main() {
+	const char* name;
+	for(u32 i = 0; (name = gift128_backend_name(i)) != nullptr; i++) {
+		if(gift128_select_backend(name) != 0) {
+			std::printf("Backend '%s' not supported, skipped.\n", name);
+			continue;
+		}
+		if(run_tests() != 0) {
+			std::printf("Backend '%s' failed! :(\n", name);
+			return -1;
+		}
+	}
+	std::printf("All C++ tests have passed successfully! :)\n");
+	return 0;
+}
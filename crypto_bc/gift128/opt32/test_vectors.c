@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "encrypt.h"
+#include "gift128.h"
 
 u8 key[3][KEY_SIZE] = {
 	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	//1st key
@@ -27,9 +28,560 @@ u8 ctext[3][BLOCK_SIZE] = {
 	0x40, 0x0a, 0x62, 0xd6, 0x97, 0x72, 0x65, 0xea}
 };
 
-int main() {
+#define NBLOCKS		37		// not a multiple of any parallel batch size
+
+/*****************************************************************************
+* Checks that multi-block GIFT-128/GIFTb-128 ECB calls, which go through the
+* parallel kernels when available, match the block-by-block processing.
+*****************************************************************************/
+int check_multiblock(const u8* k) {
+	u8 input[NBLOCKS*BLOCK_SIZE], output[NBLOCKS*BLOCK_SIZE];
+	u8 ref[NBLOCKS*BLOCK_SIZE];
+	gift128_ctx ctx;
+	for(int i = 0; i < NBLOCKS*BLOCK_SIZE; i++)
+		input[i] = (u8)(i*7 + k[i % KEY_SIZE]);
+	for(int i = 0; i < NBLOCKS; i++)
+		gift128_encrypt_ecb(ref + i*BLOCK_SIZE, input + i*BLOCK_SIZE,
+			BLOCK_SIZE, k);
+	gift128_encrypt_ecb(output, input, NBLOCKS*BLOCK_SIZE, k);
+	if(memcmp(output, ref, NBLOCKS*BLOCK_SIZE) != 0)
+		return -1;
+	gift128_decrypt_ecb(output, ref, NBLOCKS*BLOCK_SIZE, k);
+	if(memcmp(output, input, NBLOCKS*BLOCK_SIZE) != 0)
+		return -1;
+	gift128_init(&ctx, k);
+	for(int i = 0; i < NBLOCKS; i++)
+		giftb128_encrypt_block(&ctx, ref + i*BLOCK_SIZE, input + i*BLOCK_SIZE);
+	giftb128_ecb_encrypt(&ctx, output, input, NBLOCKS*BLOCK_SIZE);
+	if(memcmp(output, ref, NBLOCKS*BLOCK_SIZE) != 0)
+		return -1;
+	giftb128_ecb_decrypt(&ctx, output, ref, NBLOCKS*BLOCK_SIZE);
+	if(memcmp(output, input, NBLOCKS*BLOCK_SIZE) != 0)
+		return -1;
+	return 0;
+}
+
+/*****************************************************************************
+* Checks the on-the-fly key schedule mode against the precomputed round keys,
+* on single blocks (round keys derived during encryption) and multiple ones.
+*****************************************************************************/
+int check_otf(const u8* k) {
+	u8 input[NBLOCKS*BLOCK_SIZE], output[NBLOCKS*BLOCK_SIZE];
+	u8 ref[NBLOCKS*BLOCK_SIZE];
+	gift128_otf_ctx otf;
+	gift128_ctx ctx;
+	int ret = 0;
+	for(int i = 0; i < NBLOCKS*BLOCK_SIZE; i++)
+		input[i] = (u8)(i*5 + k[i % KEY_SIZE]);
+	gift128_init(&ctx, k);
+	gift128_otf_init(&otf, k);
+	gift128_ecb_encrypt(&ctx, ref, input, NBLOCKS*BLOCK_SIZE);
+	for(int i = 0; i < NBLOCKS; i++)
+		gift128_otf_ecb_encrypt(&otf, output + i*BLOCK_SIZE,
+			input + i*BLOCK_SIZE, BLOCK_SIZE);
+	ret |= memcmp(output, ref, NBLOCKS*BLOCK_SIZE);
+	gift128_otf_ecb_encrypt(&otf, output, input, NBLOCKS*BLOCK_SIZE);
+	ret |= memcmp(output, ref, NBLOCKS*BLOCK_SIZE);
+	gift128_otf_ecb_decrypt(&otf, output, ref, NBLOCKS*BLOCK_SIZE);
+	ret |= memcmp(output, input, NBLOCKS*BLOCK_SIZE);
+	giftb128_ecb_encrypt(&ctx, ref, input, NBLOCKS*BLOCK_SIZE);
+	for(int i = 0; i < NBLOCKS; i++)
+		giftb128_otf_ecb_encrypt(&otf, output + i*BLOCK_SIZE,
+			input + i*BLOCK_SIZE, BLOCK_SIZE);
+	ret |= memcmp(output, ref, NBLOCKS*BLOCK_SIZE);
+	giftb128_otf_ecb_encrypt(&otf, output, input, NBLOCKS*BLOCK_SIZE);
+	ret |= memcmp(output, ref, NBLOCKS*BLOCK_SIZE);
+	giftb128_otf_ecb_decrypt(&otf, output, ref, NBLOCKS*BLOCK_SIZE);
+	ret |= memcmp(output, input, NBLOCKS*BLOCK_SIZE);
+	return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Checks CTR mode against ECB encryption of the counter blocks, including a
+* carry propagation over several bytes, and checks that processing the input
+* in arbitrary chunks with the keystream offset gives the same result, also
+* when an unaligned offset makes a chunk span one more block than a batch.
+*****************************************************************************/
+int check_ctr(const u8* k) {
+	u8 iv[BLOCK_SIZE], ctr[NBLOCKS*BLOCK_SIZE], input[NBLOCKS*BLOCK_SIZE];
+	u8 output[NBLOCKS*BLOCK_SIZE], ref[NBLOCKS*BLOCK_SIZE];
+	u32 len = NBLOCKS*BLOCK_SIZE - 5, off = 0, chunk = 1;
+	gift128_ctx ctx;
+	gift128_init(&ctx, k);
+	for(int i = 0; i < BLOCK_SIZE; i++)
+		iv[i] = (i < 13) ? k[i] : 0xff;
+	for(int i = 0; i < NBLOCKS; i++) {
+		memcpy(ctr + i*BLOCK_SIZE, iv, BLOCK_SIZE);
+		for(int j = BLOCK_SIZE - 1, carry = i; j >= 0; j--) {
+			carry += ctr[i*BLOCK_SIZE + j];
+			ctr[i*BLOCK_SIZE + j] = (u8)carry;
+			carry >>= 8;
+		}
+	}
+	gift128_ecb_encrypt(&ctx, ref, ctr, NBLOCKS*BLOCK_SIZE);
+	for(u32 i = 0; i < len; i++) {
+		input[i] = (u8)(i*13 + 1);
+		ref[i] ^= input[i];
+	}
+	gift128_ctr_xor(&ctx, iv, input, output, len);
+	if(memcmp(output, ref, len) != 0)
+		return -1;
+	memset(output, 0, len);
+	while(off < len) {
+		if(chunk > len - off)
+			chunk = len - off;
+		gift128_ctr_xor_at(&ctx, iv, off, input + off, output + off, chunk);
+		off += chunk;
+		chunk = chunk*3 + 1;
+	}
+	if(memcmp(output, ref, len) != 0)
+		return -1;
+	// unaligned offsets with lengths around the 16-block batch of 'ctr.c'
+	for(off = 1; off < BLOCK_SIZE; off += 7) {
+		for(chunk = 16*BLOCK_SIZE - off - 2; chunk <= 16*BLOCK_SIZE + 1;
+				chunk++) {
+			memset(output, 0, len);
+			gift128_ctr_xor_at(&ctx, iv, off, input + off, output + off,
+				chunk);
+			if(memcmp(output + off, ref + off, chunk) != 0)
+				return -1;
+		}
+	}
+	return 0;
+}
+
+/*****************************************************************************
+* Checks that the incremental ECB/CTR fed with chunks of irregular sizes match
+* the one-shot functions.
+*****************************************************************************/
+int check_stream(const u8* k) {
+	u8 iv[BLOCK_SIZE], input[NBLOCKS*BLOCK_SIZE], output[NBLOCKS*BLOCK_SIZE];
+	u8 ref[NBLOCKS*BLOCK_SIZE];
+	u32 len = NBLOCKS*BLOCK_SIZE - 3, off, out_off, chunk;
+	gift128_ecb_stream ecb;
+	gift128_ctr_stream ctr;
+	gift128_ctx ctx;
+	int ret = 0;
+	for(u32 i = 0; i < NBLOCKS*BLOCK_SIZE; i++)
+		input[i] = (u8)(i*11 + k[i % KEY_SIZE]);
+	memcpy(iv, k, BLOCK_SIZE);
+	gift128_init(&ctx, k);
+	for(int encrypting = 0; encrypting < 2; encrypting++) {
+		if(encrypting)
+			gift128_ecb_encrypt(&ctx, ref, input, NBLOCKS*BLOCK_SIZE);
+		else
+			gift128_ecb_decrypt(&ctx, ref, input, NBLOCKS*BLOCK_SIZE);
+		memset(output, 0, NBLOCKS*BLOCK_SIZE);
+		gift128_ecb_stream_init(&ecb, &ctx, encrypting);
+		for(off = 0, out_off = 0, chunk = 5; off < NBLOCKS*BLOCK_SIZE;
+				off += chunk, chunk = chunk*2 + 3) {
+			if(chunk > NBLOCKS*BLOCK_SIZE - off)
+				chunk = NBLOCKS*BLOCK_SIZE - off;
+			out_off += gift128_ecb_stream_update(&ecb, output + out_off,
+				input + off, chunk);
+		}
+		ret |= gift128_ecb_stream_final(&ecb);
+		ret |= (out_off != NBLOCKS*BLOCK_SIZE);
+		ret |= memcmp(output, ref, NBLOCKS*BLOCK_SIZE);
+	}
+	gift128_ecb_stream_init(&ecb, &ctx, 1);
+	gift128_ecb_stream_update(&ecb, output, input, 7);
+	ret |= (gift128_ecb_stream_final(&ecb) == 0);
+	gift128_ctr_xor(&ctx, iv, input, ref, len);
+	memset(output, 0, len);
+	gift128_ctr_stream_init(&ctr, &ctx, iv);
+	for(off = 0, chunk = 1; off < len; off += chunk, chunk = chunk*3 + 2) {
+		if(chunk > len - off)
+			chunk = len - off;
+		gift128_ctr_stream_update(&ctr, output + off, input + off, chunk);
+	}
+	gift128_ctr_stream_final(&ctr);
+	ret |= memcmp(output, ref, len);
+	return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Checks that the batched key schedules match 'precompute_rkeys'.
+*****************************************************************************/
+int check_rkeys_xn(void) {
+	u8 keys[16][KEY_SIZE];
+	u32 rkeys[16][80], ref[80];
+	for(int i = 0; i < 16; i++)
+		for(int j = 0; j < KEY_SIZE; j++)
+			keys[i][j] = (u8)(i*31 + j*17 + (i^j));
+	for(int n = 4; n <= 16; n *= 2) {
+		memset(rkeys, 0, sizeof(rkeys));
+		if(n == 4)
+			precompute_rkeys_x4(rkeys, keys);
+		else if(n == 8)
+			precompute_rkeys_x8(rkeys, keys);
+		else
+			precompute_rkeys_x16(rkeys, keys);
+		for(int i = 0; i < n; i++) {
+			precompute_rkeys(ref, keys[i]);
+			if(memcmp(rkeys[i], ref, sizeof(ref)) != 0)
+				return -1;
+		}
+	}
+	return 0;
+}
+
+/*****************************************************************************
+* Checks that multi-key encryption/decryption matches the single-key one, for
+* full and partial sets of keys.
+*****************************************************************************/
+int check_multikey(void) {
+	u8 keys[GIFT128_LANES][KEY_SIZE];
+	u8 input[GIFT128_LANES*BLOCK_SIZE], output[GIFT128_LANES*BLOCK_SIZE];
+	u8 ref[GIFT128_LANES*BLOCK_SIZE];
+	gift128_multikey_ctx mctx;
+	gift128_ctx ctx;
+	for(int i = 0; i < GIFT128_LANES; i++)
+		for(int j = 0; j < KEY_SIZE; j++)
+			keys[i][j] = (u8)(i*59 + j*13 + (i^j));
+	for(int i = 0; i < GIFT128_LANES*BLOCK_SIZE; i++)
+		input[i] = (u8)(i*7 + 3);
+	for(u32 n = 1; n <= GIFT128_LANES; n += 5) {
+		gift128_multikey_init(&mctx, (const u8 (*)[KEY_SIZE])keys, n);
+		for(u32 i = 0; i < n; i++) {
+			gift128_init(&ctx, keys[i]);
+			gift128_encrypt_block(&ctx, ref + i*BLOCK_SIZE,
+				input + i*BLOCK_SIZE);
+		}
+		gift128_multikey_encrypt(&mctx, output, input, n);
+		if(memcmp(output, ref, n*BLOCK_SIZE) != 0)
+			return -1;
+		gift128_multikey_decrypt(&mctx, output, ref, n);
+		if(memcmp(output, input, n*BLOCK_SIZE) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*****************************************************************************
+* Checks that keys and blocks at any alignment give the same results as the
+* aligned ones.
+*****************************************************************************/
+int check_unaligned(const u8* k) {
+	u8 input[NBLOCKS*BLOCK_SIZE + 3], output[NBLOCKS*BLOCK_SIZE + 3];
+	u8 ref[NBLOCKS*BLOCK_SIZE], refb[NBLOCKS*BLOCK_SIZE], k_off[KEY_SIZE + 3];
+	gift128_ctx ctx;
+	int ret = 0;
+	for(int i = 0; i < NBLOCKS*BLOCK_SIZE; i++)
+		ref[i] = (u8)(i*5 + k[i % KEY_SIZE]);
+	gift128_init(&ctx, k);
+	gift128_ecb_encrypt(&ctx, output, ref, NBLOCKS*BLOCK_SIZE);
+	giftb128_ecb_encrypt(&ctx, refb, ref, NBLOCKS*BLOCK_SIZE);
+	memcpy(ref, output, NBLOCKS*BLOCK_SIZE);
+	for(int off = 1; off < 4; off++) {
+		memcpy(k_off + off, k, KEY_SIZE);
+		for(int i = 0; i < NBLOCKS*BLOCK_SIZE; i++)
+			input[i + off] = (u8)(i*5 + k[i % KEY_SIZE]);
+		gift128_init(&ctx, k_off + off);
+		gift128_ecb_encrypt(&ctx, output + 4 - off, input + off,
+			NBLOCKS*BLOCK_SIZE);
+		ret |= memcmp(output + 4 - off, ref, NBLOCKS*BLOCK_SIZE);
+		giftb128_ecb_encrypt(&ctx, output + off, input + off,
+			NBLOCKS*BLOCK_SIZE);
+		ret |= memcmp(output + off, refb, NBLOCKS*BLOCK_SIZE);
+		giftb128_ecb_decrypt(&ctx, output + off, output + off,
+			NBLOCKS*BLOCK_SIZE);
+		ret |= memcmp(output + off, input + off, NBLOCKS*BLOCK_SIZE);
+	}
+	return ret ? -1 : 0;
+}
+
+#define PARALLEL_LEN	(40*BLOCK_SIZE*NBLOCKS + 5)
+
+/*****************************************************************************
+* Checks that the multi-threaded ECB/CTR match the single-threaded ones, with
+* small chunks so that every thread processes several of them.
+*****************************************************************************/
+int check_parallel(const u8* k) {
+	static u8 input[PARALLEL_LEN], output[PARALLEL_LEN], ref[PARALLEL_LEN];
+	const u32 ecb_len = PARALLEL_LEN - PARALLEL_LEN % BLOCK_SIZE;
+	u8 iv[BLOCK_SIZE] = {0};
+	gift128_pool* pool;
+	gift128_ctx ctx;
+	int ret = 0;
+	for(int i = 0; i < PARALLEL_LEN; i++)
+		input[i] = (u8)(i*13 + k[i % KEY_SIZE]);
+	iv[BLOCK_SIZE - 1] = 0xf0;
+	gift128_init(&ctx, k);
+	pool = gift128_pool_create(4, 10*BLOCK_SIZE + 3);
+	if(!pool)
+		return -1;
+	gift128_ecb_encrypt(&ctx, ref, input, ecb_len);
+	gift128_pool_ecb_encrypt(pool, &ctx, output, input, ecb_len);
+	ret |= memcmp(output, ref, ecb_len);
+	gift128_pool_ecb_decrypt(pool, &ctx, output, ref, ecb_len);
+	ret |= memcmp(output, input, ecb_len);
+	gift128_ctr_xor(&ctx, iv, input, ref, PARALLEL_LEN);
+	gift128_pool_ctr_xor(pool, &ctx, iv, input, output, PARALLEL_LEN);
+	ret |= memcmp(output, ref, PARALLEL_LEN);
+	gift128_pool_destroy(pool);
+	return ret ? -1 : 0;
+}
+
+#define BITSLICED_LEN	(600*BLOCK_SIZE + 7)
+
+/*****************************************************************************
+* Checks the bitsliced engine against the fixsliced one, on a number of
+* blocks that is not a multiple of any batch size.
+*****************************************************************************/
+int check_bitsliced(const u8* k) {
+	static u8 input[BITSLICED_LEN], output[BITSLICED_LEN], ref[BITSLICED_LEN];
+	const u32 ecb_len = BITSLICED_LEN - BITSLICED_LEN % BLOCK_SIZE;
+	u8 iv[BLOCK_SIZE] = {0};
+	gift128_bitsliced_ctx bs_ctx;
+	gift128_ctx ctx;
+	int ret = 0;
+	for(int i = 0; i < BITSLICED_LEN; i++)
+		input[i] = (u8)(i*7 + k[i % KEY_SIZE]);
+	iv[BLOCK_SIZE - 1] = 0xfe;
+	gift128_init(&ctx, k);
+	gift128_bitsliced_init(&bs_ctx, k);
+	gift128_ecb_encrypt(&ctx, ref, input, ecb_len);
+	gift128_bitsliced_ecb_encrypt(&bs_ctx, output, input, ecb_len);
+	ret |= memcmp(output, ref, ecb_len);
+	gift128_bitsliced_ecb_decrypt(&bs_ctx, output, ref, ecb_len);
+	ret |= memcmp(output, input, ecb_len);
+	gift128_ctr_xor(&ctx, iv, input, ref, BITSLICED_LEN);
+	gift128_bitsliced_ctr_xor(&bs_ctx, iv, input, output, BITSLICED_LEN);
+	ret |= memcmp(output, ref, BITSLICED_LEN);
+	return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Checks that the key search finds the i-th test key from its test vector
+* when 14 of its bits are unknown, and fails on a wrong ciphertext or on too
+* many unknown bits.
+*****************************************************************************/
+int check_keysearch(int i) {
+	gift128_keysearch ks;
+	u8 found[KEY_SIZE];
+	u64 ntested;
+	int ret = 0;
+	memcpy(ks.key, key[i], KEY_SIZE);
+	memset(ks.mask, 0, KEY_SIZE);
+	ks.mask[0] = 0x0f;
+	ks.mask[7] = 0x3c;
+	ks.mask[15] = 0x3f;
+	for(int j = 0; j < KEY_SIZE; j++)
+		ks.key[j] ^= ks.mask[j] & 0xa5;		// wrong unknown bits
+	memcpy(ks.ptext, ptext[i], BLOCK_SIZE);
+	memcpy(ks.ctext, ctext[i], BLOCK_SIZE);
+	ret |= gift128_key_search(&ks, 4, found, &ntested);
+	ret |= memcmp(found, key[i], KEY_SIZE);
+	ks.ctext[5] ^= 0x10;
+	ret |= (gift128_key_search(&ks, 0, found, &ntested) != -1);
+	ret |= (ntested != (1 << 14));
+	memset(ks.mask, 0xff, KEY_SIZE);
+	ret |= (gift128_key_search(&ks, 1, found, NULL) != -1);
+	return ret ? -1 : 0;
+}
+
+#define EXP_LOG_N		12
+
+static u64 splitmix64(u64 x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+/*****************************************************************************
+* Checks the differential and linear experiments against a straightforward
+* computation on the plaintexts documented in 'experiment.c'.
+*****************************************************************************/
+int check_experiment(const u8* k) {
+	static u64 hist[1 << 16], ref[1 << 16];
+	gift128_experiment exp = {3, 4, EXP_LOG_N, 0x0123456789abcdefULL,
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01},
+		{0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f}};
+	u8 p[2*BLOCK_SIZE], c[2*BLOCK_SIZE];
+	u64 count, ref_count = 0;
+	gift128_ctx ctx;
+	int ret = 0;
+	gift128_init(&ctx, k);
+	memset(ref, 0, sizeof(ref));
+	for(u64 i = 0; i < (1 << EXP_LOG_N); i++) {
+		u64 w0 = splitmix64(exp.seed + (2*i + 1)*0x9e3779b97f4a7c15ULL);
+		u64 w1 = splitmix64(exp.seed + (2*i + 2)*0x9e3779b97f4a7c15ULL);
+		u32 index = 0, l = 0, parity = 0;
+		for(int j = 0; j < 8; j++) {
+			p[j] = (u8)(w0 >> 8*j);
+			p[8 + j] = (u8)(w1 >> 8*j);
+		}
+		for(int j = 0; j < BLOCK_SIZE; j++)
+			p[BLOCK_SIZE + j] = p[j] ^ exp.in[j];
+		gift128_encrypt_rounds(&ctx, c, p, 2*BLOCK_SIZE, 3, 4);
+		for(int j = 8*BLOCK_SIZE - 1; j >= 0; j--) {
+			if((exp.out[j / 8] >> (7 - j % 8)) & 1)
+				index |= (((c[j / 8] ^ c[BLOCK_SIZE + j / 8]) >>
+					(7 - j % 8)) & 1) << l++;
+			parity ^= ((p[j / 8] & exp.in[j / 8]) >> (7 - j % 8)) & 1;
+			parity ^= ((c[j / 8] & exp.out[j / 8]) >> (7 - j % 8)) & 1;
+		}
+		ref[index]++;
+		ref_count += !parity;
+	}
+	ret |= gift128_differential(&ctx, &exp, 4, hist);
+	ret |= memcmp(hist, ref, sizeof(ref));
+	// the plaintexts of the linear experiment are the first of the pairs
+	ret |= gift128_linear(&ctx, &exp, 3, &count);
+	ret |= (count != ref_count);
+	exp.out[3] = 0x1f;
+	ret |= (gift128_differential(&ctx, &exp, 1, hist) != -1);
+	return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Round 'r' of GIFT-128 as in the specification, on the bits of the state (bit
+* 127 being the MSB of the first byte) with the classical round keys of
+* 'gift128_bitsliced_init'.
+*****************************************************************************/
+void classical_round(u8* bits, const u32* rkey, int r) {
+	const u8 sbox[16] = {1, 10, 4, 12, 6, 15, 3, 9, 2, 13, 11, 7, 5, 0, 8, 14};
+	u8 sub[128], c = 0;
+	for(int i = 0; i <= r; i++)		// 6-bit LFSR of the round constants
+		c = ((c << 1) | (((c >> 5) ^ (c >> 4) ^ 1) & 1)) & 0x3f;
+	for(int i = 0; i < 128; i += 4) {
+		u8 x = sbox[bits[i] | (bits[i+1] << 1) | (bits[i+2] << 2) |
+			(bits[i+3] << 3)];
+		for(int j = 0; j < 4; j++)
+			sub[i+j] = (x >> j) & 1;
+	}
+	for(int i = 0; i < 128; i++)
+		bits[4*(i/16) + 32*((3*((i%16)/4) + (i%4)) % 4) + (i%4)] = sub[i];
+	for(int i = 0; i < 32; i++) {
+		bits[4*i + 2] ^= (rkey[2*r] >> i) & 1;
+		bits[4*i + 1] ^= (rkey[2*r + 1] >> i) & 1;
+	}
+	for(int i = 0; i < 6; i++)
+		bits[4*i + 3] ^= (c >> i) & 1;
+	bits[127] ^= 1;
+}
+
+/*****************************************************************************
+* Checks the reduced-round GIFT-128 functions against 'classical_round' for
+* every first round and number of rounds, and that the GIFTb-128 ones split
+* the whole cipher at any round.
+*****************************************************************************/
+int check_rounds(const u8* k) {
+	static u8 states[41][NBLOCKS*BLOCK_SIZE];
+	u8 bits[128], output[NBLOCKS*BLOCK_SIZE], ref[NBLOCKS*BLOCK_SIZE];
+	const u32 len = NBLOCKS*BLOCK_SIZE;
+	gift128_bitsliced_ctx bs_ctx;
+	gift128_ctx ctx;
+	int ret = 0;
+	gift128_init(&ctx, k);
+	gift128_bitsliced_init(&bs_ctx, k);
+	for(u32 i = 0; i < len; i++)
+		states[0][i] = (u8)(i*3 + k[i % KEY_SIZE]);
+	for(u32 j = 0; j < len; j += BLOCK_SIZE) {
+		for(int i = 0; i < 128; i++)
+			bits[i] = (states[0][j + 15 - i/8] >> (i%8)) & 1;
+		for(int r = 0; r < 40; r++) {
+			classical_round(bits, bs_ctx.rkey, r);
+			for(int i = 0; i < 128; i++)
+				states[r+1][j + 15 - i/8] = (u8)((states[r+1][j + 15 - i/8] &
+					~(1 << (i%8))) | (bits[i] << (i%8)));
+		}
+	}
+	gift128_ecb_encrypt(&ctx, output, states[0], len);
+	ret |= memcmp(output, states[40], len);
+	for(u32 start = 0; start <= 40; start++) {
+		for(u32 n = 0; start + n <= 40; n++) {
+			gift128_encrypt_rounds(&ctx, output, states[start], len, start, n);
+			ret |= memcmp(output, states[start + n], len);
+			gift128_decrypt_rounds(&ctx, output, states[start + n], len,
+				start, n);
+			ret |= memcmp(output, states[start], len);
+		}
+	}
+	giftb128_ecb_encrypt(&ctx, ref, states[0], len);
+	for(u32 n = 0; n <= 40; n++) {
+		giftb128_encrypt_rounds(&ctx, output, states[0], len, 0, n);
+		giftb128_encrypt_rounds(&ctx, output, output, len, n, 40 - n);
+		ret |= memcmp(output, ref, len);
+		giftb128_decrypt_rounds(&ctx, output, output, len, n, 40 - n);
+		giftb128_decrypt_rounds(&ctx, output, output, len, 0, n);
+		ret |= memcmp(output, states[0], len);
+	}
+	ret |= (gift128_encrypt_rounds(&ctx, output, ref, len, 38, 3) != -1);
+	return ret ? -1 : 0;
+}
+
+extern const u32 rconst[40];
+void packing(u32* state, const u8* input);
+void unpacking(u8* output, u32* state);
+
+/*****************************************************************************
+* Checks the round functions of 'fixsliced.h' instantiated on GCC vectors of
+* N 32-bit words against the test vectors, the i-th lane holding the i-th
+* test vector modulo 3 along with its own round keys.
+*****************************************************************************/
+#define CHECK_WIDTH(name, N)									\
+int name(void) {												\
+	typedef u32 word __attribute__((vector_size(4*(N))));		\
+	word tmp, state[4], rkey[80];								\
+	u32 s[4], r[80];											\
+	u8 output[BLOCK_SIZE];										\
+	int ret = 0;												\
+	for(int l = 0; l < (N); l++) {								\
+		precompute_rkeys(r, key[l % 3]);						\
+		packing(s, ptext[l % 3]);								\
+		for(int i = 0; i < 80; i++)								\
+			rkey[i][l] = r[i];									\
+		for(int i = 0; i < 4; i++)								\
+			state[i][l] = s[i];									\
+	}															\
+	for(int i = 0; i < 40; i+=5)								\
+		QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);			\
+	for(int l = 0; l < (N); l++) {								\
+		for(int i = 0; i < 4; i++)								\
+			s[i] = state[i][l];									\
+		unpacking(output, s);									\
+		ret |= memcmp(output, ctext[l % 3], BLOCK_SIZE);		\
+	}															\
+	for(int i = 35; i >= 0; i-=5)								\
+		INV_QUINTUPLE_ROUND(state, rkey + i*2, rconst + i);		\
+	for(int l = 0; l < (N); l++) {								\
+		for(int i = 0; i < 4; i++)								\
+			s[i] = state[i][l];									\
+		unpacking(output, s);									\
+		ret |= memcmp(output, ptext[l % 3], BLOCK_SIZE);		\
+	}															\
+	return ret ? -1 : 0;										\
+}
+
+CHECK_WIDTH(check_width_x1, 1)
+CHECK_WIDTH(check_width_x2, 2)
+CHECK_WIDTH(check_width_x4, 4)
+CHECK_WIDTH(check_width_x8, 8)
+CHECK_WIDTH(check_width_x16, 16)
+
+/*****************************************************************************
+* Runs all the tests with the backend currently selected.
+*****************************************************************************/
+int run_tests(void) {
 	u8 output[BLOCK_SIZE];
+	u8 batch[NBLOCKS*BLOCK_SIZE];
+	gift128_ctx ctx;
 	for(int i = 0; i < 3; i++) {
+		gift128_init(&ctx, key[i]);
+		gift128_encrypt_block(&ctx, output, ptext[i]);
+		if(memcmp(output, ctext[i], BLOCK_SIZE) != 0) {
+			printf("Context-based encryption of test vector %d failed! :(\n",i);
+			return -1;
+		}
+		gift128_decrypt_block(&ctx, output, ctext[i]);
+		if(memcmp(output, ptext[i], BLOCK_SIZE) != 0) {
+			printf("Context-based decryption of test vector %d failed! :(\n",i);
+			return -1;
+		}
 		gift128_encrypt_ecb(output, ptext[i], BLOCK_SIZE, key[i]);
 		if(memcmp(output, ctext[i], BLOCK_SIZE) != 0) {
 			printf("Encryption of test vector %d failed! :(\n",i);
@@ -40,6 +592,85 @@ int main() {
 			printf("Decryption of test vector %d failed! :(\n",i);
 			return -1;
 		}
+		for(int j = 0; j < NBLOCKS; j++)
+			memcpy(batch + j*BLOCK_SIZE, ptext[i], BLOCK_SIZE);
+		gift128_encrypt_ecb(batch, batch, NBLOCKS*BLOCK_SIZE, key[i]);
+		for(int j = 0; j < NBLOCKS; j++) {
+			if(memcmp(batch + j*BLOCK_SIZE, ctext[i], BLOCK_SIZE) != 0) {
+				printf("Multi-block encryption of test vector %d failed! :(\n",i);
+				return -1;
+			}
+		}
+		if(check_multiblock(key[i]) != 0) {
+			printf("Multi-block ECB with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_otf(key[i]) != 0) {
+			printf("On-the-fly key schedule with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_ctr(key[i]) != 0) {
+			printf("CTR mode with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_stream(key[i]) != 0) {
+			printf("Incremental ECB/CTR with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_unaligned(key[i]) != 0) {
+			printf("Unaligned ECB with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_parallel(key[i]) != 0) {
+			printf("Multi-threaded ECB/CTR with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_bitsliced(key[i]) != 0) {
+			printf("Bitsliced ECB/CTR with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_rounds(key[i]) != 0) {
+			printf("Reduced-round encryption with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_keysearch(i) != 0) {
+			printf("Key search of key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_experiment(key[i]) != 0) {
+			printf("Differential/linear experiments with key %d failed! :(\n",
+				i);
+			return -1;
+		}
+	}
+	if(check_rkeys_xn() != 0) {
+		printf("Batched key schedule failed! :(\n");
+		return -1;
+	}
+	if(check_multikey() != 0) {
+		printf("Multi-key encryption failed! :(\n");
+		return -1;
+	}
+	return 0;
+}
+
+int main() {
+	const char* name;
+	if(check_width_x1() != 0 || check_width_x2() != 0 ||
+			check_width_x4() != 0 || check_width_x8() != 0 ||
+			check_width_x16() != 0) {
+		printf("Generic fixsliced rounds failed! :(\n");
+		return -1;
+	}
+	for(u32 i = 0; (name = gift128_backend_name(i)) != NULL; i++) {
+		if(gift128_select_backend(name) != 0) {
+			printf("Backend '%s' not supported, skipped.\n", name);
+			continue;
+		}
+		if(run_tests() != 0) {
+			printf("Backend '%s' failed! :(\n", name);
+			return -1;
+		}
 	}
 	printf("All tests have passed successfully! :)\n");
 	return 0;
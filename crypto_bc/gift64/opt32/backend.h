@@ -0,0 +1,59 @@
+#ifndef GIFT64_BACKEND_H_
+#define GIFT64_BACKEND_H_
+
+#include "encrypt.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GIFT64_AVX2
+#define GIFT64_AVX512
+#endif
+
+/****************************************************************************
+* Processes 'nblocks' consecutive 64-bit blocks with the fixsliced round keys
+* 'rkey'.
+****************************************************************************/
+typedef void (*bulk_fn)(u8* out, const u8* in, u32 nblocks, const u32* rkey);
+
+/****************************************************************************
+* Same as 'bulk_fn' for the rounds 'start' to 'end - 1' only (see
+* 'gift64_encrypt_rounds').
+****************************************************************************/
+typedef void (*rounds_fn)(u8* out, const u8* in, u32 nblocks, const u32* rkey,
+			u32 start, u32 end);
+
+/****************************************************************************
+* An implementation of GIFT-64 for the host processor. The bulk functions
+* accept any number of blocks, including incomplete batches.
+****************************************************************************/
+typedef struct {
+	const char* name;
+	int (*supported)(void);
+	bulk_fn gift64_encrypt;
+	bulk_fn gift64_decrypt;
+	rounds_fn gift64_encrypt_rounds;
+	rounds_fn gift64_decrypt_rounds;
+} backend_t;
+
+extern const backend_t backend_portable;
+extern void gift64_encrypt_rounds_portable(u8* out, const u8* in, u32 nblocks,
+			const u32* rkey, u32 start, u32 end);
+extern void gift64_decrypt_rounds_portable(u8* out, const u8* in, u32 nblocks,
+			const u32* rkey, u32 start, u32 end);
+#ifdef GIFT64_AVX2
+extern const backend_t backend_avx2;
+#endif
+#ifdef GIFT64_AVX512
+extern const backend_t backend_avx512;
+#endif
+
+extern const backend_t* backend;
+extern void select_backend(void);
+
+// returns the backend selected at load time (see 'dispatch.c')
+static inline const backend_t* get_backend(void) {
+	if(!backend)
+		select_backend();
+	return backend;
+}
+
+#endif  // GIFT64_BACKEND_H_
@@ -0,0 +1,84 @@
+/*******************************************************************************
+* Runtime selection of the GIFT-64 implementation.
+*
+* The fastest implementation supported by the processor (as reported by
+* CPUID) is selected when the library is loaded. The selection can be
+* overridden for benchmarking purposes by setting the 'GIFT_BACKEND'
+* environment variable to the name of a backend (e.g. 'portable', 'avx2' or
+* 'avx512'), or by calling 'gift64_select_backend'.
+*
+* A function-pointer table is used rather than GNU ifunc resolvers because
+* the latter run before the environment can safely be accessed.
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "backend.h"
+
+/****************************************************************************
+* Backends by decreasing order of preference.
+****************************************************************************/
+static const backend_t* const backends[] = {
+#ifdef GIFT64_AVX512
+	&backend_avx512,
+#endif
+#ifdef GIFT64_AVX2
+	&backend_avx2,
+#endif
+	&backend_portable
+};
+
+#define NB_BACKENDS		(sizeof(backends) / sizeof(backends[0]))
+
+const backend_t* backend = NULL;
+
+/****************************************************************************
+* Selects the backend named by the 'GIFT_BACKEND' environment variable if
+* supported, the fastest supported one otherwise.
+****************************************************************************/
+__attribute__((constructor))
+void select_backend(void) {
+	const char* name = getenv("GIFT_BACKEND");
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+#endif
+	if(name && gift64_select_backend(name) == 0)
+		return;
+	for(u32 i = 0; i < NB_BACKENDS; i++) {
+		if(backends[i]->supported()) {
+			backend = backends[i];
+			return;
+		}
+	}
+}
+
+/****************************************************************************
+* Selects the backend 'name'. Returns 0 on success, -1 if it is unknown or not
+* supported by the processor.
+****************************************************************************/
+int gift64_select_backend(const char* name) {
+	for(u32 i = 0; i < NB_BACKENDS; i++) {
+		if(strcmp(backends[i]->name, name) == 0 && backends[i]->supported()) {
+			backend = backends[i];
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/****************************************************************************
+* Returns the name of the i-th available backend (by decreasing order of
+* preference), or NULL if 'i' is out of range. Backends compiled in but not
+* supported by the processor are also listed.
+****************************************************************************/
+const char* gift64_backend_name(u32 i) {
+	if(i >= NB_BACKENDS)
+		return NULL;
+	return backends[i]->name;
+}
+
+/****************************************************************************
+* Returns the name of the backend currently in use.
+****************************************************************************/
+const char* gift64_current_backend(void) {
+	return get_backend()->name;
+}
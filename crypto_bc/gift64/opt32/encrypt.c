@@ -10,6 +10,7 @@
 *
 * @date		March 2020
 *******************************************************************************/
+#include "backend.h"
 #include "encrypt.h"
 #include "endian.h"
 #include "gift64.h"
@@ -33,38 +34,7 @@ const u32 rconst[28] = {
 ****************************************************************************/
 void rearrange_key(u32* rkey, const u8* key) {
 	u32 tmp;
-	// key words W6 and W7
-	rkey[0] = REARRANGE_KEYWORD_0_1(key[14], key[15]);
-	rkey[1] = REARRANGE_KEYWORD_0_1(key[12], key[13]);
-	TRANSPOSE_U32(rkey[0]);
-	TRANSPOSE_U32(rkey[1]);
-	rkey[0] |= 	(rkey[0] << 4); // each key word is interleaved with itself
-	rkey[1] |= 	(rkey[1] << 4);
-	rkey[0] ^= 0xffffffff; // to save 1 operation in sbox computations
-	// key words W4 and W5
-	rkey[2] = REARRANGE_KEYWORD_0_1(key[10], key[11]);
-	rkey[3] = REARRANGE_KEYWORD_0_1(key[8], key[9]);
-	rkey[2] |= (rkey[2] << 4);
-	rkey[3] |= (rkey[3] << 4);
-	rkey[2] ^= 0xffffffff;
-	SWAPMOVE(rkey[2], rkey[2], 0x22222222, 2);
-	SWAPMOVE(rkey[3], rkey[3], 0x22222222, 2);
-	// key words W2 and W3
-	rkey[4] = REARRANGE_KEYWORD_2_3(key[6], key[7]);
-	rkey[5] = REARRANGE_KEYWORD_2_3(key[4], key[5]);
-	TRANSPOSE_U32(rkey[4]);
-	TRANSPOSE_U32(rkey[5]);
-	SWAPMOVE(rkey[4], rkey[4], 0x00000f00, 16);
-	SWAPMOVE(rkey[5], rkey[5], 0x00000f00, 16);
-	rkey[4] |= (rkey[4] << 4);
-	rkey[5] |= (rkey[5] << 4);
-	rkey[4] ^= 0xffffffff;
-	// key words W0 and W1
-	rkey[6] = REARRANGE_KEYWORD_2_3(key[2], key[3]);
-	rkey[7] = REARRANGE_KEYWORD_2_3(key[0], key[1]);
-	rkey[6] |= (rkey[6] << 4);
-	rkey[7] |= (rkey[7] << 4);
-	rkey[6] ^= 0xffffffff;
+	REARRANGE_KEY(rkey, key);
 }
 
 /****************************************************************************
@@ -122,35 +92,15 @@ void rearrange_2_keys(u32* rkey, const u8* key0, const u8* key1) {
 ****************************************************************************/
 void key_update(u32* next_rkey, const u32* prev_rkey) {
 	u32 tmp;
-	// 1st round key
-	next_rkey[0] = NIBBLE_ROR_1(prev_rkey[0]);
-	next_rkey[1] = NIBBLE_ROR_3(prev_rkey[1]) & 0x0000ffff;
-	next_rkey[1] |= prev_rkey[1] & 0xffff0000;
-	next_rkey[1] = ROR(next_rkey[1], 16);
-	// 2nd round key
-	next_rkey[2] = ROR(prev_rkey[2], 8);
-	tmp = NIBBLE_ROR_2(prev_rkey[3]);
-	next_rkey[3] = tmp & 0x99999999;
-	next_rkey[3] |= ROR(tmp & 0x66666666, 24);
-	// 3rd round key
-	next_rkey[4] = NIBBLE_ROR_3(prev_rkey[4]);
-	tmp = ROR(prev_rkey[5], 16);
-	next_rkey[5] = NIBBLE_ROR_1(tmp) & 0x00ffff00;
-	next_rkey[5] |= tmp & 0xff0000ff;
-	// 4th round key
-	next_rkey[6] = ROR(prev_rkey[6], 24);
-	tmp = NIBBLE_ROR_2(prev_rkey[7]);
-	next_rkey[7] = tmp & 0x33333333;
-	next_rkey[7] |= ROR(tmp & 0xcccccccc, 8);
+	KEY_UPDATE(next_rkey, prev_rkey);
 }
 
 /****************************************************************************
 * Precomputes all round keys for a given encryption key.
 ****************************************************************************/
 void precompute_rkeys(u32* rkey, const u8* key) {
-	rearrange_key(rkey, key);
-	for(int i = 0; i < 48; i += 8)
-		key_update(rkey + i + 8, rkey + i);
+	u32 tmp;
+	KEY_SCHEDULE(rkey, key);
 }
 
 /****************************************************************************
@@ -171,10 +121,10 @@ void precompute_2_rkeys(u32* rkey, const u8* key0, const u8* key1) {
 ****************************************************************************/
 void packing(u32* state, const u8* block0, const u8* block1) {
 	u32 tmp;
-	state[0] = U32BIG(*(u32*)(block0 + 4));
-	state[1] = U32BIG(*(u32*)(block1 + 4));
-	state[2] = U32BIG(*(u32*)block0);
-	state[3] = U32BIG(*(u32*)block1);
+	state[0] = LOAD32_BE(block0 + 4);
+	state[1] = LOAD32_BE(block1 + 4);
+	state[2] = LOAD32_BE(block0);
+	state[3] = LOAD32_BE(block1);
     SWAPMOVE(state[0], state[0], 0x0a0a0a0a, 3);
     SWAPMOVE(state[0], state[0], 0x00cc00cc, 6);
     SWAPMOVE(state[0], state[0], 0x0000ff00, 8);
@@ -227,10 +177,10 @@ void unpacking(u8* block0, u8* block1, u32* state) {
 ****************************************************************************/
 void packing_interleave(u32* state, const u8* block0, const u8* block1) {
 	u32 tmp;
-	state[0] = U32BIG(*(u32*)(block0 + 4));
-	state[1] = U32BIG(*(u32*)(block1 + 4));
-	state[2] = U32BIG(*(u32*)block0);
-	state[3] = U32BIG(*(u32*)block1);
+	state[0] = LOAD32_BE(block0 + 4);
+	state[1] = LOAD32_BE(block1 + 4);
+	state[2] = LOAD32_BE(block0);
+	state[3] = LOAD32_BE(block1);
 	SWAPMOVE(state[0], state[1], 0x00000f0f, 4);
 	SWAPMOVE(state[2], state[3], 0x00000f0f, 4);
 	SWAPMOVE(state[0], state[1], 0x0000ffff, 16);
@@ -261,59 +211,153 @@ void unpacking_interleave(u8* block0, u8* block1, u32* state) {
 }
 
 /****************************************************************************
-* Encryption of 64-bit blocks. Note that 'ptext_len' must be a mutliple of 8.
+* Encryption of 'nblocks' consecutive 64-bit blocks, 2 at a time.
 ****************************************************************************/
-int gift64_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key) {
-	u32 state[4], rkey[56];
-	precompute_rkeys(rkey, key);
-	while(ptext_len > BLOCK_SIZE) {		// Processing 2 blocks at once
+static void gift64_encrypt_portable(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey) {
+	u32 state[4];
+	while(nblocks > 1) {				// Processing 2 blocks at once
 		packing(state, ptext, ptext + BLOCK_SIZE);
 		for(int i = 0; i < 28; i += 4)
 			QUADRUPLE_ROUND(state, rkey + i * 2, rconst + i);
 		unpacking(ctext, ctext + BLOCK_SIZE, state);
 		ptext += BLOCK_SIZE * 2;
 		ctext += BLOCK_SIZE * 2;
-		ptext_len -= BLOCK_SIZE * 2;
+		nblocks -= 2;
 	}
-	while(ptext_len > 0) {				// Processing a single block
+	if(nblocks > 0) {					// Processing a single block
 		packing(state, ptext, ptext);
-		for(int i = 0; i < 28; i += 4) 
+		for(int i = 0; i < 28; i += 4)
 			QUADRUPLE_ROUND(state, rkey + i * 2, rconst + i);
 		unpacking(ctext, ctext, state);
-		ptext += BLOCK_SIZE;
-		ctext += BLOCK_SIZE;
-		ptext_len -= BLOCK_SIZE;
 	}
-	return 0;
 }
 
 /****************************************************************************
-* Decryption of 64-bit blocks. Note that 'ctext_len' must be a mutliple of 8.
+* Decryption of 'nblocks' consecutive 64-bit blocks, 2 at a time.
 ****************************************************************************/
-int gift64_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key) {
-	u32 state[4], rkey[56];
-	precompute_rkeys(rkey, key);
-	while(ctext_len > BLOCK_SIZE) {		// Processing 2 blocks at a time
+static void gift64_decrypt_portable(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey) {
+	u32 state[4];
+	while(nblocks > 1) {				// Processing 2 blocks at a time
 		packing(state, ctext, ctext + BLOCK_SIZE);
 		for(int i = 24; i >= 0; i -= 4)
 			INV_QUADRUPLE_ROUND(state, rkey + i*2, rconst + i);
 		unpacking(ptext, ptext + BLOCK_SIZE, state);
 		ptext += BLOCK_SIZE * 2;
 		ctext += BLOCK_SIZE * 2;
-		ctext_len -= BLOCK_SIZE * 2;
+		nblocks -= 2;
 	}
-	while(ctext_len > 0) {			// Processing a single block
+	if(nblocks > 0) {					// Processing a single block
 		packing(state, ctext, ctext);
 		for(int i = 24; i >= 0; i -= 4)
 			INV_QUADRUPLE_ROUND(state, rkey + i*2, rconst + i);
 		unpacking(ptext, ptext, state);
-		ptext += BLOCK_SIZE;
-		ctext += BLOCK_SIZE;
-		ctext_len -= BLOCK_SIZE;
 	}
+}
+
+/****************************************************************************
+* Reduced-round functions of the portable backend (see 'ROUNDS_W' in
+* 'fixsliced.h'), 2 blocks at a time as above.
+****************************************************************************/
+#define PORTABLE_ROUNDS(name, rounds)							\
+void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+			u32 start, u32 end) {								\
+	u32 tmp, state[4];											\
+	while(nblocks > 1) {										\
+		packing(state, in, in + BLOCK_SIZE);					\
+		rounds(state, rkey, rconst, start, end);				\
+		unpacking(out, out + BLOCK_SIZE, state);				\
+		in += BLOCK_SIZE * 2;									\
+		out += BLOCK_SIZE * 2;									\
+		nblocks -= 2;											\
+	}															\
+	if(nblocks > 0) {											\
+		packing(state, in, in);									\
+		rounds(state, rkey, rconst, start, end);				\
+		unpacking(out, out, state);								\
+	}															\
+}
+
+PORTABLE_ROUNDS(gift64_encrypt_rounds_portable, ROUNDS)
+PORTABLE_ROUNDS(gift64_decrypt_rounds_portable, INV_ROUNDS)
+
+static int portable_supported(void) {
+	return 1;
+}
+
+const backend_t backend_portable = {
+	"portable",
+	portable_supported,
+	gift64_encrypt_portable,
+	gift64_decrypt_portable,
+	gift64_encrypt_rounds_portable,
+	gift64_decrypt_rounds_portable
+};
+
+/****************************************************************************
+* Encryption of 64-bit blocks with the round keys computed by
+* 'precompute_rkeys'. Note that 'ptext_len' must be a mutliple of 8.
+****************************************************************************/
+int gift64_encrypt_ecb_rkey(u8* ctext, const u8* ptext, u32 ptext_len,
+				const u32* rkey) {
+	get_backend()->gift64_encrypt(ctext, ptext, ptext_len / BLOCK_SIZE, rkey);
+	return 0;
+}
+
+/****************************************************************************
+* Decryption of 64-bit blocks with the round keys computed by
+* 'precompute_rkeys'. Note that 'ctext_len' must be a mutliple of 8.
+****************************************************************************/
+int gift64_decrypt_ecb_rkey(u8* ptext, const u8* ctext, u32 ctext_len,
+				const u32* rkey) {
+	get_backend()->gift64_decrypt(ptext, ctext, ctext_len / BLOCK_SIZE, rkey);
+	return 0;
+}
+
+/****************************************************************************
+* Rounds 'start' to 'start + nrounds - 1' of GIFT-64 with the round keys
+* computed by 'precompute_rkeys'. Note that 'len' must be a multiple of 8.
+****************************************************************************/
+int gift64_encrypt_rounds(u8* out, const u8* in, u32 len, const u32* rkey,
+				u32 start, u32 nrounds) {
+	if(start > 28 || nrounds > 28 - start)
+		return -1;
+	get_backend()->gift64_encrypt_rounds(out, in, len / BLOCK_SIZE, rkey,
+		start, start + nrounds);
+	return 0;
+}
+
+/****************************************************************************
+* Inverse of 'gift64_encrypt_rounds' with the same 'start' and 'nrounds'.
+****************************************************************************/
+int gift64_decrypt_rounds(u8* out, const u8* in, u32 len, const u32* rkey,
+				u32 start, u32 nrounds) {
+	if(start > 28 || nrounds > 28 - start)
+		return -1;
+	get_backend()->gift64_decrypt_rounds(out, in, len / BLOCK_SIZE, rkey,
+		start, start + nrounds);
 	return 0;
 }
 
+/****************************************************************************
+* Encryption of 64-bit blocks. Note that 'ptext_len' must be a mutliple of 8.
+****************************************************************************/
+int gift64_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key) {
+	u32 rkey[56];
+	precompute_rkeys(rkey, key);
+	return gift64_encrypt_ecb_rkey(ctext, ptext, ptext_len, rkey);
+}
+
+/****************************************************************************
+* Decryption of 64-bit blocks. Note that 'ctext_len' must be a mutliple of 8.
+****************************************************************************/
+int gift64_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key) {
+	u32 rkey[56];
+	precompute_rkeys(rkey, key);
+	return gift64_decrypt_ecb_rkey(ptext, ctext, ctext_len, rkey);
+}
+
 /****************************************************************************
 * Encryption of 64-bit blocks. Note that:
 * - 'ptext_len' must be a mutliple of 8
@@ -1,13 +1,80 @@
-#ifndef ENCRYPT_H_
-#define ENCRYPT_H_
+#ifndef GIFT64_ENCRYPT_H_
+#define GIFT64_ENCRYPT_H_
 
 #define BLOCK_SIZE	8
 #define KEY_SIZE	16
 
 typedef unsigned char u8;
 typedef unsigned int u32;
+typedef unsigned long long u64;
 
 int gift64_encrypt_ecb(u8* ctext, const u8* ptext, u32 ptext_len, const u8* key);
 int gift64_decrypt_ecb(u8* ptext, const u8* ctext, u32 ctext_len, const u8* key);
 
-#endif  // ENCRYPT_H_
\ No newline at end of file
+/****************************************************************************
+* Same with the 56 fixsliced round keys computed by 'precompute_rkeys', or at
+* compile time by 'gift::gift64_rkeys' (see 'gift64.hpp').
+****************************************************************************/
+void precompute_rkeys(u32* rkey, const u8* key);
+void precompute_2_rkeys(u32* rkey, const u8* key0, const u8* key1);
+int gift64_encrypt_ecb_rkey(u8* ctext, const u8* ptext, u32 ptext_len,
+			const u32* rkey);
+int gift64_decrypt_ecb_rkey(u8* ptext, const u8* ctext, u32 ctext_len,
+			const u32* rkey);
+
+/****************************************************************************
+* Reduced-round GIFT-64 for cryptanalysis: only the rounds 'start' to
+* 'start + nrounds - 1' (numbered from 0) are applied to each block, which is
+* given and returned in the same byte order as plaintexts and ciphertexts.
+* Any 'start' and 'nrounds' are supported by every backend, not only whole
+* quadruples of rounds. Returns -1 if 'start + nrounds' exceeds 28.
+****************************************************************************/
+int gift64_encrypt_rounds(u8* out, const u8* in, u32 len, const u32* rkey,
+			u32 start, u32 nrounds);
+int gift64_decrypt_rounds(u8* out, const u8* in, u32 len, const u32* rkey,
+			u32 start, u32 nrounds);
+
+/****************************************************************************
+* Exhaustive key search from a known plaintext/ciphertext pair over the keys
+* equal to 'key' on the bits cleared in 'mask' (see 'keysearch.c'). The bits
+* set in 'mask', at most 64, are enumerated 2 keys at a time on all the
+* threads.
+****************************************************************************/
+typedef struct {
+	u8 key[KEY_SIZE];
+	u8 mask[KEY_SIZE];
+	u8 ptext[BLOCK_SIZE];
+	u8 ctext[BLOCK_SIZE];
+} gift64_keysearch;
+
+int gift64_key_search(const gift64_keysearch* ks, u32 nthreads, u8* key,
+			u64* ntested);
+
+/****************************************************************************
+* Differential and linear experiments on the rounds 'start' to
+* 'start + nrounds - 1' of GIFT-64 (see 'experiment.c'), over 2^log_n random
+* plaintext pairs or plaintexts generated from 'seed'. 'in' is the input
+* difference or mask and 'out' the output bits to histogram (at most
+* GIFT64_HIST_MAX_BITS) or the output mask.
+****************************************************************************/
+#define GIFT64_HIST_MAX_BITS	20
+
+typedef struct {
+	u32 start;
+	u32 nrounds;
+	u32 log_n;
+	u64 seed;
+	u8 in[BLOCK_SIZE];
+	u8 out[BLOCK_SIZE];
+} gift64_experiment;
+
+int gift64_differential(const u32* rkey, const gift64_experiment* exp,
+			u32 nthreads, u64* hist);
+int gift64_linear(const u32* rkey, const gift64_experiment* exp,
+			u32 nthreads, u64* count);
+
+int gift64_select_backend(const char* name);
+const char* gift64_backend_name(u32 i);
+const char* gift64_current_backend(void);
+
+#endif  // GIFT64_ENCRYPT_H_
\ No newline at end of file
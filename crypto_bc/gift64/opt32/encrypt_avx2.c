@@ -0,0 +1,175 @@
+/*******************************************************************************
+* Constant-time AVX2 implementation of the GIFT-64 block cipher processing 16
+* blocks in parallel.
+*
+* Each 32-bit lane of the 4 '__m256i' words holds the fixsliced state of a
+* different pair of blocks so that the round function is exactly the same as
+* in 'encrypt.c', only applied on 8 pairs of blocks at once.
+*
+* See "Fixslicing: A New GIFT Representation" paper available at
+* https://eprint.iacr.org/2020/412.pdf for more details on the fixsliced
+* representation.
+*******************************************************************************/
+#include "gift64_avx2.h"
+
+#ifdef GIFT64_AVX2
+
+extern const u32 rconst[28];
+
+/*****************************************************************************
+* Transposes the 32-bit words within each 128-bit lane of 'r0', ..., 'r3' so
+* that the i-th output word gathers the i-th word of every input. The
+* transposition is an involution and is used for both packing and unpacking.
+*****************************************************************************/
+TARGET_AVX2
+static inline void transpose_x8(__m256i* s, __m256i r0, __m256i r1,
+				__m256i r2, __m256i r3) {
+	__m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+	__m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+	__m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+	__m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+	s[0] = _mm256_unpacklo_epi64(t0, t2);
+	s[1] = _mm256_unpackhi_epi64(t0, t2);
+	s[2] = _mm256_unpacklo_epi64(t1, t3);
+	s[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+/*****************************************************************************
+* Fills the internal state with 16 input blocks. Every 128-bit lane holds 2
+* consecutive blocks whose big-endian words are transposed so that state[i]
+* holds the i-th word of the scalar 'packing' for 8 pairs of blocks.
+*****************************************************************************/
+TARGET_AVX2
+static inline void packing_x16(__m256i* state, const u8* input) {
+	__m256i tmp, r[4], w[4];
+	for(int i = 0; i < 4; i++) {
+		r[i] = _mm256_loadu_si256((const __m256i*)(input + 32*i));
+		r[i] = BYTE_SHUFFLE_X8(r[i], 3, 2, 1, 0);
+	}
+	transpose_x8(w, r[0], r[1], r[2], r[3]);
+	state[0] = w[1];
+	state[1] = w[3];
+	state[2] = w[0];
+	state[3] = w[2];
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_X8(state[i], state[i], 0x0a0a0a0a, 3);
+		SWAPMOVE_X8(state[i], state[i], 0x00cc00cc, 6);
+		state[i] = BYTE_SHUFFLE_X8(state[i], 0, 2, 1, 3);
+	}
+	SWAPMOVE_X8(state[0], state[1], 0x0f0f0f0f, 4);
+	SWAPMOVE_X8(state[2], state[3], 0x0f0f0f0f, 4);
+	SWAPMOVE_X8(state[0], state[2], 0x0000ffff, 16);
+	SWAPMOVE_X8(state[1], state[3], 0x0000ffff, 16);
+}
+
+/*****************************************************************************
+* Fills the output from the internal state of 16 blocks.
+*****************************************************************************/
+TARGET_AVX2
+static inline void unpacking_x16(u8* output, __m256i* state) {
+	__m256i tmp, r[4];
+	SWAPMOVE_X8(state[0], state[2], 0x0000ffff, 16);
+	SWAPMOVE_X8(state[1], state[3], 0x0000ffff, 16);
+	SWAPMOVE_X8(state[0], state[1], 0x0f0f0f0f, 4);
+	SWAPMOVE_X8(state[2], state[3], 0x0f0f0f0f, 4);
+	for(int i = 0; i < 4; i++) {
+		state[i] = BYTE_SHUFFLE_X8(state[i], 0, 2, 1, 3);
+		SWAPMOVE_X8(state[i], state[i], 0x00cc00cc, 6);
+		SWAPMOVE_X8(state[i], state[i], 0x0a0a0a0a, 3);
+	}
+	transpose_x8(r, state[2], state[0], state[3], state[1]);
+	for(int i = 0; i < 4; i++) {
+		r[i] = BYTE_SHUFFLE_X8(r[i], 3, 2, 1, 0);
+		_mm256_storeu_si256((__m256i*)(output + 32*i), r[i]);
+	}
+}
+
+/*****************************************************************************
+* Encryption of 16 consecutive 64-bit blocks with GIFT-64.
+*****************************************************************************/
+TARGET_AVX2
+void gift64_encrypt_x16(u8* ctext, const u8* ptext, const u32* rkey) {
+	__m256i state[4];
+	packing_x16(state, ptext);
+	for(int i = 0; i < 28; i += 4)
+		QUADRUPLE_ROUND_X8(state, rkey + i*2, rconst + i);
+	unpacking_x16(ctext, state);
+}
+
+/*****************************************************************************
+* Decryption of 16 consecutive 64-bit blocks with GIFT-64.
+*****************************************************************************/
+TARGET_AVX2
+void gift64_decrypt_x16(u8* ptext, const u8* ctext, const u32* rkey) {
+	__m256i state[4];
+	packing_x16(state, ctext);
+	for(int i = 24; i >= 0; i -= 4)
+		INV_QUADRUPLE_ROUND_X8(state, rkey + i*2, rconst + i);
+	unpacking_x16(ptext, state);
+}
+
+/*****************************************************************************
+* Rounds 'start' to 'end - 1' only of GIFT-64 on 16 consecutive blocks (see
+* 'ROUNDS_W' in 'fixsliced.h').
+*****************************************************************************/
+#define AVX2_ROUNDS_KERNEL(name, rounds)						\
+TARGET_AVX2														\
+static void name(u8* out, const u8* in, const u32* rkey, u32 start,	\
+				u32 end) {										\
+	__m256i tmp, state[4];										\
+	packing_x16(state, in);										\
+	rounds(state, rkey, rconst, start, end);					\
+	unpacking_x16(out, state);									\
+}
+
+AVX2_ROUNDS_KERNEL(gift64_encrypt_rounds_x16, ROUNDS_X8)
+AVX2_ROUNDS_KERNEL(gift64_decrypt_rounds_x16, INV_ROUNDS_X8)
+
+/*****************************************************************************
+* Bulk functions of the AVX2 backend: batches of 16 blocks go through the
+* kernels above while the remaining blocks are processed by the portable
+* implementation.
+*****************************************************************************/
+#define AVX2_BULK(name, kernel, tail)							\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	for(; nblocks >= 16; nblocks -= 16) {						\
+		kernel(out, in, rkey);									\
+		in += 16*BLOCK_SIZE;									\
+		out += 16*BLOCK_SIZE;									\
+	}															\
+	backend_portable.tail(out, in, nblocks, rkey);				\
+}
+
+AVX2_BULK(gift64_encrypt_avx2, gift64_encrypt_x16, gift64_encrypt)
+AVX2_BULK(gift64_decrypt_avx2, gift64_decrypt_x16, gift64_decrypt)
+
+#define AVX2_ROUNDS_BULK(name, kernel, tail)					\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+				u32 start, u32 end) {							\
+	for(; nblocks >= 16; nblocks -= 16) {						\
+		kernel(out, in, rkey, start, end);						\
+		in += 16*BLOCK_SIZE;									\
+		out += 16*BLOCK_SIZE;									\
+	}															\
+	backend_portable.tail(out, in, nblocks, rkey, start, end);	\
+}
+
+AVX2_ROUNDS_BULK(gift64_encrypt_rounds_avx2, gift64_encrypt_rounds_x16,
+	gift64_encrypt_rounds)
+AVX2_ROUNDS_BULK(gift64_decrypt_rounds_avx2, gift64_decrypt_rounds_x16,
+	gift64_decrypt_rounds)
+
+static int avx2_supported(void) {
+	return __builtin_cpu_supports("avx2");
+}
+
+const backend_t backend_avx2 = {
+	"avx2",
+	avx2_supported,
+	gift64_encrypt_avx2,
+	gift64_decrypt_avx2,
+	gift64_encrypt_rounds_avx2,
+	gift64_decrypt_rounds_avx2
+};
+
+#endif  // GIFT64_AVX2
@@ -0,0 +1,205 @@
+/*******************************************************************************
+* Constant-time AVX-512 implementation of the GIFT-64 block cipher processing
+* up to 32 blocks in parallel.
+*
+* Each 32-bit lane of the 4 '__m512i' words holds the fixsliced state of a
+* different pair of blocks. Only AVX-512F instructions are used: byte
+* shuffles are replaced by rotations and 'vpternlogd' merges. Batches of less
+* than 32 blocks are handled with masked loads/stores.
+*
+* See "Fixslicing: A New GIFT Representation" paper available at
+* https://eprint.iacr.org/2020/412.pdf for more details on the fixsliced
+* representation.
+*******************************************************************************/
+#include "gift64_avx512.h"
+
+#ifdef GIFT64_AVX512
+
+extern const u32 rconst[28];
+
+/*****************************************************************************
+* Transposes the 32-bit words within each 128-bit lane of 'r0', ..., 'r3' so
+* that the i-th output word gathers the i-th word of every input. The
+* transposition is an involution and is used for both packing and unpacking.
+*****************************************************************************/
+TARGET_AVX512
+static inline void transpose_x16(__m512i* s, __m512i r0, __m512i r1,
+				__m512i r2, __m512i r3) {
+	__m512i t0 = _mm512_unpacklo_epi32(r0, r1);
+	__m512i t1 = _mm512_unpackhi_epi32(r0, r1);
+	__m512i t2 = _mm512_unpacklo_epi32(r2, r3);
+	__m512i t3 = _mm512_unpackhi_epi32(r2, r3);
+	s[0] = _mm512_unpacklo_epi64(t0, t2);
+	s[1] = _mm512_unpackhi_epi64(t0, t2);
+	s[2] = _mm512_unpacklo_epi64(t1, t3);
+	s[3] = _mm512_unpackhi_epi64(t1, t3);
+}
+
+/*****************************************************************************
+* Byte swap of each 32-bit lane.
+*****************************************************************************/
+TARGET_AVX512
+static inline __m512i bswap_x16(__m512i x) {
+	return SELECT_X16(SET1_X16(0xff00ff00), ROR_X16(x, 8), ROR_X16(x, 24));
+}
+
+/*****************************************************************************
+* Swaps the 2 middle bytes of each 32-bit lane.
+*****************************************************************************/
+TARGET_AVX512
+static inline __m512i swap_middle_bytes_x16(__m512i x) {
+	__m512i y = SELECT_X16(SET1_X16(0x0000ff00), ROR_X16(x, 8), ROR_X16(x, 24));
+	return SELECT_X16(SET1_X16(0xff0000ff), x, y);
+}
+
+/*****************************************************************************
+* Returns the mask of the 32-bit lanes of the i-th 64-byte chunk that belong
+* to one of the 'nblocks' blocks to process.
+*****************************************************************************/
+static inline __mmask16 chunk_mask(u32 nblocks, int i) {
+	if(nblocks >= (u32)(8*i + 8))
+		return 0xffff;
+	if(nblocks <= (u32)(8*i))
+		return 0;
+	return (__mmask16)((1u << (2*(nblocks - 8*i))) - 1);
+}
+
+/*****************************************************************************
+* Fills the internal state with up to 32 input blocks. Every 128-bit lane
+* holds 2 consecutive blocks whose big-endian words are transposed so that
+* state[i] holds the i-th word of the scalar 'packing' for 16 pairs of blocks.
+*****************************************************************************/
+TARGET_AVX512
+static inline void packing_x32(__m512i* state, const u8* input, u32 nblocks) {
+	__m512i tmp, r[4], w[4];
+	for(int i = 0; i < 4; i++) {
+		r[i] = _mm512_maskz_loadu_epi32(chunk_mask(nblocks, i), input + 64*i);
+		r[i] = bswap_x16(r[i]);
+	}
+	transpose_x16(w, r[0], r[1], r[2], r[3]);
+	state[0] = w[1];
+	state[1] = w[3];
+	state[2] = w[0];
+	state[3] = w[2];
+	for(int i = 0; i < 4; i++) {
+		SWAPMOVE_1_X16(state[i], 0x0a0a0a0a, 3);
+		SWAPMOVE_1_X16(state[i], 0x00cc00cc, 6);
+		state[i] = swap_middle_bytes_x16(state[i]);
+	}
+	SWAPMOVE_X16(state[0], state[1], 0x0f0f0f0f, 4);
+	SWAPMOVE_X16(state[2], state[3], 0x0f0f0f0f, 4);
+	SWAPMOVE_X16(state[0], state[2], 0x0000ffff, 16);
+	SWAPMOVE_X16(state[1], state[3], 0x0000ffff, 16);
+}
+
+/*****************************************************************************
+* Fills the output from the internal state of up to 32 blocks.
+*****************************************************************************/
+TARGET_AVX512
+static inline void unpacking_x32(u8* output, __m512i* state, u32 nblocks) {
+	__m512i tmp, r[4];
+	SWAPMOVE_X16(state[0], state[2], 0x0000ffff, 16);
+	SWAPMOVE_X16(state[1], state[3], 0x0000ffff, 16);
+	SWAPMOVE_X16(state[0], state[1], 0x0f0f0f0f, 4);
+	SWAPMOVE_X16(state[2], state[3], 0x0f0f0f0f, 4);
+	for(int i = 0; i < 4; i++) {
+		state[i] = swap_middle_bytes_x16(state[i]);
+		SWAPMOVE_1_X16(state[i], 0x00cc00cc, 6);
+		SWAPMOVE_1_X16(state[i], 0x0a0a0a0a, 3);
+	}
+	transpose_x16(r, state[2], state[0], state[3], state[1]);
+	for(int i = 0; i < 4; i++)
+		_mm512_mask_storeu_epi32(output + 64*i, chunk_mask(nblocks, i),
+			bswap_x16(r[i]));
+}
+
+/*****************************************************************************
+* Encryption of 'nblocks' (at most 32) consecutive 64-bit blocks with GIFT-64.
+*****************************************************************************/
+TARGET_AVX512
+void gift64_encrypt_x32(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey) {
+	__m512i state[4];
+	packing_x32(state, ptext, nblocks);
+	for(int i = 0; i < 28; i += 4)
+		QUADRUPLE_ROUND_X16(state, rkey + i*2, rconst + i);
+	unpacking_x32(ctext, state, nblocks);
+}
+
+/*****************************************************************************
+* Decryption of 'nblocks' (at most 32) consecutive 64-bit blocks with GIFT-64.
+*****************************************************************************/
+TARGET_AVX512
+void gift64_decrypt_x32(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey) {
+	__m512i state[4];
+	packing_x32(state, ctext, nblocks);
+	for(int i = 24; i >= 0; i -= 4)
+		INV_QUADRUPLE_ROUND_X16(state, rkey + i*2, rconst + i);
+	unpacking_x32(ptext, state, nblocks);
+}
+
+/*****************************************************************************
+* Rounds 'start' to 'end - 1' only of GIFT-64 on 'nblocks' (at most 32)
+* consecutive blocks (see 'ROUNDS_W' in 'fixsliced.h').
+*****************************************************************************/
+#define AVX512_ROUNDS_KERNEL(name, rounds)						\
+TARGET_AVX512													\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+				u32 start, u32 end) {							\
+	__m512i tmp, state[4];										\
+	packing_x32(state, in, nblocks);							\
+	rounds(state, rkey, rconst, start, end);					\
+	unpacking_x32(out, state, nblocks);							\
+}
+
+AVX512_ROUNDS_KERNEL(gift64_encrypt_rounds_x32, ROUNDS_X16)
+AVX512_ROUNDS_KERNEL(gift64_decrypt_rounds_x32, INV_ROUNDS_X16)
+
+/*****************************************************************************
+* Bulk functions of the AVX-512 backend: the last batch of less than 32 blocks
+* is processed by the same kernels thanks to masked loads/stores.
+*****************************************************************************/
+#define AVX512_BULK(name, kernel)								\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey) {	\
+	while(nblocks > 0) {										\
+		u32 n = (nblocks >= 32) ? 32 : nblocks;					\
+		kernel(out, in, n, rkey);								\
+		in += n*BLOCK_SIZE;										\
+		out += n*BLOCK_SIZE;									\
+		nblocks -= n;											\
+	}															\
+}
+
+AVX512_BULK(gift64_encrypt_avx512, gift64_encrypt_x32)
+AVX512_BULK(gift64_decrypt_avx512, gift64_decrypt_x32)
+
+#define AVX512_ROUNDS_BULK(name, kernel)						\
+static void name(u8* out, const u8* in, u32 nblocks, const u32* rkey,	\
+				u32 start, u32 end) {							\
+	while(nblocks > 0) {										\
+		u32 n = (nblocks >= 32) ? 32 : nblocks;					\
+		kernel(out, in, n, rkey, start, end);					\
+		in += n*BLOCK_SIZE;										\
+		out += n*BLOCK_SIZE;									\
+		nblocks -= n;											\
+	}															\
+}
+
+AVX512_ROUNDS_BULK(gift64_encrypt_rounds_avx512, gift64_encrypt_rounds_x32)
+AVX512_ROUNDS_BULK(gift64_decrypt_rounds_avx512, gift64_decrypt_rounds_x32)
+
+static int avx512_supported(void) {
+	return __builtin_cpu_supports("avx512f");
+}
+
+const backend_t backend_avx512 = {
+	"avx512",
+	avx512_supported,
+	gift64_encrypt_avx512,
+	gift64_decrypt_avx512,
+	gift64_encrypt_rounds_avx512,
+	gift64_decrypt_rounds_avx512
+};
+
+#endif  // GIFT64_AVX512
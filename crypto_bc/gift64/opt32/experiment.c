@@ -0,0 +1,246 @@
+/*******************************************************************************
+* Multi-threaded differential and linear experiments on reduced GIFT-64.
+*
+* The random plaintexts are split into chunks, each thread grabbing the next
+* unprocessed chunk until none is left. The plaintexts of a chunk are
+* encrypted by batches through 'gift64_encrypt_rounds', hence through the
+* round functions and the SIMD kernels of the selected backend, and are
+* reduced on the fly into counters local to the thread, which are added to
+* the result once all chunks are processed: the memory used does not depend
+* on the number of plaintexts.
+*
+* The plaintexts only depend on the seed of the experiment, the i-th one
+* being the 'splitmix64' output of 'seed + (i + 1)*GOLDEN' in little-endian
+* byte order, so that results are reproducible whatever the number of threads
+* and the platform.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "encrypt.h"
+
+#define CACHE_LINE			64
+#define CHUNK_LOG			12		// log2 of the plaintexts of a chunk
+#define BATCH				128		// blocks encrypted at once
+#define GOLDEN				0x9e3779b97f4a7c15ULL
+
+typedef struct {
+	const u32* rkey;
+	const gift64_experiment* exp;
+	int linear;
+	u32 hist_bits;
+	u32 nbytes;				// output bytes with histogrammed bits
+	u8 bytes[BLOCK_SIZE];
+	u32 index[BLOCK_SIZE][256];	// histogram index bits of each output byte
+	u64 chunk_len;
+	u64 nchunks;
+	pthread_mutex_t lock;
+	u64* hist;
+	u64 count;
+	int failed;
+	// written by all threads, hence kept away from the read-only fields
+	u64 next_chunk __attribute__((aligned(CACHE_LINE)));
+} experiment_t;
+
+static u64 splitmix64(u64 x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+/*****************************************************************************
+* Writes the 'n' plaintexts of indexes 'first' to 'first + n - 1' to 'out'.
+*****************************************************************************/
+static void plaintexts(u8* out, u64 seed, u64 first, u32 n) {
+	for(u32 i = 0; i < n; i++) {
+		u64 w = splitmix64(seed + (first + i + 1)*GOLDEN);
+		for(int j = 0; j < BLOCK_SIZE; j++)
+			out[i*BLOCK_SIZE + j] = (u8)(w >> 8*j);
+	}
+}
+
+// parity of the bits of 'x' selected by 'mask'
+static int masked_parity(const u8* x, const u8* mask) {
+	u64 x0, m0;
+	memcpy(&x0, x, BLOCK_SIZE);
+	memcpy(&m0, mask, BLOCK_SIZE);
+	return __builtin_parityll(x0 & m0);
+}
+
+/*****************************************************************************
+* Encrypts the 'n' (at most BATCH) plaintexts of indexes 'first' onwards and
+* returns how many of them satisfy the linear approximation.
+*****************************************************************************/
+static u64 linear_batch(const experiment_t* e, u64 first, u32 n) {
+	const gift64_experiment* exp = e->exp;
+	u8 in[BATCH*BLOCK_SIZE], out[BATCH*BLOCK_SIZE];
+	u64 count = 0;
+	plaintexts(in, exp->seed, first, n);
+	gift64_encrypt_rounds(out, in, n*BLOCK_SIZE, e->rkey, exp->start,
+		exp->nrounds);
+	for(u32 i = 0; i < n; i++)
+		count += !(masked_parity(in + i*BLOCK_SIZE, exp->in) ^
+			masked_parity(out + i*BLOCK_SIZE, exp->out));
+	return count;
+}
+
+/*****************************************************************************
+* Encrypts the 'n' (at most BATCH/2) pairs of indexes 'first' onwards, as
+* consecutive blocks, and counts their output differences in 'hist'.
+*****************************************************************************/
+static void differential_batch(const experiment_t* e, u64* hist, u64 first,
+			u32 n) {
+	const gift64_experiment* exp = e->exp;
+	u8 in[BATCH*BLOCK_SIZE], out[BATCH*BLOCK_SIZE];
+	plaintexts(in, exp->seed, first, n);
+	for(u32 i = n; i-- > 0; ) {
+		memcpy(in + 2*i*BLOCK_SIZE, in + i*BLOCK_SIZE, BLOCK_SIZE);
+		for(int j = 0; j < BLOCK_SIZE; j++)
+			in[(2*i + 1)*BLOCK_SIZE + j] = in[2*i*BLOCK_SIZE + j] ^ exp->in[j];
+	}
+	gift64_encrypt_rounds(out, in, 2*n*BLOCK_SIZE, e->rkey, exp->start,
+		exp->nrounds);
+	for(u32 i = 0; i < n; i++) {
+		const u8* c = out + 2*i*BLOCK_SIZE;
+		u32 index = 0;
+		for(u32 j = 0; j < e->nbytes; j++)
+			index |= e->index[j][c[e->bytes[j]] ^ c[BLOCK_SIZE + e->bytes[j]]];
+		hist[index]++;
+	}
+}
+
+/*****************************************************************************
+* Processes chunks of plaintexts until none is left, then adds the local
+* counters to the result.
+*****************************************************************************/
+static void run_chunks(experiment_t* e) {
+	u64 chunk, first, count = 0, *hist = NULL;
+	u32 n, batch = e->linear ? BATCH : BATCH/2;
+	if(!e->linear) {
+		hist = calloc((size_t)1 << e->hist_bits, sizeof(u64));
+		if(!hist) {
+			__atomic_store_n(&e->failed, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	}
+	for(;;) {
+		chunk = __atomic_fetch_add(&e->next_chunk, 1, __ATOMIC_RELAXED);
+		if(chunk >= e->nchunks)
+			break;
+		first = chunk * e->chunk_len;
+		for(u64 i = 0; i < e->chunk_len; i += n) {
+			n = (e->chunk_len - i < batch) ? (u32)(e->chunk_len - i) : batch;
+			if(e->linear)
+				count += linear_batch(e, first + i, n);
+			else
+				differential_batch(e, hist, first + i, n);
+		}
+	}
+	pthread_mutex_lock(&e->lock);
+	e->count += count;
+	if(hist)
+		for(u64 i = 0; i < ((u64)1 << e->hist_bits); i++)
+			e->hist[i] += hist[i];
+	pthread_mutex_unlock(&e->lock);
+	free(hist);
+}
+
+static void* worker(void* arg) {
+	run_chunks((experiment_t*)arg);
+	return NULL;
+}
+
+/*****************************************************************************
+* Runs the experiment 'exp' with 'nthreads' threads (calling thread included,
+* 0 standing for the number of online processors).
+*****************************************************************************/
+static int run(const u32* rkey, const gift64_experiment* exp,
+			u32 nthreads, int linear, u64* hist, u64* count) {
+	experiment_t* e;
+	pthread_t* threads;
+	void* mem;
+	u32 nstarted = 0, log;
+	int ret;
+	if(exp->start > 28 || exp->nrounds > 28 - exp->start || exp->log_n > 62)
+		return -1;
+	if(posix_memalign(&mem, CACHE_LINE, sizeof(experiment_t)))
+		return -1;
+	e = mem;
+	memset(e, 0, sizeof(experiment_t));
+	e->rkey = rkey;
+	e->exp = exp;
+	e->linear = linear;
+	e->hist = hist;
+	for(int i = 0; !linear && i < BLOCK_SIZE; i++)
+		e->hist_bits += __builtin_popcount(exp->out[i]);
+	if(e->hist_bits > GIFT64_HIST_MAX_BITS) {
+		free(e);
+		return -1;
+	}
+	// the block is seen as a big-endian integer, its last byte holding bits 0-7
+	for(int i = BLOCK_SIZE - 1, l = 0; !linear && i >= 0; i--) {
+		if(!exp->out[i])
+			continue;
+		for(u32 b = 0; b < 256; b++)
+			for(int k = 0, m = l; k < 8; k++)
+				if((exp->out[i] >> k) & 1)
+					e->index[e->nbytes][b] |= ((b >> k) & 1) << m++;
+		l += __builtin_popcount(exp->out[i]);
+		e->bytes[e->nbytes++] = (u8)i;
+	}
+	if(!linear)
+		memset(hist, 0, sizeof(u64) << e->hist_bits);
+	log = (exp->log_n < CHUNK_LOG) ? exp->log_n : CHUNK_LOG;
+	e->chunk_len = (u64)1 << log;
+	e->nchunks = (u64)1 << (exp->log_n - log);
+	if(nthreads == 0) {
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = (n > 0) ? (u32)n : 1;
+	}
+	if(e->nchunks < nthreads)
+		nthreads = (u32)e->nchunks;
+	pthread_mutex_init(&e->lock, NULL);
+	threads = calloc(nthreads, sizeof(pthread_t));
+	for(u32 i = 1; threads && i < nthreads; i++)
+		if(pthread_create(&threads[nstarted + 1], NULL, worker, e) == 0)
+			nstarted++;
+	run_chunks(e);
+	for(u32 i = 1; i <= nstarted; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+	pthread_mutex_destroy(&e->lock);
+	ret = e->failed ? -1 : 0;
+	if(count)
+		*count = e->count;
+	free(e);
+	return ret;
+}
+
+/*****************************************************************************
+* Encrypts with the round keys 'rkey' (see 'precompute_rkeys') 2^exp->log_n
+* random pairs of plaintexts with the difference 'exp->in' through the rounds
+* 'exp->start' to 'exp->start + exp->nrounds - 1' and counts in
+* 'hist' the output differences restricted to the bits set in 'exp->out' (at
+* most GIFT64_HIST_MAX_BITS), the i-th bit of an index being the i-th of these
+* bits, from the least significant one of the block seen as a big-endian
+* integer. 'hist' must hold 2^(number of bits set in 'exp->out') counters.
+* Returns -1 if the parameters are invalid or memory is lacking.
+*****************************************************************************/
+int gift64_differential(const u32* rkey, const gift64_experiment* exp,
+			u32 nthreads, u64* hist) {
+	return run(rkey, exp, nthreads, 0, hist, NULL);
+}
+
+/*****************************************************************************
+* Encrypts 2^exp->log_n random plaintexts P through the same rounds and
+* writes to 'count' the number of them for which the parity of the bits of P
+* selected by 'exp->in' equals the parity of the bits of the output selected
+* by 'exp->out'. The bias is then count/2^exp->log_n - 1/2.
+*****************************************************************************/
+int gift64_linear(const u32* rkey, const gift64_experiment* exp,
+			u32 nthreads, u64* count) {
+	return run(rkey, exp, nthreads, 1, NULL, count);
+}
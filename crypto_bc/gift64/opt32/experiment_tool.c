@@ -0,0 +1,130 @@
+/*******************************************************************************
+* Command-line front end of 'gift64_differential' and 'gift64_linear'.
+*
+* Usage:
+*	./experiment diff IN OUT START NROUNDS LOGN [THREADS [SEED]]
+*		prints the most frequent output differences, restricted to the bits
+*		set in OUT, of 2^LOGN pairs with the input difference IN
+*	./experiment linear IN OUT START NROUNDS LOGN [THREADS [SEED]]
+*		prints the bias of the approximation with the masks IN and OUT
+* IN and OUT are 16 hex digits, the rounds START to START + NROUNDS - 1 are
+* applied and the key and plaintexts are derived from SEED (by default, the
+* current time). THREADS defaults to the number of online processors.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "encrypt.h"
+
+#define TOP		16		// number of output differences printed
+
+static int parse_hex(u8* out, const char* s, u32 len) {
+	unsigned int byte;
+	if(strlen(s) != 2*len)
+		return -1;
+	for(u32 i = 0; i < len; i++) {
+		if(sscanf(s + 2*i, "%2x", &byte) != 1)
+			return -1;
+		out[i] = (u8)byte;
+	}
+	return 0;
+}
+
+static void print_hex(const u8* in, u32 len) {
+	for(u32 i = 0; i < len; i++)
+		printf("%02x", in[i]);
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+/*****************************************************************************
+* Prints the TOP most frequent differences, as blocks with the histogrammed
+* bits of 'out' set to the bits of the histogram index.
+*****************************************************************************/
+static void print_top(u64* hist, u32 nbits, const u8* out, u32 log_n) {
+	u8 diff[BLOCK_SIZE];
+	for(int t = 0; t < TOP; t++) {
+		u64 best = 0;
+		for(u64 i = 1; i < ((u64)1 << nbits); i++)
+			if(hist[i] > hist[best])
+				best = i;
+		if(hist[best] == 0)
+			break;
+		memset(diff, 0, BLOCK_SIZE);
+		for(int j = 8*BLOCK_SIZE - 1, l = 0; j >= 0; j--)
+			if((out[j / 8] >> (7 - j % 8)) & 1)
+				diff[j / 8] |= ((best >> l++) & 1) << (7 - j % 8);
+		print_hex(diff, BLOCK_SIZE);
+		printf("  %llu  2^%.2f\n", hist[best], log2(hist[best]) - log_n);
+		hist[best] = 0;
+	}
+}
+
+int main(int argc, char** argv) {
+	gift64_experiment exp;
+	u32 rkey[56];
+	u8 key[KEY_SIZE];
+	u32 nthreads = 0, nbits = 0;
+	u64 count, *hist = NULL;
+	double t;
+	int ret, linear;
+	if(argc < 7 || argc > 9 || (strcmp(argv[1], "diff") &&
+			strcmp(argv[1], "linear"))) {
+		fprintf(stderr, "usage: %s diff|linear IN OUT START NROUNDS LOGN "
+			"[THREADS [SEED]]\n", argv[0]);
+		return 1;
+	}
+	linear = !strcmp(argv[1], "linear");
+	memset(&exp, 0, sizeof(exp));
+	if(parse_hex(exp.in, argv[2], BLOCK_SIZE) ||
+			parse_hex(exp.out, argv[3], BLOCK_SIZE)) {
+		fprintf(stderr, "IN and OUT must be 16 hex digits\n");
+		return 1;
+	}
+	exp.start = (u32)atoi(argv[4]);
+	exp.nrounds = (u32)atoi(argv[5]);
+	exp.log_n = (u32)atoi(argv[6]);
+	if(argc > 7)
+		nthreads = (u32)atoi(argv[7]);
+	exp.seed = (argc > 8) ? strtoull(argv[8], NULL, 0) : (u64)time(NULL);
+	for(int i = 0; i < KEY_SIZE; i++)
+		key[i] = (u8)((exp.seed ^ 0x5a5a5a5a5a5a5a5aULL) >> (8*(i % 8))) ^
+			(u8)(i*0x3b);
+	precompute_rkeys(rkey, key);
+	for(int i = 0; i < BLOCK_SIZE; i++)
+		nbits += __builtin_popcount(exp.out[i]);
+	if(!linear && nbits <= GIFT64_HIST_MAX_BITS)
+		hist = malloc(sizeof(u64) << nbits);
+	t = now();
+	ret = linear ? gift64_linear(rkey, &exp, nthreads, &count) :
+		(hist ? gift64_differential(rkey, &exp, nthreads, hist) : -1);
+	t = now() - t;
+	if(ret != 0) {
+		fprintf(stderr, "invalid rounds, too many plaintexts or more than %d "
+			"bits in OUT\n", GIFT64_HIST_MAX_BITS);
+		free(hist);
+		return 1;
+	}
+	printf("seed %llu, key ", exp.seed);
+	print_hex(key, KEY_SIZE);
+	printf(", '%s' backend\n", gift64_current_backend());
+	if(linear) {
+		double bias = (double)count / ((u64)1 << exp.log_n) - 0.5;
+		printf("%llu of 2^%u plaintexts, bias %.6g (2^%.2f)\n", count,
+			exp.log_n, bias, log2(fabs(bias)));
+	} else {
+		print_top(hist, nbits, exp.out, exp.log_n);
+	}
+	printf("%.3f s: %.3g %s/s\n", t, ((u64)1 << exp.log_n) / t,
+		linear ? "plaintexts" : "pairs");
+	free(hist);
+	return 0;
+}
@@ -0,0 +1,251 @@
+#ifndef GIFT64_FIXSLICED_H_
+#define GIFT64_FIXSLICED_H_
+
+/****************************************************************************
+* Fixsliced round functions of GIFT-64, written once for any word type.
+*
+* Every operation on words is named after its scalar version in 'gift64.h'
+* followed by the suffix 'W' (empty for 32-bit words, '_X8' for AVX2 and
+* '_X16' for AVX-512), so that a new word type only has to provide XOR##W,
+* SET1##W (broadcast of a 32-bit constant), SBOX##W, INV_SBOX##W,
+* NIBBLE_ROR_{1,2,3}##W, ROR_{8,16,24}##W and SWAPMOVE_1##W (SWAPMOVE within
+* a single word).
+****************************************************************************/
+#define ADD_RKEY_W(W, state, rkey, rconst, i, j, k0, k1, k2) ({\
+	state[k0] = XOR##W(state[k0], SET1##W((rkey)[i]));		\
+	state[k1] = XOR##W(state[k1], SET1##W((rkey)[(i)+1]));	\
+	state[k2] = XOR##W(state[k2], SET1##W((rconst)[j]));	\
+})
+
+/****************************************************************************
+* The 4 rounds of a quadruple, each one with its own fixsliced representation
+* of the state: 'rkey' and 'rconst' point to the round keys and constants of
+* the whole quadruple.
+****************************************************************************/
+#define ROUND_0_W(W, state, rkey, rconst) ({				\
+	SBOX##W(state[0], state[1], state[2], state[3]);		\
+	state[1] = NIBBLE_ROR_1##W(state[1]);					\
+	state[2] = NIBBLE_ROR_2##W(state[2]);					\
+	state[0] = NIBBLE_ROR_3##W(state[0]);					\
+	ADD_RKEY_W(W, state, rkey, rconst, 0, 0, 3, 1, 0);		\
+})
+
+#define ROUND_1_W(W, state, rkey, rconst) ({				\
+	SBOX##W(state[3], state[1], state[2], state[0]);		\
+	state[1] = ROR_8##W(state[1]);							\
+	state[2] = ROR_16##W(state[2]);							\
+	state[3] = ROR_24##W(state[3]);							\
+	ADD_RKEY_W(W, state, rkey, rconst, 2, 1, 0, 1, 3);		\
+})
+
+#define ROUND_2_W(W, state, rkey, rconst) ({				\
+	SBOX##W(state[0], state[1], state[2], state[3]);		\
+	state[1] = NIBBLE_ROR_3##W(state[1]);					\
+	state[2] = NIBBLE_ROR_2##W(state[2]);					\
+	state[0] = NIBBLE_ROR_1##W(state[0]);					\
+	ADD_RKEY_W(W, state, rkey, rconst, 4, 2, 3, 1, 0);		\
+})
+
+#define ROUND_3_W(W, state, rkey, rconst) ({				\
+	SBOX##W(state[3], state[1], state[2], state[0]);		\
+	state[1] = ROR_24##W(state[1]);							\
+	state[2] = ROR_16##W(state[2]);							\
+	state[3] = ROR_8##W(state[3]);							\
+	ADD_RKEY_W(W, state, rkey, rconst, 6, 3, 0, 1, 3);		\
+})
+
+#define QUADRUPLE_ROUND_W(W, state, rkey, rconst) ({		\
+	ROUND_0_W(W, state, rkey, rconst);						\
+	ROUND_1_W(W, state, rkey, rconst);						\
+	ROUND_2_W(W, state, rkey, rconst);						\
+	ROUND_3_W(W, state, rkey, rconst);						\
+})
+
+#define INV_ROUND_3_W(W, state, rkey, rconst) ({			\
+	ADD_RKEY_W(W, state, rkey, rconst, 6, 3, 0, 1, 3);		\
+	state[1] = ROR_8##W(state[1]);							\
+	state[2] = ROR_16##W(state[2]);							\
+	state[3] = ROR_24##W(state[3]);							\
+	INV_SBOX##W(state[0], state[1], state[2], state[3]);	\
+})
+
+#define INV_ROUND_2_W(W, state, rkey, rconst) ({			\
+	ADD_RKEY_W(W, state, rkey, rconst, 4, 2, 3, 1, 0);		\
+	state[1] = NIBBLE_ROR_1##W(state[1]);					\
+	state[2] = NIBBLE_ROR_2##W(state[2]);					\
+	state[0] = NIBBLE_ROR_3##W(state[0]);					\
+	INV_SBOX##W(state[3], state[1], state[2], state[0]);	\
+})
+
+#define INV_ROUND_1_W(W, state, rkey, rconst) ({			\
+	ADD_RKEY_W(W, state, rkey, rconst, 2, 1, 0, 1, 3);		\
+	state[1] = ROR_24##W(state[1]);							\
+	state[2] = ROR_16##W(state[2]);							\
+	state[3] = ROR_8##W(state[3]);							\
+	INV_SBOX##W(state[0], state[1], state[2], state[3]);	\
+})
+
+#define INV_ROUND_0_W(W, state, rkey, rconst) ({			\
+	ADD_RKEY_W(W, state, rkey, rconst, 0, 0, 3, 1, 0);		\
+	state[1] = NIBBLE_ROR_3##W(state[1]);					\
+	state[2] = NIBBLE_ROR_2##W(state[2]);					\
+	state[0] = NIBBLE_ROR_1##W(state[0]);					\
+	INV_SBOX##W(state[3], state[1], state[2], state[0]);	\
+})
+
+#define INV_QUADRUPLE_ROUND_W(W, state, rkey, rconst) ({	\
+	INV_ROUND_3_W(W, state, rkey, rconst);					\
+	INV_ROUND_2_W(W, state, rkey, rconst);					\
+	INV_ROUND_1_W(W, state, rkey, rconst);					\
+	INV_ROUND_0_W(W, state, rkey, rconst);					\
+})
+
+/****************************************************************************
+* Before the round 4i+k, the state is in the representation of 'packing' up
+* to the same permutation TAU_k of the bits of every word, applied to
+* (state[3], state[1], state[2], state[0]) if k is odd. TAU_2 is an involution
+* and TAU_3 the inverse of TAU_1, all of them being a few SWAPMOVEs.
+****************************************************************************/
+#define TAU_1_W(W, x) ({									\
+	SWAPMOVE_1##W(x, 0x0000ff00, 16);						\
+	SWAPMOVE_1##W(x, 0x0000cccc, 14);						\
+	SWAPMOVE_1##W(x, 0x00aa00aa, 7);						\
+})
+
+#define INV_TAU_1_W(W, x) ({								\
+	SWAPMOVE_1##W(x, 0x00aa00aa, 7);						\
+	SWAPMOVE_1##W(x, 0x0000cccc, 14);						\
+	SWAPMOVE_1##W(x, 0x0000ff00, 16);						\
+})
+
+#define TAU_2_W(W, x) ({									\
+	SWAPMOVE_1##W(x, 0x22222222, 2);						\
+	SWAPMOVE_1##W(x, 0x0000ff00, 16);						\
+})
+
+#define TAU_W(W, state, tau) ({								\
+	tau##_W(W, state[0]);									\
+	tau##_W(W, state[1]);									\
+	tau##_W(W, state[2]);									\
+	tau##_W(W, state[3]);									\
+})
+
+#define SWAP_03(state) ({									\
+	tmp = state[0];											\
+	state[0] = state[3];									\
+	state[3] = tmp;											\
+})
+
+// from the representation of 'packing' to the one of the round 4i+k
+#define TO_ROUND_W(W, state, k) ({							\
+	switch(k) {												\
+	case 1:													\
+		SWAP_03(state);										\
+		TAU_W(W, state, TAU_1);								\
+		break;												\
+	case 2:													\
+		TAU_W(W, state, TAU_2);								\
+		break;												\
+	case 3:													\
+		SWAP_03(state);										\
+		TAU_W(W, state, INV_TAU_1);							\
+		break;												\
+	}														\
+})
+
+// from the representation of the round 4i+k to the one of 'packing'
+#define FROM_ROUND_W(W, state, k) ({						\
+	switch(k) {												\
+	case 1:													\
+		TAU_W(W, state, INV_TAU_1);							\
+		SWAP_03(state);										\
+		break;												\
+	case 2:													\
+		TAU_W(W, state, TAU_2);								\
+		break;												\
+	case 3:													\
+		TAU_W(W, state, TAU_1);								\
+		SWAP_03(state);										\
+		break;												\
+	}														\
+})
+
+// round 4i+k alone, 'rkey' and 'rconst' pointing to the ones of round 4i
+#define ROUND_K_W(W, state, rkey, rconst, k) ({				\
+	switch(k) {												\
+	case 0:													\
+		ROUND_0_W(W, state, rkey, rconst);					\
+		break;												\
+	case 1:													\
+		ROUND_1_W(W, state, rkey, rconst);					\
+		break;												\
+	case 2:													\
+		ROUND_2_W(W, state, rkey, rconst);					\
+		break;												\
+	case 3:													\
+		ROUND_3_W(W, state, rkey, rconst);					\
+		break;												\
+	}														\
+})
+
+#define INV_ROUND_K_W(W, state, rkey, rconst, k) ({			\
+	switch(k) {												\
+	case 0:													\
+		INV_ROUND_0_W(W, state, rkey, rconst);				\
+		break;												\
+	case 1:													\
+		INV_ROUND_1_W(W, state, rkey, rconst);				\
+		break;												\
+	case 2:													\
+		INV_ROUND_2_W(W, state, rkey, rconst);				\
+		break;												\
+	case 3:													\
+		INV_ROUND_3_W(W, state, rkey, rconst);				\
+		break;												\
+	}														\
+})
+
+/****************************************************************************
+* Rounds 'start' to 'end - 1' (0 <= start <= end <= 28), the state being in
+* the representation of 'packing' before and after. Whole quadruples are
+* processed as usual, the remaining rounds one at a time, so that only the
+* first and last ones cost a representation change.
+****************************************************************************/
+#define ROUNDS_W(W, state, rkey, rconst, start, end) ({		\
+	u32 r = (start);										\
+	TO_ROUND_W(W, state, r % 4);							\
+	while(r < (end)) {										\
+		const u32 q = r - r % 4;							\
+		if(r == q && r + 4 <= (end)) {						\
+			QUADRUPLE_ROUND_W(W, state, (rkey) + 2*q,		\
+				(rconst) + q);								\
+			r += 4;											\
+		} else {											\
+			ROUND_K_W(W, state, (rkey) + 2*q, (rconst) + q,	\
+				r - q);										\
+			r++;											\
+		}													\
+	}														\
+	FROM_ROUND_W(W, state, r % 4);							\
+})
+
+// inverse of 'ROUNDS_W' with the same 'start' and 'end'
+#define INV_ROUNDS_W(W, state, rkey, rconst, start, end) ({	\
+	u32 r = (end);											\
+	TO_ROUND_W(W, state, r % 4);							\
+	while(r > (start)) {									\
+		const u32 q = (r - 1) - (r - 1) % 4;				\
+		if(r == q + 4 && q >= (start)) {					\
+			INV_QUADRUPLE_ROUND_W(W, state, (rkey) + 2*q,	\
+				(rconst) + q);								\
+			r -= 4;											\
+		} else {											\
+			INV_ROUND_K_W(W, state, (rkey) + 2*q,			\
+				(rconst) + q, r - 1 - q);					\
+			r--;											\
+		}													\
+	}														\
+	FROM_ROUND_W(W, state, r % 4);							\
+})
+
+#endif  // GIFT64_FIXSLICED_H_
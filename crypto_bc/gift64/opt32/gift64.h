@@ -1,6 +1,8 @@
 #ifndef GIFT64_H_
 #define GIFT64_H_
 
+#include "fixsliced.h"
+
 #define ROR(x,y) 		(((x) >> (y)) | ((x) << (32 - (y))))
 #define NIBBLE_ROR_1(x) ((((x) >> 1) & 0x77777777) | (((x) & 0x11111111) << 3))
 #define NIBBLE_ROR_2(x) ((((x) >> 2) & 0x33333333) | (((x) & 0x33333333) << 2))
@@ -12,6 +14,10 @@
 	a ^= (tmp << n);														\
 })
 
+// SWAPMOVE within a single word
+#define SWAPMOVE_1(a, mask, n)												\
+	SWAPMOVE(a, a, mask, n)
+
 #define SBOX(s0, s1, s2, s3)												\
 	s1 ^= s0 & s2;															\
 	s0 ^= s1 & s3;															\
@@ -28,66 +34,20 @@
 	s3 ^= s1 & s0;															\
 	s1 ^= s3 & s2;
 
-#define QUADRUPLE_ROUND(state, rkey, rconst) ({								\
-	SBOX(state[0], state[1], state[2], state[3]);							\
-	state[1] = NIBBLE_ROR_1(state[1]);										\
-	state[2] = NIBBLE_ROR_2(state[2]);										\
-	state[0] = NIBBLE_ROR_3(state[0]);										\
-	state[3] ^= (rkey)[0];													\
-	state[1] ^= (rkey)[1];													\
-	state[0] ^= (rconst)[0];												\
-	SBOX(state[3], state[1], state[2], state[0]);							\
-	state[1] = ROR(state[1], 8);											\
-	state[2] = ROR(state[2], 16);											\
-	state[3] = ROR(state[3], 24);											\
-	state[0] ^= (rkey)[2];													\
-	state[1] ^= (rkey)[3];													\
-	state[3] ^= (rconst)[1];												\
-	SBOX(state[0], state[1], state[2], state[3]);							\
-	state[1] = NIBBLE_ROR_3(state[1]);										\
-	state[2] = NIBBLE_ROR_2(state[2]);										\
-	state[0] = NIBBLE_ROR_1(state[0]);										\
-	state[3] ^= (rkey)[4];													\
-	state[1] ^= (rkey)[5];													\
-	state[0] ^= (rconst)[2];												\
-	SBOX(state[3], state[1], state[2], state[0]);							\
-	state[1] = ROR(state[1], 24);											\
-	state[2] = ROR(state[2], 16);											\
-	state[3] = ROR(state[3], 8);											\
-	state[0] ^= (rkey)[6];													\
-	state[1] ^= (rkey)[7];													\
-	state[3] ^= (rconst)[3];												\
-})
+// remaining operations expected by 'fixsliced.h'
+#define XOR(x,y)		((x) ^ (y))
+#define SET1(x)			(x)
+#define ROR_8(x)		ROR(x, 8)
+#define ROR_16(x)		ROR(x, 16)
+#define ROR_24(x)		ROR(x, 24)
 
-#define INV_QUADRUPLE_ROUND(state, rkey, rconst) ({							\
-	state[0] ^= (rkey)[6];													\
-	state[1] ^= (rkey)[7];													\
-	state[3] ^= (rconst)[3];												\
-	state[1] = ROR(state[1], 8);											\
-	state[2] = ROR(state[2], 16);											\
-	state[3] = ROR(state[3], 24);											\
-	INV_SBOX(state[0], state[1], state[2],  state[3]);						\
-	state[3] ^= (rkey)[4];													\
-	state[1] ^= (rkey)[5];													\
-	state[0] ^= (rconst)[2];												\
-	state[1] = NIBBLE_ROR_1(state[1]);										\
-	state[2] = NIBBLE_ROR_2(state[2]);										\
-	state[0] = NIBBLE_ROR_3(state[0]);										\
-	INV_SBOX(state[3], state[1], state[2], state[0]);						\
-	state[0] ^= (rkey)[2];													\
-	state[1] ^= (rkey)[3];													\
-	state[3] ^= (rconst)[1];												\
-	state[1] = ROR(state[1], 24);											\
-	state[2] = ROR(state[2], 16);											\
-	state[3] = ROR(state[3], 8);											\
-	INV_SBOX(state[0], state[1], state[2],  state[3]);						\
-	state[3] ^= (rkey)[0];													\
-	state[1] ^= (rkey)[1];													\
-	state[0] ^= (rconst)[0];												\
-	state[1] = NIBBLE_ROR_3(state[1]);										\
-	state[2] = NIBBLE_ROR_2(state[2]);										\
-	state[0] = NIBBLE_ROR_1(state[0]);										\
-	INV_SBOX(state[3], state[1], state[2],  state[0]);						\
-})
+#define QUADRUPLE_ROUND(state, rkey, rconst)								\
+	QUADRUPLE_ROUND_W(, state, rkey, rconst)
+#define INV_QUADRUPLE_ROUND(state, rkey, rconst)							\
+	INV_QUADRUPLE_ROUND_W(, state, rkey, rconst)
+#define ROUNDS(state, rkey, rconst, start, end)								\
+	ROUNDS_W(, state, rkey, rconst, start, end)
+#define INV_ROUNDS(state, rkey, rconst, start, end)							\
+	INV_ROUNDS_W(, state, rkey, rconst, start, end)
 
 #endif  // GIFT64_H_
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef GIFT64_HPP_
+#define GIFT64_HPP_
+
+/****************************************************************************
+* Compile-time GIFT-64 key schedule for C++20.
+*
+* 'gift::gift64_rkeys' evaluates the very same 'KEY_SCHEDULE' macro as
+* 'precompute_rkeys' (see 'key_schedule.h'), so that the round keys of a key
+* known at build time can be stored in read-only memory, e.g.
+*	static constexpr auto rkey = gift::gift64_rkeys(FIRMWARE_KEY);
+*	gift64_encrypt_ecb_rkey(ctext, ptext, len, rkey.data());
+* The macros of the C headers, 'BLOCK_SIZE' and 'KEY_SIZE' included, are
+* undefined at the end of this header so that it can be included along with
+* 'gift128.hpp': use 'gift64_block_size' and 'gift64_key_size' instead.
+* The C sources of this directory have to be linked as usual.
+****************************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+extern "C" {
+#include "encrypt.h"
+}
+#include "gift64.h"
+#include "key_schedule.h"
+
+namespace gift {
+
+inline constexpr std::size_t gift64_block_size = BLOCK_SIZE;
+inline constexpr std::size_t gift64_key_size = KEY_SIZE;
+
+using Gift64Rkeys = std::array<u32, 56>;
+
+constexpr Gift64Rkeys gift64_rkeys(
+			std::span<const std::uint8_t, KEY_SIZE> key) noexcept {
+	Gift64Rkeys rkeys{};
+	u32 tmp = 0, *rkey = rkeys.data();
+	KEY_SCHEDULE(rkey, key);
+	return rkeys;
+}
+
+// first and last round keys of the 3rd test vector, as computed at run time
+static_assert([] {
+	constexpr std::uint8_t key[KEY_SIZE] = {
+		0xbd, 0x91, 0x73, 0x1e, 0xb6, 0xbc, 0x27, 0x13,
+		0xa1, 0xf9, 0xf6, 0xff, 0xc7, 0x50, 0x44, 0xe7};
+	constexpr Gift64Rkeys rkey = gift64_rkeys(key);
+	return rkey[0] == 0x770066ee && rkey[1] == 0x22ee44cc &&
+		rkey[54] == 0xee1188cc && rkey[55] == 0xdd9911bb;
+}(), "compile-time and run-time GIFT-64 key schedules differ");
+
+}  // namespace gift
+
+// the macros of the C headers, which would clash with those of 'gift128.hpp'
+#undef BLOCK_SIZE
+#undef KEY_SIZE
+#undef U32BIG
+#undef U8BIG
+#undef LOAD32_BE
+#undef STORE32_BE
+#undef TRANSPOSE_U32
+#undef REARRANGE_KEYWORD_0_1
+#undef REARRANGE_KEYWORD_2_3
+#undef REARRANGE_KEY
+#undef KEY_UPDATE
+#undef KEY_SCHEDULE
+#undef ROR
+#undef NIBBLE_ROR_1
+#undef NIBBLE_ROR_2
+#undef NIBBLE_ROR_3
+#undef SWAPMOVE
+#undef SWAPMOVE_1
+#undef SBOX
+#undef INV_SBOX
+#undef XOR
+#undef SET1
+#undef ROR_8
+#undef ROR_16
+#undef ROR_24
+#undef QUADRUPLE_ROUND
+#undef INV_QUADRUPLE_ROUND
+#undef ROUNDS
+#undef INV_ROUNDS
+#undef ADD_RKEY_W
+#undef ROUND_0_W
+#undef ROUND_1_W
+#undef ROUND_2_W
+#undef ROUND_3_W
+#undef QUADRUPLE_ROUND_W
+#undef INV_ROUND_3_W
+#undef INV_ROUND_2_W
+#undef INV_ROUND_1_W
+#undef INV_ROUND_0_W
+#undef INV_QUADRUPLE_ROUND_W
+#undef TAU_1_W
+#undef INV_TAU_1_W
+#undef TAU_2_W
+#undef TAU_W
+#undef SWAP_03
+#undef TO_ROUND_W
+#undef FROM_ROUND_W
+#undef ROUND_K_W
+#undef INV_ROUND_K_W
+#undef ROUNDS_W
+#undef INV_ROUNDS_W
+
+#endif  // GIFT64_HPP_
@@ -0,0 +1,86 @@
+#ifndef GIFT64_AVX2_H_
+#define GIFT64_AVX2_H_
+
+#include "backend.h"
+#include "fixsliced.h"
+
+#ifdef GIFT64_AVX2
+
+#include <immintrin.h>
+
+#define TARGET_AVX2		__attribute__((target("avx2")))
+
+/****************************************************************************
+* Same macros as in 'gift64.h' but operating on 16 blocks at once, each of
+* the 8 32-bit lanes of a '__m256i' holding the same slice of another pair of
+* blocks.
+****************************************************************************/
+#define SET1_X8(x)											\
+	_mm256_set1_epi32((int)(x))
+#define XOR_X8(x,y)											\
+	_mm256_xor_si256((x), (y))
+#define AND_X8(x,y)											\
+	_mm256_and_si256((x), (y))
+#define OR_X8(x,y)											\
+	_mm256_or_si256((x), (y))
+#define SHIFT_OR_X8(x, rs, m0, m1, ls)						\
+	OR_X8(AND_X8(_mm256_srli_epi32((x), (rs)), SET1_X8(m0)),\
+		_mm256_slli_epi32(AND_X8((x), SET1_X8(m1)), (ls)))
+#define BYTE_SHUFFLE_X8(x, b0, b1, b2, b3)					\
+	_mm256_shuffle_epi8((x), _mm256_setr_epi8(				\
+		b0, b1, b2, b3, b0+4, b1+4, b2+4, b3+4,				\
+		b0+8, b1+8, b2+8, b3+8, b0+12, b1+12, b2+12, b3+12,	\
+		b0, b1, b2, b3, b0+4, b1+4, b2+4, b3+4,				\
+		b0+8, b1+8, b2+8, b3+8, b0+12, b1+12, b2+12, b3+12))
+
+// rotations by a multiple of 8 are single byte shuffles
+#define ROR_8_X8(x)		BYTE_SHUFFLE_X8(x, 1, 2, 3, 0)
+#define ROR_16_X8(x)	BYTE_SHUFFLE_X8(x, 2, 3, 0, 1)
+#define ROR_24_X8(x)	BYTE_SHUFFLE_X8(x, 3, 0, 1, 2)
+#define NIBBLE_ROR_1_X8(x)									\
+	SHIFT_OR_X8(x, 1, 0x77777777, 0x11111111, 3)
+#define NIBBLE_ROR_2_X8(x)									\
+	SHIFT_OR_X8(x, 2, 0x33333333, 0x33333333, 2)
+#define NIBBLE_ROR_3_X8(x)									\
+	SHIFT_OR_X8(x, 3, 0x11111111, 0x77777777, 1)
+
+#define SWAPMOVE_X8(a, b, mask, n)							\
+	tmp = AND_X8(XOR_X8(b, _mm256_srli_epi32(a, n)), SET1_X8(mask));\
+	b = XOR_X8(b, tmp);										\
+	a = XOR_X8(a, _mm256_slli_epi32(tmp, n));
+
+// SWAPMOVE within a single word
+#define SWAPMOVE_1_X8(a, mask, n)							\
+	SWAPMOVE_X8(a, a, mask, n)
+
+#define SBOX_X8(s0, s1, s2, s3)								\
+	s1 = XOR_X8(s1, AND_X8(s0, s2));						\
+	s0 = XOR_X8(s0, AND_X8(s1, s3));						\
+	s2 = XOR_X8(s2, OR_X8(s0, s1));							\
+	s3 = XOR_X8(s3, s2);									\
+	s1 = XOR_X8(s1, s3);									\
+	s2 = XOR_X8(s2, AND_X8(s0, s1));
+
+#define INV_SBOX_X8(s0, s1, s2, s3)							\
+	s2 = XOR_X8(s2, AND_X8(s3, s1));						\
+	s1 = XOR_X8(s1, s0);									\
+	s0 = XOR_X8(s0, s2);									\
+	s2 = XOR_X8(s2, OR_X8(s3, s1));							\
+	s3 = XOR_X8(s3, AND_X8(s1, s0));						\
+	s1 = XOR_X8(s1, AND_X8(s3, s2));
+
+#define QUADRUPLE_ROUND_X8(state, rkey, rconst)			\
+	QUADRUPLE_ROUND_W(_X8, state, rkey, rconst)
+#define INV_QUADRUPLE_ROUND_X8(state, rkey, rconst)		\
+	INV_QUADRUPLE_ROUND_W(_X8, state, rkey, rconst)
+#define ROUNDS_X8(state, rkey, rconst, start, end)			\
+	ROUNDS_W(_X8, state, rkey, rconst, start, end)
+#define INV_ROUNDS_X8(state, rkey, rconst, start, end)		\
+	INV_ROUNDS_W(_X8, state, rkey, rconst, start, end)
+
+extern void gift64_encrypt_x16(u8* ctext, const u8* ptext, const u32* rkey);
+extern void gift64_decrypt_x16(u8* ptext, const u8* ctext, const u32* rkey);
+
+#endif  // GIFT64_AVX2
+
+#endif  // GIFT64_AVX2_H_
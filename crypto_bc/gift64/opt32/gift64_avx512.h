@@ -0,0 +1,90 @@
+#ifndef GIFT64_AVX512_H_
+#define GIFT64_AVX512_H_
+
+#include "backend.h"
+#include "fixsliced.h"
+
+#ifdef GIFT64_AVX512
+
+#include <immintrin.h>
+
+#define TARGET_AVX512	__attribute__((target("avx512f")))
+
+/****************************************************************************
+* Same macros as in 'gift64.h' but operating on 32 blocks at once, each of
+* the 16 32-bit lanes of a '__m512i' holding the same slice of another pair of
+* blocks. Boolean functions of up to 3 inputs are computed with a single
+* 'vpternlogd' whose immediate is the truth table of the function, where the
+* 1st, 2nd and 3rd operands are respectively represented by 0xf0, 0xcc and
+* 0xaa.
+****************************************************************************/
+#define SET1_X16(x)											\
+	_mm512_set1_epi32((int)(x))
+#define XOR_X16(x,y)										\
+	_mm512_xor_si512((x), (y))
+#define TERNLOG_X16(a, b, c, imm)							\
+	_mm512_ternarylogic_epi32((a), (b), (c), (imm))
+#define XOR_AND_X16(a, b, c)		TERNLOG_X16(a, b, c, 0x78)	// a^(b&c)
+#define XOR_OR_X16(a, b, c)			TERNLOG_X16(a, b, c, 0x1e)	// a^(b|c)
+#define XOR3_X16(a, b, c)			TERNLOG_X16(a, b, c, 0x96)	// a^b^c
+#define SELECT_X16(m, a, b)			TERNLOG_X16(m, a, b, 0xca)	// m?a:b
+#define ROR_X16(x, y)										\
+	_mm512_ror_epi32((x), (y))
+// rotations within bit-fields, for which 'm1 << ls' is always equal to '~m0'
+#define SHIFT_OR_X16(x, rs, m0, m1, ls)						\
+	SELECT_X16(SET1_X16(m0), _mm512_srli_epi32((x), (rs)),	\
+		_mm512_slli_epi32((x), (ls)))
+
+#define ROR_8_X16(x)		ROR_X16(x, 8)
+#define ROR_16_X16(x)		ROR_X16(x, 16)
+#define ROR_24_X16(x)		ROR_X16(x, 24)
+#define NIBBLE_ROR_1_X16(x)									\
+	SHIFT_OR_X16(x, 1, 0x77777777, 0x11111111, 3)
+#define NIBBLE_ROR_2_X16(x)									\
+	SHIFT_OR_X16(x, 2, 0x33333333, 0x33333333, 2)
+#define NIBBLE_ROR_3_X16(x)									\
+	SHIFT_OR_X16(x, 3, 0x11111111, 0x77777777, 1)
+
+#define SWAPMOVE_X16(a, b, mask, n)							\
+	tmp = TERNLOG_X16(b, _mm512_srli_epi32(a, n), SET1_X16(mask), 0x28);\
+	b = XOR_X16(b, tmp);									\
+	a = XOR_X16(a, _mm512_slli_epi32(tmp, n));
+
+// SWAPMOVE within a single word, both XORs are merged into one 'vpternlogd'
+#define SWAPMOVE_1_X16(a, mask, n)							\
+	tmp = TERNLOG_X16(a, _mm512_srli_epi32(a, n), SET1_X16(mask), 0x28);\
+	a = XOR3_X16(a, tmp, _mm512_slli_epi32(tmp, n));
+
+#define SBOX_X16(s0, s1, s2, s3)							\
+	s1 = XOR_AND_X16(s1, s0, s2);							\
+	s0 = XOR_AND_X16(s0, s1, s3);							\
+	s2 = XOR_OR_X16(s2, s0, s1);							\
+	s1 = XOR3_X16(s1, s3, s2);								\
+	s3 = XOR_X16(s3, s2);									\
+	s2 = XOR_AND_X16(s2, s0, s1);
+
+#define INV_SBOX_X16(s0, s1, s2, s3)						\
+	s2 = XOR_AND_X16(s2, s3, s1);							\
+	s1 = XOR_X16(s1, s0);									\
+	s0 = XOR_X16(s0, s2);									\
+	s2 = XOR_OR_X16(s2, s3, s1);							\
+	s3 = XOR_AND_X16(s3, s1, s0);							\
+	s1 = XOR_AND_X16(s1, s3, s2);
+
+#define QUADRUPLE_ROUND_X16(state, rkey, rconst)			\
+	QUADRUPLE_ROUND_W(_X16, state, rkey, rconst)
+#define INV_QUADRUPLE_ROUND_X16(state, rkey, rconst)		\
+	INV_QUADRUPLE_ROUND_W(_X16, state, rkey, rconst)
+#define ROUNDS_X16(state, rkey, rconst, start, end)			\
+	ROUNDS_W(_X16, state, rkey, rconst, start, end)
+#define INV_ROUNDS_X16(state, rkey, rconst, start, end)		\
+	INV_ROUNDS_W(_X16, state, rkey, rconst, start, end)
+
+extern void gift64_encrypt_x32(u8* ctext, const u8* ptext, u32 nblocks,
+				const u32* rkey);
+extern void gift64_decrypt_x32(u8* ptext, const u8* ctext, u32 nblocks,
+				const u32* rkey);
+
+#endif  // GIFT64_AVX512
+
+#endif  // GIFT64_AVX512_H_
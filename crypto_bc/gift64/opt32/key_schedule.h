@@ -1,5 +1,5 @@
-#ifndef KEYSCHEDULE_H_
-#define KEYSCHEDULE_H_
+#ifndef GIFT64_KEYSCHEDULE_H_
+#define GIFT64_KEYSCHEDULE_H_
 
 #define TRANSPOSE_U32(x) ({												\
 	tmp = x & 0x88442211;												\
@@ -22,4 +22,78 @@
 	(((y) & 0xf0) << 4)		| ((y) & 0x0f);								\
 })
 
-#endif  // KEYSCHEDULE_H_
\ No newline at end of file
+/****************************************************************************
+* Rearranges the key to match the GIFT-64 fixsliced representation.
+****************************************************************************/
+#define REARRANGE_KEY(rkey, key) ({										\
+	/* key words W6 and W7 */											\
+	(rkey)[0] = REARRANGE_KEYWORD_0_1((key)[14], (key)[15]);			\
+	(rkey)[1] = REARRANGE_KEYWORD_0_1((key)[12], (key)[13]);			\
+	TRANSPOSE_U32((rkey)[0]);											\
+	TRANSPOSE_U32((rkey)[1]);											\
+	(rkey)[0] |= ((rkey)[0] << 4); /* interleaved with itself */		\
+	(rkey)[1] |= ((rkey)[1] << 4);										\
+	(rkey)[0] ^= 0xffffffff; /* saves 1 op in the sbox */				\
+	/* key words W4 and W5 */											\
+	(rkey)[2] = REARRANGE_KEYWORD_0_1((key)[10], (key)[11]);			\
+	(rkey)[3] = REARRANGE_KEYWORD_0_1((key)[8], (key)[9]);				\
+	(rkey)[2] |= ((rkey)[2] << 4);										\
+	(rkey)[3] |= ((rkey)[3] << 4);										\
+	(rkey)[2] ^= 0xffffffff;											\
+	SWAPMOVE((rkey)[2], (rkey)[2], 0x22222222, 2);						\
+	SWAPMOVE((rkey)[3], (rkey)[3], 0x22222222, 2);						\
+	/* key words W2 and W3 */											\
+	(rkey)[4] = REARRANGE_KEYWORD_2_3((key)[6], (key)[7]);				\
+	(rkey)[5] = REARRANGE_KEYWORD_2_3((key)[4], (key)[5]);				\
+	TRANSPOSE_U32((rkey)[4]);											\
+	TRANSPOSE_U32((rkey)[5]);											\
+	SWAPMOVE((rkey)[4], (rkey)[4], 0x00000f00, 16);						\
+	SWAPMOVE((rkey)[5], (rkey)[5], 0x00000f00, 16);						\
+	(rkey)[4] |= ((rkey)[4] << 4);										\
+	(rkey)[5] |= ((rkey)[5] << 4);										\
+	(rkey)[4] ^= 0xffffffff;											\
+	/* key words W0 and W1 */											\
+	(rkey)[6] = REARRANGE_KEYWORD_2_3((key)[2], (key)[3]);				\
+	(rkey)[7] = REARRANGE_KEYWORD_2_3((key)[0], (key)[1]);				\
+	(rkey)[6] |= ((rkey)[6] << 4);										\
+	(rkey)[7] |= ((rkey)[7] << 4);										\
+	(rkey)[6] ^= 0xffffffff;											\
+})
+
+/****************************************************************************
+* Updates the rkeys according to the fixsliced representation.
+****************************************************************************/
+#define KEY_UPDATE(next_rkey, prev_rkey) ({								\
+	/* 1st round key */													\
+	(next_rkey)[0] = NIBBLE_ROR_1((prev_rkey)[0]);						\
+	(next_rkey)[1] = NIBBLE_ROR_3((prev_rkey)[1]) & 0x0000ffff;			\
+	(next_rkey)[1] |= (prev_rkey)[1] & 0xffff0000;						\
+	(next_rkey)[1] = ROR((next_rkey)[1], 16);							\
+	/* 2nd round key */													\
+	(next_rkey)[2] = ROR((prev_rkey)[2], 8);							\
+	tmp = NIBBLE_ROR_2((prev_rkey)[3]);									\
+	(next_rkey)[3] = tmp & 0x99999999;									\
+	(next_rkey)[3] |= ROR(tmp & 0x66666666, 24);						\
+	/* 3rd round key */													\
+	(next_rkey)[4] = NIBBLE_ROR_3((prev_rkey)[4]);						\
+	tmp = ROR((prev_rkey)[5], 16);										\
+	(next_rkey)[5] = NIBBLE_ROR_1(tmp) & 0x00ffff00;					\
+	(next_rkey)[5] |= tmp & 0xff0000ff;									\
+	/* 4th round key */													\
+	(next_rkey)[6] = ROR((prev_rkey)[6], 24);							\
+	tmp = NIBBLE_ROR_2((prev_rkey)[7]);									\
+	(next_rkey)[7] = tmp & 0x33333333;									\
+	(next_rkey)[7] |= ROR(tmp & 0xcccccccc, 8);							\
+})
+
+/****************************************************************************
+* Computes the 56 fixsliced rkeys of 'key'. Only made of constant expressions
+* so that it can be evaluated at compile time (see 'gift64.hpp').
+****************************************************************************/
+#define KEY_SCHEDULE(rkey, key) ({										\
+	REARRANGE_KEY(rkey, key);											\
+	for(int i = 0; i < 48; i += 8)										\
+		KEY_UPDATE((rkey) + i + 8, (rkey) + i);							\
+})
+
+#endif  // GIFT64_KEYSCHEDULE_H_
\ No newline at end of file
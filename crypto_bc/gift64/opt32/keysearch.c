@@ -0,0 +1,160 @@
+/*******************************************************************************
+* Multi-threaded exhaustive search of a GIFT-64 key over a key subspace.
+*
+* Given a known plaintext/ciphertext pair and the known bits of the key, the
+* remaining bits are enumerated by chunks of consecutive candidates, each
+* thread grabbing the next unprocessed chunk until none is left or the key is
+* found. Candidates are tried by pairs: as in 'precompute_2_rkeys', the round
+* keys of 2 keys are interleaved nibble-wise so that the 2 blocks of a
+* fixsliced state are encrypted under a different key at once.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "encrypt.h"
+#include "gift64.h"
+
+#define CACHE_LINE			64
+#define CHUNK_LOG			12		// log2 of the candidates of a chunk
+#define LANES				2		// keys tried at once
+
+extern const u32 rconst[28];
+void packing(u32* state, const u8* block0, const u8* block1);
+void unpacking(u8* block0, u8* block1, u32* state);
+
+typedef struct {
+	const gift64_keysearch* ks;
+	u32 pos[64];			// unknown bits (8*byte + bit), LSB first
+	u32 nbits;
+	u64 chunk_keys;
+	u64 nchunks;
+	// written by all threads, hence kept away from the read-only fields
+	u64 next_chunk __attribute__((aligned(CACHE_LINE)));
+	u64 tested;
+	int found;
+	u8 key[KEY_SIZE];
+} search_t;
+
+/*****************************************************************************
+* Writes to 'keys' the 'n' candidates of indexes 'first' to 'first + n - 1',
+* the i-th bit of an index being the i-th unknown bit of the key. As 'first'
+* is a multiple of LANES, the candidates only differ from the first one by
+* the bits of their index within the batch.
+*****************************************************************************/
+static void candidates(const search_t* s, u8 (*keys)[KEY_SIZE], u64 first,
+			u32 n) {
+	for(int i = 0; i < KEY_SIZE; i++)
+		keys[0][i] = s->ks->key[i] & ~s->ks->mask[i];
+	for(u32 i = 0; i < s->nbits; i++)
+		keys[0][s->pos[i] / 8] |= (u8)(((first >> i) & 1) << (s->pos[i] % 8));
+	for(u32 j = 1; j < n; j++) {
+		memcpy(keys[j], keys[0], KEY_SIZE);
+		for(u32 i = 0; (j >> i) != 0; i++)
+			keys[j][s->pos[i] / 8] |= (u8)(((j >> i) & 1) << (s->pos[i] % 8));
+	}
+}
+
+/*****************************************************************************
+* Processes chunks of candidates until none is left or the key is found.
+*****************************************************************************/
+static void search_chunks(search_t* s) {
+	u8 keys[LANES][KEY_SIZE], ctext[LANES*BLOCK_SIZE];
+	u32 state[4], rkey[56];
+	u64 chunk, first;
+	u32 n;
+	for(;;) {
+		if(__atomic_load_n(&s->found, __ATOMIC_ACQUIRE))
+			break;
+		chunk = __atomic_fetch_add(&s->next_chunk, 1, __ATOMIC_RELAXED);
+		if(chunk >= s->nchunks)
+			break;
+		first = chunk * s->chunk_keys;
+		for(u64 i = 0; i < s->chunk_keys; i += n) {
+			n = (s->chunk_keys - i < LANES) ? (u32)(s->chunk_keys - i) : LANES;
+			candidates(s, keys, first + i, n);
+			precompute_2_rkeys(rkey, keys[0], keys[n - 1]);
+			packing(state, s->ks->ptext, s->ks->ptext);
+			for(int r = 0; r < 28; r += 4)
+				QUADRUPLE_ROUND(state, rkey + r*2, rconst + r);
+			unpacking(ctext, ctext + BLOCK_SIZE, state);
+			for(u32 j = 0; j < n; j++) {
+				if(memcmp(ctext + j*BLOCK_SIZE, s->ks->ctext, BLOCK_SIZE))
+					continue;
+				// the first thread to find a key reports it
+				if(!__atomic_exchange_n(&s->found, 1, __ATOMIC_ACQ_REL))
+					memcpy(s->key, keys[j], KEY_SIZE);
+			}
+		}
+		__atomic_fetch_add(&s->tested, s->chunk_keys, __ATOMIC_RELAXED);
+	}
+	memset(rkey, 0, sizeof(rkey));
+	memset(keys, 0, sizeof(keys));
+	__asm__ __volatile__("" : : "r"(rkey), "r"(keys) : "memory");
+}
+
+static void* worker(void* arg) {
+	search_chunks((search_t*)arg);
+	return NULL;
+}
+
+/*****************************************************************************
+* Searches the key such that 'ks->ptext' encrypts to 'ks->ctext', among the
+* keys equal to 'ks->key' on the bits cleared in 'ks->mask', with 'nthreads'
+* threads (calling thread included, 0 standing for the number of online
+* processors). On success, the key is written to 'key' and 0 is returned.
+* Returns -1 if no key matches or if more than 64 bits are unknown. The
+* number of candidates tried is written to 'ntested' (if not NULL).
+*****************************************************************************/
+int gift64_key_search(const gift64_keysearch* ks, u32 nthreads, u8* key,
+			u64* ntested) {
+	search_t* s;
+	pthread_t* threads;
+	void* mem;
+	u32 nstarted = 0, log;
+	int ret;
+	if(posix_memalign(&mem, CACHE_LINE, sizeof(search_t)))
+		return -1;
+	s = mem;
+	memset(s, 0, sizeof(search_t));
+	s->ks = ks;
+	// the key is seen as a big-endian integer, its last byte holding bits 0-7
+	for(u32 i = 0; i < 8*KEY_SIZE; i++) {
+		u32 pos = 8*(KEY_SIZE - 1 - i/8) + i%8;
+		if(!((ks->mask[pos / 8] >> (pos % 8)) & 1))
+			continue;
+		if(s->nbits == 64) {
+			free(s);
+			return -1;
+		}
+		s->pos[s->nbits++] = pos;
+	}
+	log = (s->nbits < CHUNK_LOG) ? s->nbits : CHUNK_LOG;
+	s->chunk_keys = (u64)1 << log;
+	s->nchunks = (u64)1 << (s->nbits - log);
+	if(nthreads == 0) {
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = (n > 0) ? (u32)n : 1;
+	}
+	if(s->nchunks < nthreads)
+		nthreads = (u32)s->nchunks;
+	threads = calloc(nthreads, sizeof(pthread_t));
+	for(u32 i = 1; threads && i < nthreads; i++)
+		if(pthread_create(&threads[nstarted + 1], NULL, worker, s) == 0)
+			nstarted++;
+	search_chunks(s);
+	for(u32 i = 1; i <= nstarted; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+	ret = s->found ? 0 : -1;
+	if(ret == 0)
+		memcpy(key, s->key, KEY_SIZE);
+	if(ntested)
+		*ntested = s->tested;
+	memset(s, 0, sizeof(search_t));
+	__asm__ __volatile__("" : : "r"(s) : "memory");
+	free(s);
+	return ret;
+}
@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <cstring>
+#include "gift64.hpp"
+// both wrappers can be used in the same translation unit
+#include "../../gift128/opt32/gift128.hpp"
+
+static_assert(gift::gift64_block_size == 8 && gift::Gift128::block_size == 16,
+	"GIFT-64 and GIFT-128 block sizes mixed up");
+
+constexpr std::size_t block_size = gift::gift64_block_size;
+constexpr std::size_t key_size = gift::gift64_key_size;
+
+constexpr u8 key[2][key_size] = {
+	{0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,	//2nd key
+	0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10},
+	{0xbd, 0x91, 0x73, 0x1e, 0xb6, 0xbc, 0x27, 0x13,	//3rd key
+	0xa1, 0xf9, 0xf6, 0xff, 0xc7, 0x50, 0x44, 0xe7}
+};
+const u8 ptext[2][block_size] = {
+	{0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10},	//2nd plaintext
+	{0xc4, 0x50, 0xc7, 0x72, 0x7a, 0x9b, 0x8a, 0x7d}	//3rd plaintext
+};
+const u8 ctext[2][block_size] = {
+	{0xc1, 0xb7, 0x1f, 0x66, 0x16, 0x0f, 0xf5, 0x87},	//2nd ciphertext
+	{0xe3, 0x27, 0x28, 0x85, 0xfa, 0x94, 0xba, 0x8b}	//3rd ciphertext
+};
+
+// round keys computed at compile time, stored in read-only memory
+constexpr gift::Gift64Rkeys rkeys[2] = {
+	gift::gift64_rkeys(key[0]), gift::gift64_rkeys(key[1])
+};
+
+#define NBLOCKS		77		// not a multiple of any parallel batch size
+
+/*****************************************************************************
+* Checks that the compile-time round keys match the ones computed at run
+* time, and encrypt/decrypt the test vectors through the C interface.
+*****************************************************************************/
+int check_rkeys(int i) {
+	u8 input[NBLOCKS*block_size], output[NBLOCKS*block_size];
+	u8 back[NBLOCKS*block_size];
+	u32 rkey[56];
+	precompute_rkeys(rkey, key[i]);
+	if(std::memcmp(rkey, rkeys[i].data(), sizeof(rkey)) != 0)
+		return -1;
+	for(int j = 0; j < NBLOCKS; j++)
+		std::memcpy(input + j*block_size, ptext[i], block_size);
+	gift64_encrypt_ecb_rkey(output, input, sizeof(input), rkeys[i].data());
+	for(int j = 0; j < NBLOCKS; j++)
+		if(std::memcmp(output + j*block_size, ctext[i], block_size) != 0)
+			return -1;
+	gift64_decrypt_ecb_rkey(back, output, sizeof(output), rkeys[i].data());
+	if(std::memcmp(back, input, sizeof(input)) != 0)
+		return -1;
+	return 0;
+}
+
+int main() {
+	const char* name;
+	for(u32 i = 0; (name = gift64_backend_name(i)) != nullptr; i++) {
+		if(gift64_select_backend(name) != 0) {
+			std::printf("Backend '%s' not supported, skipped.\n", name);
+			continue;
+		}
+		for(int j = 0; j < 2; j++) {
+			if(check_rkeys(j) != 0) {
+				std::printf("Backend '%s' failed! :(\n", name);
+				return -1;
+			}
+		}
+	}
+	std::printf("All C++ tests have passed successfully! :)\n");
+	return 0;
+}
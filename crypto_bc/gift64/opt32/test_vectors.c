@@ -27,7 +27,188 @@ u8 ctext[3][BLOCK_SIZE*2] = {
 	0xe3, 0x27, 0x28, 0x85, 0xfa, 0x94, 0xba, 0x8b}
 };
 
-int main() {
+#define NBLOCKS		77		// not a multiple of any parallel batch size
+
+/*****************************************************************************
+* Checks that multi-block GIFT-64 ECB calls, which go through the parallel
+* kernels when available, match the block-by-block processing.
+*****************************************************************************/
+int check_multiblock(const u8* k) {
+	u8 input[NBLOCKS*BLOCK_SIZE], output[NBLOCKS*BLOCK_SIZE];
+	u8 ref[NBLOCKS*BLOCK_SIZE];
+	for(int i = 0; i < NBLOCKS*BLOCK_SIZE; i++)
+		input[i] = (u8)(i*7 + k[i % KEY_SIZE]);
+	for(int i = 0; i < NBLOCKS; i++)
+		gift64_encrypt_ecb(ref + i*BLOCK_SIZE, input + i*BLOCK_SIZE,
+			BLOCK_SIZE, k);
+	gift64_encrypt_ecb(output, input, NBLOCKS*BLOCK_SIZE, k);
+	if(memcmp(output, ref, NBLOCKS*BLOCK_SIZE) != 0)
+		return -1;
+	gift64_decrypt_ecb(output, ref, NBLOCKS*BLOCK_SIZE, k);
+	if(memcmp(output, input, NBLOCKS*BLOCK_SIZE) != 0)
+		return -1;
+	return 0;
+}
+
+/*****************************************************************************
+* Checks that the key search finds the i-th test key from its test vector
+* when 14 of its bits are unknown, and fails on a wrong ciphertext or on too
+* many unknown bits.
+*****************************************************************************/
+int check_keysearch(int i) {
+	gift64_keysearch ks;
+	u8 found[KEY_SIZE];
+	u64 ntested;
+	int ret = 0;
+	memcpy(ks.key, key[i], KEY_SIZE);
+	memset(ks.mask, 0, KEY_SIZE);
+	ks.mask[0] = 0x0f;
+	ks.mask[7] = 0x3c;
+	ks.mask[15] = 0x3f;
+	for(int j = 0; j < KEY_SIZE; j++)
+		ks.key[j] ^= ks.mask[j] & 0xa5;		// wrong unknown bits
+	memcpy(ks.ptext, ptext[i], BLOCK_SIZE);
+	memcpy(ks.ctext, ctext[i], BLOCK_SIZE);
+	ret |= gift64_key_search(&ks, 4, found, &ntested);
+	ret |= memcmp(found, key[i], KEY_SIZE);
+	ks.ctext[5] ^= 0x10;
+	ret |= (gift64_key_search(&ks, 0, found, &ntested) != -1);
+	ret |= (ntested != (1 << 14));
+	memset(ks.mask, 0xff, KEY_SIZE);
+	ret |= (gift64_key_search(&ks, 1, found, NULL) != -1);
+	return ret ? -1 : 0;
+}
+
+#define EXP_LOG_N		12
+
+static u64 splitmix64(u64 x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+/*****************************************************************************
+* Checks the differential and linear experiments against a straightforward
+* computation on the plaintexts documented in 'experiment.c'.
+*****************************************************************************/
+int check_experiment(const u8* k) {
+	static u64 hist[1 << 16], ref[1 << 16];
+	gift64_experiment exp = {5, 6, EXP_LOG_N, 0x0123456789abcdefULL,
+		{0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x01},
+		{0x81, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xf0, 0x3f}};
+	u8 p[2*BLOCK_SIZE], c[2*BLOCK_SIZE];
+	u64 count, ref_count = 0;
+	u32 rkey[56];
+	int ret = 0;
+	precompute_rkeys(rkey, k);
+	memset(ref, 0, sizeof(ref));
+	for(u64 i = 0; i < (1 << EXP_LOG_N); i++) {
+		u64 w = splitmix64(exp.seed + (i + 1)*0x9e3779b97f4a7c15ULL);
+		u32 index = 0, l = 0, parity = 0;
+		for(int j = 0; j < BLOCK_SIZE; j++) {
+			p[j] = (u8)(w >> 8*j);
+			p[BLOCK_SIZE + j] = p[j] ^ exp.in[j];
+		}
+		gift64_encrypt_rounds(c, p, 2*BLOCK_SIZE, rkey, 5, 6);
+		for(int j = 8*BLOCK_SIZE - 1; j >= 0; j--) {
+			if((exp.out[j / 8] >> (7 - j % 8)) & 1)
+				index |= (((c[j / 8] ^ c[BLOCK_SIZE + j / 8]) >>
+					(7 - j % 8)) & 1) << l++;
+			parity ^= ((p[j / 8] & exp.in[j / 8]) >> (7 - j % 8)) & 1;
+			parity ^= ((c[j / 8] & exp.out[j / 8]) >> (7 - j % 8)) & 1;
+		}
+		ref[index]++;
+		ref_count += !parity;
+	}
+	ret |= gift64_differential(rkey, &exp, 4, hist);
+	ret |= memcmp(hist, ref, sizeof(ref));
+	// the plaintexts of the linear experiment are the first of the pairs
+	ret |= gift64_linear(rkey, &exp, 3, &count);
+	ret |= (count != ref_count);
+	exp.out[3] = 0x1f;
+	ret |= (gift64_differential(rkey, &exp, 1, hist) != -1);
+	exp.out[3] = 0x00;
+	exp.nrounds = 24;
+	ret |= (gift64_linear(rkey, &exp, 1, &count) != -1);
+	return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Round 'r' of GIFT-64 as in the specification, on the bits of the state (bit
+* 63 being the MSB of the first byte), the key state 'kw' (16-bit words, kw[7]
+* being made of the first 2 key bytes) being updated once the round key added.
+*****************************************************************************/
+void classical_round(u8* bits, u32* kw, int r) {
+	const u8 sbox[16] = {1, 10, 4, 12, 6, 15, 3, 9, 2, 13, 11, 7, 5, 0, 8, 14};
+	u8 sub[64], c = 0;
+	u32 k0 = kw[0], k1 = kw[1];
+	for(int i = 0; i <= r; i++)		// 6-bit LFSR of the round constants
+		c = ((c << 1) | (((c >> 5) ^ (c >> 4) ^ 1) & 1)) & 0x3f;
+	for(int i = 0; i < 64; i += 4) {
+		u8 x = sbox[bits[i] | (bits[i+1] << 1) | (bits[i+2] << 2) |
+			(bits[i+3] << 3)];
+		for(int j = 0; j < 4; j++)
+			sub[i+j] = (x >> j) & 1;
+	}
+	for(int i = 0; i < 64; i++)
+		bits[4*(i/16) + 16*((3*((i%16)/4) + (i%4)) % 4) + (i%4)] = sub[i];
+	for(int i = 0; i < 16; i++) {
+		bits[4*i + 1] ^= (k1 >> i) & 1;
+		bits[4*i] ^= (k0 >> i) & 1;
+	}
+	for(int i = 0; i < 6; i++)
+		bits[4*i + 3] ^= (c >> i) & 1;
+	bits[63] ^= 1;
+	for(int i = 0; i < 6; i++)
+		kw[i] = kw[i+2];
+	kw[6] = ((k0 >> 12) | (k0 << 4)) & 0xffff;
+	kw[7] = ((k1 >> 2) | (k1 << 14)) & 0xffff;
+}
+
+/*****************************************************************************
+* Checks the reduced-round GIFT-64 functions against 'classical_round' for
+* every first round and number of rounds.
+*****************************************************************************/
+int check_rounds(const u8* k) {
+	static u8 states[29][NBLOCKS*BLOCK_SIZE];
+	u8 bits[64], output[NBLOCKS*BLOCK_SIZE];
+	const u32 len = NBLOCKS*BLOCK_SIZE;
+	u32 rkey[56], kw[8];
+	int ret = 0;
+	precompute_rkeys(rkey, k);
+	for(u32 i = 0; i < len; i++)
+		states[0][i] = (u8)(i*3 + k[i % KEY_SIZE]);
+	for(u32 j = 0; j < len; j += BLOCK_SIZE) {
+		for(int i = 0; i < 8; i++)
+			kw[7 - i] = (k[2*i] << 8) | k[2*i + 1];
+		for(int i = 0; i < 64; i++)
+			bits[i] = (states[0][j + 7 - i/8] >> (i%8)) & 1;
+		for(int r = 0; r < 28; r++) {
+			classical_round(bits, kw, r);
+			for(int i = 0; i < 64; i++)
+				states[r+1][j + 7 - i/8] = (u8)((states[r+1][j + 7 - i/8] &
+					~(1 << (i%8))) | (bits[i] << (i%8)));
+		}
+	}
+	gift64_encrypt_ecb(output, states[0], len, k);
+	ret |= memcmp(output, states[28], len);
+	for(u32 start = 0; start <= 28; start++) {
+		for(u32 n = 0; start + n <= 28; n++) {
+			gift64_encrypt_rounds(output, states[start], len, rkey, start, n);
+			ret |= memcmp(output, states[start + n], len);
+			gift64_decrypt_rounds(output, states[start + n], len, rkey,
+				start, n);
+			ret |= memcmp(output, states[start], len);
+		}
+	}
+	ret |= (gift64_encrypt_rounds(output, states[0], len, rkey, 26, 3) != -1);
+	return ret ? -1 : 0;
+}
+
+/*****************************************************************************
+* Runs all the tests with the backend currently selected.
+*****************************************************************************/
+int run_tests(void) {
 	u8 output[BLOCK_SIZE * 2] = {0x00};
 	for(int i = 0; i < 3; i++) {
 		gift64_encrypt_ecb(output, ptext[i], BLOCK_SIZE * 2, key[i]);
@@ -40,6 +221,38 @@ int main() {
 			printf("gift64_decrypt_ecb test vector %d failed! :(\n",i);
 			return -1;
 		}
+		if(check_multiblock(key[i]) != 0) {
+			printf("Multi-block ECB with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_rounds(key[i]) != 0) {
+			printf("Reduced-round encryption with key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_keysearch(i) != 0) {
+			printf("Key search of key %d failed! :(\n",i);
+			return -1;
+		}
+		if(check_experiment(key[i]) != 0) {
+			printf("Differential/linear experiments with key %d failed! :(\n",
+				i);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int main() {
+	const char* name;
+	for(u32 i = 0; (name = gift64_backend_name(i)) != NULL; i++) {
+		if(gift64_select_backend(name) != 0) {
+			printf("Backend '%s' not supported, skipped.\n", name);
+			continue;
+		}
+		if(run_tests() != 0) {
+			printf("Backend '%s' failed! :(\n", name);
+			return -1;
+		}
 	}
 	printf("All test vectors have passed successfully! :)\n");
 	return 0;